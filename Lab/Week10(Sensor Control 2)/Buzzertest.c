@@ -1,22 +1,23 @@
 #include <stdio.h>
 #include <wiringPi.h>
-#include <softTone.h>
+#include "../pwm_tone.h"  // 하드웨어 PWM 음 + 타이머 스레드 음 순서기 (PWM 핀이 아니면 softTone)
 
 #define BUZZER_PIN 17
 
+// 1초 울리고 1초 쉼 (타이머 스레드가 되풀이)
+static const ToneNote beep[] = { TONE_NOTE(2093, 1000), TONE_REST(1000) };
+
 int main() {
     if (wiringPiSetupGpio() == -1) {
         printf("GPIO setup failed!\n");
         return 1;
     }
 
-    softToneCreate(BUZZER_PIN);
+    toneBegin(BUZZER_PIN);
+    toneRepeat(beep, TONE_COUNT(beep)); // 2093Hz 1초, 끔 1초를 되풀이
 
     while (1) {
-        softToneWrite(BUZZER_PIN, 2093); // 2093Hz 소리 발생
-        delay(1000);                    // 1초 동안 소리
-        softToneWrite(BUZZER_PIN, 0);   // 소리 끔
-        delay(1000);                    // 1초 대기
+        delay(1000);                    // 재생은 타이머 스레드
     }
 
     return 0;
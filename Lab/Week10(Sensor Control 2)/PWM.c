@@ -1,18 +1,25 @@
 #include <stdio.h>
 #include <wiringPi.h>
-#include <lcd.h>
+#include "../lcd_shadow.h"  // 바뀐 글자만 LCD 로 보내기
+#include "../pwm_tone.h"   // 부저음은 타이머 스레드가 (분주/범위는 주파수로 계산)
 
 // 핀 정의
 #define TRIG_PIN 27       // 초음파 센서 Trig 핀
 #define ECHO_PIN 22       // 초음파 센서 Echo 핀
 #define BUZZER_PIN 18     // PWM으로 제어할 부저 핀 (GPIO 18 - PWM 핀)
 #define LCD_RS 2          // LCD RS 핀
+#ifndef LCD_RW
+#define LCD_RW -1         // LCD RW 핀 (-1: GND 에 고정. busy flag 를 읽으려면 GPIO 번호, 5V LCD 는 레벨 변환 필요)
+#endif
 #define LCD_E 4           // LCD Enable 핀
 #define LCD_D4 20         // LCD D4 핀
 #define LCD_D5 21         // LCD D5 핀
 #define LCD_D6 12         // LCD D6 핀
 #define LCD_D7 16         // LCD D7 핀
 
+// 경고음 한 번: 2093Hz 30ms (범위는 컴파일할 때 계산, 9.6MHz / 4587 = 2092.9Hz)
+static const ToneNote alertBeep[] = { TONE_NOTE(2093, 30) };
+
 // 초음파 센서로 거리 측정
 float getDistance(void) {
     long startTime, endTime;
@@ -35,17 +42,16 @@ float getDistance(void) {
 }
 
 // PWM 초기화
+// 예전에는 pwmSetClock(9) + 범위 1024 로 한 주파수만 냈다 (19.2MHz / 9 / 1024 = 2083Hz).
+// 이제는 toneBegin 이 마크-스페이스 모드와 분주를 정하고 음마다 범위를 주파수에 맞춘다.
 void initPWM(void) {
-    pinMode(BUZZER_PIN, PWM_OUTPUT); // 부저 핀을 PWM 출력으로 설정
-    pwmSetMode(PWM_MODE_MS);         // 마크-스페이스 모드 설정?
-    pwmSetRange(1024);               // PWM 범위 설정 (0~2048 중 적당한 범위 설정)
-    pwmSetClock(9);                // PWM 주파수 설정 (주파수 계산: 기본 클럭 / 설정 값) => 2093Hz 주파수 소리 출력
+    tone.duty = 80;        // 듀티 사이클 80% (예전 pwmWrite 800 / 1024 와 같은 소리)
+    toneBegin(BUZZER_PIN); // 부저 핀을 PWM 출력으로 설정 + 타이머 스레드 시작
 }
 
 // 일정 주파수 부저음 제어
 void alertBuzzer(float distance) {
     int delayTime = 0;
-    int pwmValue = 800; // 듀티 사이클 80% (0~1024 범위 중)
 
     if (distance < 30) {
         delayTime = 30;  // 30cm 이하: 소리 간격 0.03초
@@ -56,20 +62,19 @@ void alertBuzzer(float distance) {
     } else if (distance < 100) {
         delayTime = 1000; // 70~100cm: 소리 간격 1초
     } else {
-        pwmWrite(BUZZER_PIN, 0); // 100cm 이상: 소리 없음
+        toneWrite(0); // 100cm 이상: 소리 없음
         return;
     }
 
-    // PWM 신호로 부저음 발생 (2093Hz)
-    pwmWrite(BUZZER_PIN, pwmValue); // PWM 듀티 사이클 설정
-    delay(30);                      // 부저 음 지속 시간
-    pwmWrite(BUZZER_PIN, 0);        // PWM 신호 끔
-    delay(delayTime - 30);          // 간격
+    // PWM 신호로 부저음 발생 (2093Hz, 30ms 뒤 타이머 스레드가 끈다)
+    tonePlay(alertBeep, 1);
+    delay(delayTime);               // 간격 (부저음이 울리는 시간 포함)
 }
 
 // 메인 함수
 int main(void) {
     int lcdHandle;
+    LcdShadow lcd;
 
     // GPIO 초기화
     if (wiringPiSetupGpio() == -1) {
@@ -82,12 +87,12 @@ int main(void) {
     pinMode(ECHO_PIN, INPUT);
 
     // LCD 초기화
-    lcdHandle = lcdInit(2, 16, 4, LCD_RS, LCD_E, LCD_D4, LCD_D5, LCD_D6, LCD_D7, 0, 0, 0, 0);
+    lcdHandle = hdInit(2, 16, LCD_RS, LCD_RW, LCD_E, LCD_D4, LCD_D5, LCD_D6, LCD_D7);
     if (lcdHandle == -1) {
         printf("LCD initialization failed!\n");
         return 1;
     }
-    lcdClear(lcdHandle);
+    lcdShadowInit(&lcd, lcdHandle, 2, 16);
 
     // PWM 초기화
     initPWM();
@@ -95,10 +100,11 @@ int main(void) {
     while (1) {
         float distance = getDistance(); // 거리 측정
 
-        // 거리 출력 (LCD)
-        lcdClear(lcdHandle);
-        lcdPosition(lcdHandle, 0, 0);
-        lcdPrintf(lcdHandle, "Distance: %.2fcm", distance);
+        // 거리 출력 (LCD, 바뀐 글자만)
+        lcdShadowClear(&lcd);
+        lcdShadowPosition(&lcd, 0, 0);
+        lcdShadowPrintf(&lcd, "Distance: %.2fcm", distance);
+        lcdShadowFlush(&lcd);
 
         // 경고음 제어
         alertBuzzer(distance);
@@ -1,13 +1,16 @@
 #include <stdio.h>
 #include <wiringPi.h>
-#include <lcd.h>
 #include <softTone.h>
+#include "../lcd_shadow.h"  // 바뀐 글자만 LCD 로 보내기
 
 // 핀 정의
 #define TRIG_PIN 27       // 초음파 센서 Trig 핀
 #define ECHO_PIN 22       // 초음파 센서 Echo 핀
 #define BUZZER_PIN 17     // 부저 핀
 #define LCD_RS 2          // LCD RS 핀
+#ifndef LCD_RW
+#define LCD_RW -1         // LCD RW 핀 (-1: GND 에 고정. busy flag 를 읽으려면 GPIO 번호, 5V LCD 는 레벨 변환 필요)
+#endif
 #define LCD_E 4           // LCD Enable 핀
 #define LCD_D4 20         // LCD D4 핀
 #define LCD_D5 21         // LCD D5 핀
@@ -67,6 +70,7 @@ void alertBuzzer(float distance) {
 // 메인 함수
 int main(void) {
     int lcdHandle;
+    LcdShadow lcd;
 
     // GPIO 초기화
     if (wiringPiSetupGpio() == -1) {
@@ -79,12 +83,12 @@ int main(void) {
     pinMode(ECHO_PIN, INPUT);
 
     // LCD 초기화
-    lcdHandle = lcdInit(2, 16, 4, LCD_RS, LCD_E, LCD_D4, LCD_D5, LCD_D6, LCD_D7, 0, 0, 0, 0);
+    lcdHandle = hdInit(2, 16, LCD_RS, LCD_RW, LCD_E, LCD_D4, LCD_D5, LCD_D6, LCD_D7);
     if (lcdHandle == -1) {
         printf("LCD initialization failed!\n");
         return 1;
     }
-    lcdClear(lcdHandle);
+    lcdShadowInit(&lcd, lcdHandle, 2, 16);
 
     // 부저 초기화
     initBuzzer();
@@ -92,10 +96,11 @@ int main(void) {
     while (1) {
         float distance = getDistance(); // 거리 측정
 
-        // 거리 출력 (LCD)
-        lcdClear(lcdHandle);
-        lcdPosition(lcdHandle, 0, 0);
-        lcdPrintf(lcdHandle, "Distance: %.2fcm", distance);
+        // 거리 출력 (LCD, 바뀐 글자만)
+        lcdShadowClear(&lcd);
+        lcdShadowPosition(&lcd, 0, 0);
+        lcdShadowPrintf(&lcd, "Distance: %.2fcm", distance);
+        lcdShadowFlush(&lcd);
 
         // 경고음 제어
         alertBuzzer(distance);
@@ -1,13 +1,16 @@
 #include <stdio.h>      
 #include <wiringPi.h>   
-#include <lcd.h>        
 #include <softTone.h>    
+#include "../lcd_shadow.h"  // 바뀐 글자만 LCD 로 보내기
 
 // 핀 정의
 #define TRIG_PIN 27       // 초음파 센서의 Trig 핀 번호
 #define ECHO_PIN 22       // 초음파 센서의 Echo 핀 번호
 #define BUZZER_PIN 17     // 부저 핀 번호
 #define LCD_RS 2          // LCD RS 핀 번호
+#ifndef LCD_RW
+#define LCD_RW -1         // LCD RW 핀 (-1: GND 에 고정. busy flag 를 읽으려면 GPIO 번호, 5V LCD 는 레벨 변환 필요)
+#endif
 #define LCD_E 4           // LCD Enable 핀 번호
 #define LCD_D4 20         // LCD 데이터 핀 D4
 #define LCD_D5 21         // LCD 데이터 핀 D5
@@ -75,6 +78,7 @@ void alertBuzzer(float distance) {
 // 메인 함수
 int main(void) {
     int lcdHandle; // LCD 핸들 (LCD를 제어하기 위한 변수)
+    LcdShadow lcd; // LCD 에 보이는 화면 (바뀐 글자만 보내기 위해)
 
     // GPIO 초기화
     if (wiringPiSetupGpio() == -1) {
@@ -87,12 +91,12 @@ int main(void) {
     pinMode(ECHO_PIN, INPUT);  // Echo 핀을 입력 모드로 설정
 
     // LCD 초기화
-    lcdHandle = lcdInit(2, 16, 4, LCD_RS, LCD_E, LCD_D4, LCD_D5, LCD_D6, LCD_D7, 0, 0, 0, 0);
+    lcdHandle = hdInit(2, 16, LCD_RS, LCD_RW, LCD_E, LCD_D4, LCD_D5, LCD_D6, LCD_D7);
     if (lcdHandle == -1) {
         printf("LCD initialization failed!\n");
         return 1; // LCD 초기화 실패 시 프로그램 종료
     }
-    lcdClear(lcdHandle); // LCD 화면 초기화
+    lcdShadowInit(&lcd, lcdHandle, 2, 16); // LCD 화면 초기화
 
     // 부저 초기화
     initBuzzer();
@@ -102,11 +106,12 @@ int main(void) {
         float distance = getDistance(); // 초음파 센서를 통해 거리 측정
 
         // 측정된 거리 값을 LCD에 출력
-        lcdClear(lcdHandle);
-        lcdPosition(lcdHandle, 0, 0); // LCD의 첫 번째 줄, 첫 번째 칸
-        lcdPrintf(lcdHandle, "Distance: ", distance); // 거리 출력
-        lcdPosition(lcdHandle, 0, 1); // LCD의 첫 번째 줄, 첫 번째 칸
-        lcdPrintf(lcdHandle, "%.2fcm", distance); // 거리 출력
+        lcdShadowClear(&lcd);
+        lcdShadowPosition(&lcd, 0, 0); // LCD의 첫 번째 줄, 첫 번째 칸
+        lcdShadowPuts(&lcd, "Distance: "); // 거리 출력
+        lcdShadowPosition(&lcd, 0, 1); // LCD의 첫 번째 줄, 첫 번째 칸
+        lcdShadowPrintf(&lcd, "%.2fcm", distance); // 거리 출력
+        lcdShadowFlush(&lcd); // 바뀐 글자만 LCD 로 보냄
 
         // 부저를 사용한 경고음 발생
         alertBuzzer(distance);
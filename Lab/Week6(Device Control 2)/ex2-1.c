@@ -3,6 +3,7 @@
 #include <softTone.h>
 #include <softPwm.h>
 #include <string.h>  // 문자열 관련 함수 사용을 위한 헤더 파일
+#include "../gpio_bulk.h"  // 버튼 전체를 한 번에 읽기
 
 // 핀 정의
 #define BUZZER_PIN 17
@@ -37,8 +38,11 @@ int inputIndex = 0;  // 입력된 자리
 int isPasswordSet = 0;  // 비밀번호가 설정되었는지 여부
 int attempts = 0;  // 시도 횟수
 
-// 디바운싱에 사용할 이전 상태 변수
-int lastButtonState = HIGH;
+// 키패드 버튼 (readKeypad 에서 확인하는 순서)
+const int keypadPins[] = { BUTTON1_PIN, BUTTON2_PIN, BUTTON3_PIN, BUTTON4_PIN, BUTTON5_PIN, BUTTON6_PIN,
+                           BUTTON7_PIN, BUTTON8_PIN, BUTTON9_PIN, BUTTON0_PIN, BUTTON_STAR_PIN, BUTTON_HASH_PIN };
+const char keypadKeys[] = "1234567890*#";
+GpioKeys keypad;  // 디바운스 상태 (버튼별 카운터, 확정된 눌림)
 
 // 부저 및 서보 모터 제어 함수
 void Change_FREQ(unsigned int freq) {
@@ -79,49 +83,10 @@ void PlayCheerfulSound(void) {
 }
 
 // 키패드 입력 처리 함수 (디바운싱 적용)
+// 버튼 전체를 GPIO 레벨 레지스터 한 번 읽기로 샘플링하고 비트마스크 단위로 디바운스한다.
+// 떼었다가 다시 눌렀을 때만 값을 반환한다 (누르고 있는 동안은 '\0')
 char readKeypad() {
-    int buttonState = HIGH;
-
-    // 각 버튼에 해당하는 GPIO 핀 상태를 읽고, 눌린 버튼의 값을 반환
-    if (digitalRead(BUTTON1_PIN) == LOW) buttonState = LOW;
-    if (digitalRead(BUTTON2_PIN) == LOW) buttonState = LOW;
-    if (digitalRead(BUTTON3_PIN) == LOW) buttonState = LOW;
-    if (digitalRead(BUTTON4_PIN) == LOW) buttonState = LOW;
-    if (digitalRead(BUTTON5_PIN) == LOW) buttonState = LOW;
-    if (digitalRead(BUTTON6_PIN) == LOW) buttonState = LOW;
-    if (digitalRead(BUTTON7_PIN) == LOW) buttonState = LOW;
-    if (digitalRead(BUTTON8_PIN) == LOW) buttonState = LOW;
-    if (digitalRead(BUTTON9_PIN) == LOW) buttonState = LOW;
-    if (digitalRead(BUTTON0_PIN) == LOW) buttonState = LOW;
-    if (digitalRead(BUTTON_STAR_PIN) == LOW) buttonState = LOW;
-    if (digitalRead(BUTTON_HASH_PIN) == LOW) buttonState = LOW;
-
-    // 버튼이 눌리고 나서 떼어졌을 때만 값을 반환 (디바운싱 처리)
-    if (buttonState == LOW && lastButtonState == HIGH) {
-        delay(200);  // 디바운싱을 위한 지연
-        lastButtonState = LOW;
-
-        // 눌린 버튼에 따른 값 반환
-        if (digitalRead(BUTTON1_PIN) == LOW) return '1';
-        if (digitalRead(BUTTON2_PIN) == LOW) return '2';
-        if (digitalRead(BUTTON3_PIN) == LOW) return '3';
-        if (digitalRead(BUTTON4_PIN) == LOW) return '4';
-        if (digitalRead(BUTTON5_PIN) == LOW) return '5';
-        if (digitalRead(BUTTON6_PIN) == LOW) return '6';
-        if (digitalRead(BUTTON7_PIN) == LOW) return '7';
-        if (digitalRead(BUTTON8_PIN) == LOW) return '8';
-        if (digitalRead(BUTTON9_PIN) == LOW) return '9';
-        if (digitalRead(BUTTON0_PIN) == LOW) return '0';
-        if (digitalRead(BUTTON_STAR_PIN) == LOW) return '*';
-        if (digitalRead(BUTTON_HASH_PIN) == LOW) return '#';
-    }
-    
-    // 버튼이 떼어진 상태일 때
-    if (buttonState == HIGH && lastButtonState == LOW) {
-        lastButtonState = HIGH;  // 다시 버튼을 눌렀을 때만 작동하게 함
-    }
-
-    return '\0';  // 아무 버튼도 눌리지 않았을 때 null 반환
+    return gpioKeysRead(&keypad);
 }
 
 int main(void) {
@@ -154,6 +119,7 @@ int main(void) {
     pullUpDnControl(BUTTON0_PIN, PUD_UP);
     pullUpDnControl(BUTTON_STAR_PIN, PUD_UP);
     pullUpDnControl(BUTTON_HASH_PIN, PUD_UP);
+    gpioKeysInit(&keypad, keypadPins, keypadKeys, 12);
 
     Buzzer_Init();  // 부저 초기화
     Servo_Init();   // 서보 모터 초기화
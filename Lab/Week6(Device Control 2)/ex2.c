@@ -1,8 +1,9 @@
 #include <stdio.h>
 #include <wiringPi.h>
-#include <softTone.h>
+#include "../pwm_tone.h"  // 음은 타이머 스레드가 (PWM 핀이 아니면 softTone)
 #include <softPwm.h>
 #include <string.h>  // 문자열 관련 함수 사용을 위한 헤더 파일
+#include "../gpio_bulk.h"  // 버튼 전체를 한 번에 읽기
 
 // 핀 정의
 #define BUZZER_PIN 17
@@ -30,6 +31,13 @@
 #define SI 987
 #define DO_H 1046
 
+// 경쾌한 소리 (각 음 200ms), 경고음. PWM 범위까지 컴파일할 때 계산된다
+static const ToneNote cheerfulMelody[] = {
+    TONE_NOTE(DO_H, 200), TONE_NOTE(SOL, 200), TONE_NOTE(MI, 200), TONE_NOTE(SOL, 200), TONE_NOTE(DO_H, 200)
+};
+static const ToneNote wrongTone[] = { TONE_NOTE(1000, 1000) };
+static const ToneNote lockTone[] = { TONE_NOTE(1000, 1000), TONE_NOTE(500, 10000) };  // 경고음 1초 뒤 잠금 10초
+
 // 비밀번호 변수
 char password[4];  // 설정된 비밀번호 저장
 char inputPassword[4];  // 입력된 비밀번호 저장
@@ -38,17 +46,19 @@ int isPasswordSet = 0;  // 비밀번호가 설정되었는지 여부
 int attempts = 0;  // 시도 횟수
 int isSettingPassword = 0; // 비밀번호 설정 모드인지 확인
 
-// 부저 및 서보 모터 제어 함수
-void Change_FREQ(unsigned int freq) {
-    softToneWrite(BUZZER_PIN, freq);  // 부저 주파수 변경
-}
+// 키패드 버튼 (readKeypad 에서 확인하는 순서)
+const int keypadPins[] = { BUTTON1_PIN, BUTTON2_PIN, BUTTON3_PIN, BUTTON4_PIN, BUTTON5_PIN, BUTTON6_PIN,
+                           BUTTON7_PIN, BUTTON8_PIN, BUTTON9_PIN, BUTTON0_PIN, BUTTON_STAR_PIN, BUTTON_HASH_PIN };
+const char keypadKeys[] = "1234567890*#";
+GpioKeys keypad;
 
+// 부저 및 서보 모터 제어 함수
 void STOP_FREQ(void) {
-    softToneWrite(BUZZER_PIN, 0);  // 부저 멈춤
+    toneWrite(0);  // 부저 멈춤
 }
 
 void Buzzer_Init(void) {
-    softToneCreate(BUZZER_PIN);  // 부저 초기화
+    toneBegin(BUZZER_PIN);  // 부저 초기화 + 타이머 스레드 시작
     STOP_FREQ();
 }
 
@@ -62,49 +72,15 @@ void Servo_Open(void) {
     softPwmWrite(SERVO_PIN, 15);   // 서보 모터 원래 상태로 복귀
 }
 
-// 경쾌한 소리 재생 함수
+// 경쾌한 소리 재생 함수 (타이머 스레드에 넘기고 바로 돌아온다. 문이 열리는 동안 울린다)
 void PlayCheerfulSound(void) {
-    // 경쾌한 소리 주파수 배열
-    int melody[] = {DO_H, SOL, MI, SOL, DO_H};
-    int length = sizeof(melody) / sizeof(melody[0]);
-
-    for (int i = 0; i < length; i++) {
-        Change_FREQ(melody[i]);  // 각각의 음 재생
-        delay(200);  // 각 음을 200ms 동안 재생
-    }
-
-    STOP_FREQ();  // 소리 멈춤
-}
-
-// 디바운스 함수: 버튼이 한번만 눌렸는지 확인
-int debounce(int pin) {
-    if (digitalRead(pin) == LOW) {  // 버튼이 눌린 상태 확인
-        delay(50);  // 50ms 대기하여 안정화 확인
-        if (digitalRead(pin) == LOW) {  // 여전히 눌려있다면
-            while (digitalRead(pin) == LOW);  // 버튼이 눌린 상태가 끝날 때까지 대기
-            return 1;  // 유효한 입력
-        }
-    }
-    return 0;  // 유효하지 않은 입력
+    tonePlay(cheerfulMelody, TONE_COUNT(cheerfulMelody));
 }
 
 // 디바운스를 적용한 키패드 입력 처리 함수
+// 12개 버튼을 GPIO 레벨 레지스터 한 번 읽기로 같은 순간에 샘플링하고, 전체 비트마스크를 한 번에 디바운스한다
 char readKeypad() {
-    // 각 버튼을 디바운스로 확인
-    if (debounce(BUTTON1_PIN)) return '1';
-    if (debounce(BUTTON2_PIN)) return '2';
-    if (debounce(BUTTON3_PIN)) return '3';
-    if (debounce(BUTTON4_PIN)) return '4';
-    if (debounce(BUTTON5_PIN)) return '5';
-    if (debounce(BUTTON6_PIN)) return '6';
-    if (debounce(BUTTON7_PIN)) return '7';
-    if (debounce(BUTTON8_PIN)) return '8';
-    if (debounce(BUTTON9_PIN)) return '9';
-    if (debounce(BUTTON0_PIN)) return '0';
-    if (debounce(BUTTON_STAR_PIN)) return '*';
-    if (debounce(BUTTON_HASH_PIN)) return '#';
-
-    return '\0';  // 아무 버튼도 눌리지 않았을 때 null 반환
+    return gpioKeysRead(&keypad);  // 새로 눌린 버튼 (없으면 '\0')
 }
 
 // 비밀번호 설정 함수
@@ -130,16 +106,15 @@ void checkPassword() {
     } else {
         attempts++;
         printf("비밀번호가 틀렸습니다.\n");
-        Change_FREQ(1000);  // 경고음 발생
-        delay(1000);
-        STOP_FREQ();
 
         if (attempts >= 3) {  // 3회 틀렸을 경우 잠금 기능
             printf("비밀번호 3회 오류. 10초 동안 잠금.\n");
-            Change_FREQ(500);  // 경고음
-            delay(10000);  // 10초 잠금
-            STOP_FREQ();
+            // tonePlay 는 울리던 음을 끊으므로 경고음과 잠금음을 한 표로 넘긴다
+            tonePlay(lockTone, TONE_COUNT(lockTone));
+            delay(11000);  // 경고음 1초 + 10초 잠금
             attempts = 0;  // 시도 횟수 초기화
+        } else {
+            tonePlay(wrongTone, 1);  // 경고음 1초 (기다리지 않고 다음 입력을 받는다)
         }
     }
     memset(inputPassword, 0, sizeof(inputPassword));  // 입력된 비밀번호 배열을 초기화
@@ -177,6 +152,7 @@ int main(void) {
     pullUpDnControl(BUTTON0_PIN, PUD_UP);
     pullUpDnControl(BUTTON_STAR_PIN, PUD_UP);
     pullUpDnControl(BUTTON_HASH_PIN, PUD_UP);
+    gpioKeysInit(&keypad, keypadPins, keypadKeys, 12);
 
     Buzzer_Init();  // 부저 초기화
     Servo_Init();   // 서보 모터 초기화
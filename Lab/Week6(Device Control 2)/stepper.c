@@ -1,70 +1,59 @@
-#include <stdio.h> 
-#include <wiringPi.h> 
+#include <stdio.h>
+#include <wiringPi.h>
+#include "../stepper_motion.h"  // 타이머 스레드 스텝 구동 (가속 표, 절대 시각, 네 핀 한꺼번에)
 
 #define PINA 20
-#define PINB 21 
-#define PINC 19 
-#define PIND 26 
+#define PINB 21
+#define PINC 19
+#define PIND 26
 
-void setsteps(int w1, int w2, int w3, int w4) 
+#define HALF_STEP 1      // 1: 반 스텝 (8상), 0: 온 스텝 (예전 setsteps 4상)
+#define REV_STEPS 4096   // 한 바퀴 (반 스텝 기준, 예전 forward(5, 512) 의 512 x 4상 = 온 스텝 2048)
+#define MAX_SPS   1000   // 최고 속도 (스텝/초, 예전 5ms 간격은 200)
+#define ACCEL     2000   // 가속도 (스텝/초^2)
+
+// 이동 한 번의 스텝 간격 오차 출력
+void report(const char* name, unsigned long steps, unsigned long late, uint64_t maxNs, uint64_t sumNs)
 {
-    digitalWrite(PINA,w1); 
-    digitalWrite(PINB,w2); 
-    digitalWrite(PINC,w3); 
-    digitalWrite(PIND,w4); 
+    printf("%s: %lu 스텝, 늦음 최대 %.1fus 평균 %.2fus, 다시 맞춤 %lu회\n", name, steps,
+           maxNs / 1e3, steps ? sumNs / 1e3 / steps : 0.0, late);
 }
 
-
-
-
-void forward(int del,int steps)
+// steps 만큼 움직이고 끝날 때까지 기다린다 (음수: 반대 방향)
+void move(const char* name, int steps)
 {
-    int i;
-        for(i=0; i<steps; i++)
-        {
-            setsteps(1,1,0,0); 
-            delay(del); 
-            setsteps(0,1,1,0); 
-            delay(del); 
-            setsteps(0,0,1,1); 
-            delay(del); 
-            setsteps(1,0,0,1); 
-            delay(del); 
-        }
+    unsigned long n = stepper.steps, late = stepper.late;
+    uint64_t sum = stepper.lateSumNs;
+    stepper.lateMaxNs = 0;
+    stepperMove(steps);   // 바로 돌아온다
+    stepperWait();
+    report(name, stepper.steps - n, stepper.late - late, stepper.lateMaxNs, stepper.lateSumNs - sum);
 }
 
-void backward (int del, int steps)
+void forward(int steps)
 {
-    int k;
-        for(k=0; k<steps; k++)
-        {
-            setsteps(1,0,0,1);
-            delay(del);
-            setsteps(0,0,1,1);
-            delay(del);
-            setsteps(0,1,1,0);
-            delay(del);
-            setsteps(1,1,0,0);
-            delay(del);
+    move("정방향", steps);
+}
 
-        }
+void backward(int steps)
+{
+    move("역방향", -steps);
 }
 
 int main(void)
 {
+    static const int pins[4] = { PINA, PINB, PINC, PIND };
+
     if (wiringPiSetupGpio() == -1) return 1;
-    pinMode(PINA, OUTPUT);
-    pinMode(PINB, OUTPUT);
-    pinMode(PINC, OUTPUT);
-    pinMode(PIND, OUTPUT);
+    if (stepperBegin(pins, HALF_STEP, MAX_SPS, ACCEL) != 0) return 1;
 
     for(;;)
     {
-        forward(5, 512);
+        forward(REV_STEPS);
         delay(1000);
-        backward(5, 512);
+        backward(REV_STEPS);
         delay(1000);
     }
 
     return 0;
-}
\ No newline at end of file
+}
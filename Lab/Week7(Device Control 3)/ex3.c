@@ -1,13 +1,18 @@
 #include <stdio.h>
 #include <wiringPi.h>
-#include <softTone.h>
+#include "../pwm_tone.h"  // 음은 타이머 스레드가 (PWM 핀이 아니면 softTone)
 #include <softPwm.h>
 #include <string.h>
-#include <lcd.h>  // LCD 제어를 위한 헤더파일
+#include "../gpio_bulk.h"  // 버튼 전체를 한 번에 읽기
+#include "../lcd_shadow.h"  // LCD 드라이버 (hd44780.h) 로 바뀐 글자만 보내기
+#include "../hangul_lcd.h"  // 한글 음절을 CGRAM 사용자 문자로
 
 // 핀 정의
 #define BUZZER_PIN 17         // 부저 핀
 #define SERVO_PIN 18          // 서보 모터 핀
+#ifndef LCD_RW_PIN
+#define LCD_RW_PIN -1         // LCD RW 핀 (-1: GND 에 고정. busy flag 를 읽으려면 GPIO 번호, 5V LCD 는 레벨 변환 필요)
+#endif
 
 #define BUTTON1_PIN 27        // 키패드 버튼 핀 1
 #define BUTTON2_PIN 22        // 키패드 버튼 핀 2
@@ -39,6 +44,27 @@
 #define LA_SHARP 466
 #define SCROLL_TONE 494
 
+// 키마다 고유의 음 (100ms). 키 문자로 바로 찾고 PWM 범위까지 컴파일할 때 계산된다
+static const ToneNote keyTones[128] = {
+    ['0'] = TONE_NOTE(DO_L, 100),
+    ['1'] = TONE_NOTE(RE, 100),
+    ['2'] = TONE_NOTE(MI, 100),
+    ['3'] = TONE_NOTE(FA, 100),
+    ['4'] = TONE_NOTE(SOL, 100),
+    ['5'] = TONE_NOTE(LA, 100),
+    ['6'] = TONE_NOTE(SI, 100),
+    ['7'] = TONE_NOTE(DO_H, 100),
+    ['8'] = TONE_NOTE(HIGH_RE, 100),
+    ['9'] = TONE_NOTE(HIGH_MI, 100),
+    ['E'] = TONE_NOTE(LA_SHARP, 100),
+    ['D'] = TONE_NOTE(SCROLL_TONE, 100),
+};
+static const ToneNote successMelody[] = {
+    TONE_NOTE(DO_H, 200), TONE_NOTE(SOL, 200), TONE_NOTE(MI, 200), TONE_NOTE(SOL, 200), TONE_NOTE(DO_H, 200)
+};
+static const ToneNote wrongTone[] = { TONE_NOTE(1000, 1000) };
+static const ToneNote lockTone[] = { TONE_NOTE(500, 10000) };
+
 // 메뉴 상수
 enum MenuOption { INPUT_PW, SET_PW, CHANGE_PW, SOUND_ON_OFF };
 int currentMenu = 0;  // 현재 메뉴 화면 (0: 첫 번째 메뉴)
@@ -53,18 +79,27 @@ int attempts = 0;  // 시도 횟수 (1번 메뉴에서만 사용)
 
 // LCD 핸들러
 int lcdHandle;
+LcdShadow lcd;  // LCD 에 그릴 화면. hangulLcdFlush 에서 바뀐 글자만 보낸다
+HangulLcd hangul;  // 한글 글꼴이 올라간 CGRAM 슬롯 8개
+
+// 키패드 버튼 (readKeypad 에서 확인하는 순서)
+const int keypadPins[] = { BUTTON1_PIN, BUTTON2_PIN, BUTTON3_PIN, BUTTON4_PIN, BUTTON5_PIN, BUTTON6_PIN,
+                           BUTTON7_PIN, BUTTON8_PIN, BUTTON9_PIN, BUTTON0_PIN, BUTTON_ENTER_PIN, BUTTON_DOWN_PIN };
+const char keypadKeys[] = "1234567890ED";
+GpioKeys keypad;
 
 // 부저 및 서보 모터 제어 함수
-void Change_FREQ(unsigned int freq) {
-    if (soundOn) softToneWrite(BUZZER_PIN, freq);  // 부저 주파수 변경
+// 음 표를 타이머 스레드에 넘기고 바로 돌아온다 (재생 중이던 음은 끊긴다)
+void playNotes(const ToneNote* notes, int count) {
+    if (soundOn) tonePlay(notes, count);
 }
 
 void STOP_FREQ(void) {
-    softToneWrite(BUZZER_PIN, 0);  // 부저 멈춤
+    toneWrite(0);  // 부저 멈춤
 }
 
 void Buzzer_Init(void) {
-    softToneCreate(BUZZER_PIN);  // 부저 초기화
+    toneBegin(BUZZER_PIN);  // 부저 초기화 + 타이머 스레드 시작
     STOP_FREQ();
 }
 
@@ -78,93 +113,48 @@ void Servo_Open(void) {
     softPwmWrite(SERVO_PIN, 15);   // 서보 모터 원래 상태로 복귀
 }
 
-// 경쾌한 소리 재생 함수(도어락 열릴 때)
+// 경쾌한 소리 재생 함수(도어락 열릴 때, 문이 열리는 동안 울린다)
 void PlaySuccessfulSound(void) {
-    int melody[] = { DO_H, SOL, MI, SOL, DO_H };
-    int length = sizeof(melody) / sizeof(melody[0]);
-
-    for (int i = 0; i < length; i++) {
-        Change_FREQ(melody[i]);  // 각각의 음 재생
-        delay(200);
-    }
-    STOP_FREQ();
-}
-
-// 디바운스 함수 -> 누름 유지시 계속된 입력 방지를 위해
-int debounce(int pin) {
-    if (digitalRead(pin) == LOW) {
-        delay(50);
-        if (digitalRead(pin) == LOW) {
-            while (digitalRead(pin) == LOW);
-            return 1;
-        }
-    }
-    return 0;
+    playNotes(successMelody, TONE_COUNT(successMelody));
 }
 
 // readKeypad 함수: 키패드 입력을 읽어오는 함수
+// 버튼 12개를 GPIO 레벨 레지스터 한 번 읽기로 샘플링하고 전체 비트마스크를 한 번에 디바운스한다.
+// 새로 눌린 버튼만 반환 -> 누름 유지시 계속된 입력 방지
 char readKeypad() {
-    if (debounce(BUTTON1_PIN)) return '1';
-    if (debounce(BUTTON2_PIN)) return '2';
-    if (debounce(BUTTON3_PIN)) return '3';
-    if (debounce(BUTTON4_PIN)) return '4';
-    if (debounce(BUTTON5_PIN)) return '5';
-    if (debounce(BUTTON6_PIN)) return '6';
-    if (debounce(BUTTON7_PIN)) return '7';
-    if (debounce(BUTTON8_PIN)) return '8';
-    if (debounce(BUTTON9_PIN)) return '9';
-    if (debounce(BUTTON0_PIN)) return '0';
-    if (debounce(BUTTON_ENTER_PIN)) return 'E';
-    if (debounce(BUTTON_DOWN_PIN)) return 'D';
-    return '\0';  // 아무 버튼도 눌리지 않았을 때
+    hangulLcdFlush(&hangul);  // 입력을 기다리기 전에 화면 반영 (바뀐 것이 없으면 그냥 돌아온다)
+    return gpioKeysRead(&keypad);  // 아무 버튼도 눌리지 않았을 때 '\0'
 }
 
-// 음 재생 함수
+// 음 재생 함수 (키에 음이 없으면 재생하지 않음)
 void playSoundForKey(char key) {
-    int frequency = 0;
-    switch (key) {
-    case '0': frequency = DO_L; break;
-    case '1': frequency = RE; break;
-    case '2': frequency = MI; break;
-    case '3': frequency = FA; break;
-    case '4': frequency = SOL; break;
-    case '5': frequency = LA; break;
-    case '6': frequency = SI; break;
-    case '7': frequency = DO_H; break;
-    case '8': frequency = HIGH_RE; break;
-    case '9': frequency = HIGH_MI; break;
-    case 'E': frequency = LA_SHARP; break;
-    case 'D': frequency = SCROLL_TONE; break;
-    default: return;  // 매칭되지 않으면 재생하지 않음
-    }
-    if (frequency > 0) {
-        Change_FREQ(frequency);
-        delay(100);  // 음 재생 시간
-        STOP_FREQ();
-    }
+    const ToneNote* note = &keyTones[(unsigned char)key & 127];
+    if (note->hz > 0) playNotes(note, 1);
 }
 
 // LCD 메뉴 표시 함수 (12, 23, 34 메뉴 출력 스크롤)
+// 한 화면에 서로 다른 음절은 8개까지 (hangul_lcd.h). 메뉴를 넘길 때는 "비밀번호" 가 남아 있어 새 음절만 올린다.
 void displayMenu() {
-    lcdClear(lcdHandle);
-    lcdPosition(lcdHandle, 0, 0);
+    lcdShadowClear(&lcd);
+    lcdShadowPosition(&lcd, 0, 0);
     switch (currentMenu) {
     case 0:
-        lcdPuts(lcdHandle, "1. Input PW");
-        lcdPosition(lcdHandle, 0, 1);
-        lcdPuts(lcdHandle, "2. Set PW      d");
+        hangulLcdPuts(&hangul, "1. 비밀번호 입력");
+        lcdShadowPosition(&lcd, 0, 1);
+        hangulLcdPuts(&hangul, "2. 비밀번호 설정     d");
         break;
     case 1:
-        lcdPuts(lcdHandle, "2. Set PW");
-        lcdPosition(lcdHandle, 0, 1);
-        lcdPuts(lcdHandle, "3. Change PW   d");
+        hangulLcdPuts(&hangul, "2. 비밀번호 설정");
+        lcdShadowPosition(&lcd, 0, 1);
+        hangulLcdPuts(&hangul, "3. 비밀번호 변경     d");
         break;
     case 2:
-        lcdPuts(lcdHandle, "3. Change PW");
-        lcdPosition(lcdHandle, 0, 1);
-        lcdPuts(lcdHandle, "4. Sound on/off ");
+        hangulLcdPuts(&hangul, "3. 비밀번호 변경");
+        lcdShadowPosition(&lcd, 0, 1);
+        hangulLcdPuts(&hangul, "4. 소리 on/off");
         break;
     }
+    hangulLcdFlush(&hangul);  // 새 음절 글꼴을 올리고 두 메뉴 화면에서 다른 글자만 LCD 로 보냄
 }
 
 // 메뉴 스크롤 함수
@@ -208,14 +198,12 @@ void processPasswordInput(char key, int offset) {
         inputPassword[inputIndex++] = key;
 
         // LCD에 "*" 표시
-        lcdPosition(lcdHandle, offset + inputIndex - 1, 1);  //초기화된 핸들, 열, 행
+        lcdShadowPosition(&lcd, offset + inputIndex - 1, 1);  //초기화된 핸들, 열, 행
         // 입력 위치를 offset으로 조정  As is가 지워지는 문제를 해결하기 위해 As is: **** 정상적인 출력을 위해
-        lcdPutchar(lcdHandle, '*');   
+        lcdShadowPutchar(&lcd, '*');   
+        hangulLcdFlush(&hangul);
 
-        playSoundForKey(key);  // 각 키의 고유 음 재생
-
-        delay(100);  // 음 재생 시간
-        STOP_FREQ();
+        playSoundForKey(key);  // 각 키의 고유 음 재생 (100ms 뒤 타이머 스레드가 끈다)
     }
 }
 
@@ -226,8 +214,9 @@ void setPassword() {
             password[i] = inputPassword[i];
         }
         isPasswordSet = 1;
-        lcdClear(lcdHandle);
-        lcdPuts(lcdHandle, "Password Set!");
+        lcdShadowClear(&lcd);
+        hangulLcdPuts(&hangul, "비밀번호 설정됨");
+        hangulLcdFlush(&hangul);
         delay(1000);
         displayMenu();
         inputIndex = 0;
@@ -244,19 +233,19 @@ int checkPassword(int limitAttempts) {
         if (limitAttempts) 
             attempts++;
         
-        lcdClear(lcdHandle);
-        lcdPuts(lcdHandle, "Invalid password");
-        Change_FREQ(1000);
+        lcdShadowClear(&lcd);
+        hangulLcdPuts(&hangul, "잘못된 비밀번호");
+        hangulLcdFlush(&hangul);
+        playNotes(wrongTone, 1);
         delay(1000);
-        STOP_FREQ();
 
         // 3회 틀렸을 경우
         if (limitAttempts && attempts >= 3) {
-            lcdClear(lcdHandle);
-            lcdPuts(lcdHandle, "Locked 10 sec");
-            Change_FREQ(500);
+            lcdShadowClear(&lcd);
+            hangulLcdPuts(&hangul, "10초 잠금");
+            hangulLcdFlush(&hangul);
+            playNotes(lockTone, 1);
             delay(10000);  // 10초 잠금
-            STOP_FREQ();
             attempts = 0;   // 시도 횟수 초기화
 
             // 메뉴 화면으로 복귀
@@ -275,18 +264,20 @@ int checkPassword(int limitAttempts) {
 
 // 메뉴 기능 실행 함수 (각 버튼 번호로 실행)
 void executeMenuOption(int menuOption) {
-    lcdClear(lcdHandle);
+    lcdShadowClear(&lcd);
 
     switch (menuOption) {
     case 1:  // Input PW
         playSoundForKey('1');
         if (!isPasswordSet) {
-            lcdPuts(lcdHandle, "Set PW first!");
+            hangulLcdPuts(&hangul, "먼저 설정하세요");
+            hangulLcdFlush(&hangul);
             delay(2000);
             displayMenu();
             return;
         }
-        lcdPuts(lcdHandle, "Input PW:");
+        hangulLcdPuts(&hangul, "비밀번호:");
+        hangulLcdFlush(&hangul);
         delay(500);
         inputIndex = 0;
         memset(inputPassword, 0, sizeof(inputPassword));
@@ -300,8 +291,9 @@ void executeMenuOption(int menuOption) {
                 playSoundForKey('E'); // E 키 눌렀을 때 소리 재생
                 int result = checkPassword(1);
                 if (result == 1) {  // 성공 시
-                    lcdClear(lcdHandle);
-                    lcdPuts(lcdHandle, "Door opened");
+                    lcdShadowClear(&lcd);
+                    hangulLcdPuts(&hangul, "문이 열렸습니다");
+                    hangulLcdFlush(&hangul);
                     PlaySuccessfulSound();
                     Servo_Open();
                     displayMenu();
@@ -316,12 +308,14 @@ void executeMenuOption(int menuOption) {
     case 2:  // Set PW
         playSoundForKey('2');
         if (isPasswordSet) {
-            lcdPuts(lcdHandle, "Already Set");
+            hangulLcdPuts(&hangul, "이미 설정됨");
+            hangulLcdFlush(&hangul);
             delay(2000);
             displayMenu();
             return;
         }
-        lcdPuts(lcdHandle, "Set new PW:");
+        hangulLcdPuts(&hangul, "새 비밀번호:");
+        hangulLcdFlush(&hangul);
         delay(500);
         inputIndex = 0;
         memset(inputPassword, 0, sizeof(inputPassword));
@@ -337,11 +331,13 @@ void executeMenuOption(int menuOption) {
                     setPassword();
                     break;
                 } else {  // 4자리가 입력되지 않은 상태에서 E를 눌렀을 경우
-                    lcdClear(lcdHandle);
-                    lcdPuts(lcdHandle, "Invalid password");
+                    lcdShadowClear(&lcd);
+                    hangulLcdPuts(&hangul, "잘못된 비밀번호");
+                    hangulLcdFlush(&hangul);
                     delay(1000);
-                    lcdClear(lcdHandle);
-                    lcdPuts(lcdHandle, "Set new PW:");
+                    lcdShadowClear(&lcd);
+                    hangulLcdPuts(&hangul, "새 비밀번호:");
+                    hangulLcdFlush(&hangul);
                     delay(500);
                     inputIndex = 0;
                     memset(inputPassword, 0, sizeof(inputPassword));
@@ -353,7 +349,8 @@ void executeMenuOption(int menuOption) {
         case 3:  // Change PW
         playSoundForKey('3');
         if (!isPasswordSet) {
-            lcdPuts(lcdHandle, "Set PW first!");
+            hangulLcdPuts(&hangul, "먼저 설정하세요");
+            hangulLcdFlush(&hangul);
             delay(2000);
             displayMenu();
             return;
@@ -365,14 +362,14 @@ void executeMenuOption(int menuOption) {
 
         while (1) {
             if (changePWStep == 0) {
-                lcdClear(lcdHandle);
-                lcdPuts(lcdHandle, "3. Change PW");
-                lcdPosition(lcdHandle, 0, 1);
-                lcdPuts(lcdHandle, "As is: ");
+                lcdShadowClear(&lcd);
+                hangulLcdPuts(&hangul, "3. 비밀번호 변경");
+                lcdShadowPosition(&lcd, 0, 1);
+                hangulLcdPuts(&hangul, "현재: ");
                 while (inputIndex < 4) {
                     char key = readKeypad();
                     if (key >= '0' && key <= '9') {
-                        processPasswordInput(key, 7);  // "As is: " 뒤에 * 표시
+                        processPasswordInput(key, 4);  // "현재: " 뒤에 * 표시 (한글 한 글자는 한 칸)
                     }
                 }
                 if (checkPassword(0)) {
@@ -380,22 +377,23 @@ void executeMenuOption(int menuOption) {
                     inputIndex = 0;
                     memset(inputPassword, 0, sizeof(inputPassword));
                 } else {
-                    lcdClear(lcdHandle);
-                    lcdPuts(lcdHandle, "Invalid password");
+                    lcdShadowClear(&lcd);
+                    hangulLcdPuts(&hangul, "잘못된 비밀번호");
                     inputIndex = 0;
                     memset(inputPassword, 0, sizeof(inputPassword));
+                    hangulLcdFlush(&hangul);
                     delay(1000);
                     continue;
                 }
             } else if (changePWStep == 1) {
-                lcdClear(lcdHandle);
-                lcdPuts(lcdHandle, "As is: ****");
-                lcdPosition(lcdHandle, 0, 1);
-                lcdPuts(lcdHandle, "To be: ");
+                lcdShadowClear(&lcd);
+                hangulLcdPuts(&hangul, "현재: ****");
+                lcdShadowPosition(&lcd, 0, 1);
+                hangulLcdPuts(&hangul, "새 번호: ");
                 while (inputIndex < 4) {
                     char key = readKeypad();
                     if (key >= '0' && key <= '9') {
-                        processPasswordInput(key, 7);  // "To be: " 뒤에 * 표시
+                        processPasswordInput(key, 6);  // "새 번호: " 뒤에 * 표시
                     }
                 }
                 setPassword();
@@ -408,8 +406,9 @@ void executeMenuOption(int menuOption) {
         case 4:  // Sound on/off
             playSoundForKey('4');
             soundOn = !soundOn;
-            lcdClear(lcdHandle);
-            lcdPuts(lcdHandle, soundOn ? "Sound on" : "Sound off");
+            lcdShadowClear(&lcd);
+            hangulLcdPuts(&hangul, soundOn ? "소리 켬" : "소리 끔");
+            hangulLcdFlush(&hangul);
             delay(1000);
             displayMenu();
             break;
@@ -420,7 +419,9 @@ void executeMenuOption(int menuOption) {
 int main(void) {
     if (wiringPiSetupGpio() == -1) return 1;
 
-    lcdHandle = lcdInit(2, 16, 4, 2, 4, 20, 21, 12, 16, 0, 0, 0, 0);
+    lcdHandle = hdInit(2, 16, 2, LCD_RW_PIN, 4, 20, 21, 12, 16);
+    lcdShadowInit(&lcd, lcdHandle, 2, 16);
+    hangulLcdInit(&hangul, &lcd);
     displayMenu();
 
     // 버튼 핀 초기화
@@ -436,25 +437,17 @@ int main(void) {
     pinMode(BUTTON9_PIN, INPUT);
     pinMode(BUTTON_DOWN_PIN, INPUT);
     pinMode(BUTTON_ENTER_PIN, INPUT);
+    gpioKeysInit(&keypad, keypadPins, keypadKeys, 12);
 
     Buzzer_Init();
     Servo_Init();
 
     while (1) {
-        if (debounce(BUTTON_DOWN_PIN)) {
+        char key = readKeypad();
+        if (key == 'D') {
             scrollMenu();
-        }
-        if (debounce(BUTTON1_PIN)) {
-            executeMenuOption(1);
-        }
-        if (debounce(BUTTON2_PIN)) {
-            executeMenuOption(2);
-        }
-        if (debounce(BUTTON3_PIN)) {
-            executeMenuOption(3);
-        }
-        if (debounce(BUTTON4_PIN)) {
-            executeMenuOption(4);
+        } else if (key >= '1' && key <= '4') {
+            executeMenuOption(key - '0');
         }
         delay(100);
     }
@@ -1,4 +1,5 @@
 #include <wiringPi.h>  // GPIO 핀 제어를 위한 헤더파일
+#include "../fnd_refresh.h"  // 여섯 자리를 번갈아 켜는 갱신 스레드
 
 // FND 선택 핀 정의
 #define FND_SEL_S0 11
@@ -66,38 +67,24 @@ const int FndPinTable[8] = {
 int main (void) {
     if (wiringPiSetupGpio() == -1) return 1;  // GPIO 설정 실패 시 종료
 
-    int i, k;
+    int i;
     int m = 0;
+    char text[MAX_FND_POSITION + 1];
 
-    pinMode(FND_SEL_S0, OUTPUT);  // FND 선택 핀 출력 모드 설정
-
-    for(i = 0; i < MAX_FND_POSITION; i++) {
-        pinMode(FndSel[i], OUTPUT);  // FND 데이터 핀 출력 모드 설정
-    }
-    
-    for (i = 0; i<FND_DB_PIN_NUM; i++) {
-        pinMode(FndPinTable[i], OUTPUT);
-    }
+    // FND 선택 핀과 데이터 핀을 출력으로 설정하고 갱신 스레드 시작
+    if (fndRefreshBegin(FndSel, FndPinTable, FndNumberTable) == -1) return 1;
 
     while(1) 
     {
+        // 0~F 를 여섯 자리에 걸쳐 한 칸씩 왼쪽으로 흘려 보낸다
         for(i = 0; i < MAX_FND_POSITION; i++) {
-            digitalWrite(FndSel[i], HIGH);  // FND 위치 초기화
+            text[i] = "0123456789ABCDEF"[(m + i) % MAX_CHAR];
         }
-
-        digitalWrite(FndSel[m % 6], LOW);
+        text[MAX_FND_POSITION] = '\0';
+        fndShow(text);  // 갱신 스레드가 여섯 자리를 계속 켜 준다
         m++;
 
-        for(k = 0; k < MAX_CHAR; k++) {
-            for(i = 0; i < FND_DB_PIN_NUM; i++) {
-                if(FndNumberTable[k] & (1 << i)) {
-                    digitalWrite(FndPinTable[i], HIGH);  // 핀 HIGH로 설정하여 표시
-                } else {
-                    digitalWrite(FndPinTable[i], LOW);   // 핀 LOW로 설정하여 표시 끄기
-                }
-            }
-            delay(500);  // 500ms 딜레이
-        }
+        delay(500);  // 500ms 딜레이
     }
 
     return 0;
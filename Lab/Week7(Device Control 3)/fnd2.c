@@ -1,4 +1,6 @@
 #include <wiringPi.h>  // GPIO 핀 제어를 위한 헤더파일
+#include <stdio.h>
+#include "../fnd_refresh.h"  // 여섯 자리를 번갈아 켜는 갱신 스레드
 
 // FND 선택 핀 정의
 #define FND_SEL_S0 11
@@ -53,38 +55,20 @@ const int FndPinTable[8] = {
 int main (void) {
     if (wiringPiSetupGpio() == -1) return 1;  // GPIO 설정 실패 시 종료
 
-    int i, k;
-    int m = 0;
+    char text[MAX_FND_POSITION + 2];  // 여섯 자리 + 소수점
 
-    pinMode(FND_SEL_S0, OUTPUT);  // FND 선택 핀 출력 모드 설정
-
-    for(i = 0; i < MAX_FND_POSITION; i++) {
-        pinMode(FndSel[i], OUTPUT);  // FND 데이터 핀 출력 모드 설정
-    }
-    
-    for (i = 0; i<FND_DB_PIN_NUM; i++) {
-        pinMode(FndPinTable[i], OUTPUT);
-    }
+    // FND 선택 핀과 데이터 핀을 출력으로 설정하고 갱신 스레드 시작
+    if (fndRefreshBegin(FndSel, FndPinTable, FndNumberTable) == -1) return 1;
 
+    unsigned int start = millis();
     while(1) 
     {
-        for(i = 0; i < MAX_FND_POSITION; i++) {
-            digitalWrite(FndSel[i], HIGH);  // 모든 FND 위치를 초기화하여 끄기, 모든 FND 위치를 끔
-        }
-
-        digitalWrite(FndSel[m % 6], LOW);  // 현재 위치(FND)만 활성화
-        m++;
+        // 스톱워치: 초 네 자리 + 1/100초 두 자리 ("  12.34")
+        unsigned int cs = (millis() - start) / 10;
+        snprintf(text, sizeof(text), "%4u.%02u", cs / 100 % 10000, cs % 100);
+        fndShow(text);  // 갱신 스레드가 여섯 자리를 계속 켜 준다
 
-        for(k = 0; k < MAX_CHAR; k++) {
-            for(i = 0; i < FND_DB_PIN_NUM; i++) {
-                if(FndNumberTable[k] & (1 << i)) {
-                    digitalWrite(FndPinTable[i], HIGH);  // 해당 세그먼트를 켜기
-                } else {
-                    digitalWrite(FndPinTable[i], LOW);   // 해당 세그먼트를 끄기
-                }
-            }
-            delay(500);  // 500ms 동안 표시 유지
-        }
+        delay(10);  // 1/100초마다 갱신
     }
 
     return 0;
@@ -0,0 +1,156 @@
+// 6자리 FND 다중화 갱신 스레드 (fnd.c, fnd2.c)
+//
+// FND 는 세그먼트 핀(a~g, dp)을 여섯 자리가 함께 쓰므로 한 번에 한 자리만 켤 수 있다.
+// 갱신 스레드(piThreadCreate)가 자리를 차례로 바꿔 가며 켜서 (자리마다 1초에 FND_REFRESH_HZ 번)
+// 여섯 자리가 동시에 켜져 있는 것처럼 보이게 한다. 60Hz 보다 느리면 깜박임이 보인다.
+// 프로그램은 fndShow("12.3456") 처럼 여섯 글자를 넘기기만 하고 바로 돌아온다.
+//
+// 한 자리를 바꿀 때 GPSET0/GPCLR0 에 두 번 쓴다 (gpio_bulk.h, digitalWrite 15번 -> 메모리 쓰기 2번).
+//   1. GPSET0: 모든 자리 선택 핀 HIGH (끄기) + 새 패턴의 세그먼트 켜기
+//   2. GPCLR0: 나머지 세그먼트 끄기 + 이번 자리 선택 핀 LOW (켜기)
+// 세그먼트는 모든 자리가 꺼져 있을 때만 바뀌므로 앞 자리의 패턴이 다음 자리에 비치지 않는다 (잔상 없음).
+// 패턴 값은 FndNumberTable 과 같은 비트 순서 (bit 0: a ... bit 6: g, bit 7: dp) 이다.
+//
+//   실제 보드:  gcc fnd.c -lwiringPi -o fnd
+//   시뮬레이션: gcc -Isim/include "Lab/Week7(Device Control 3)/fnd.c" sim/sim_board.c -lm -o fnd_sim
+//
+// 여섯 자리 글자는 64비트 하나에 묶어서 한 번에 바꾸므로, 갱신 스레드가 새 글자와 이전 글자를 섞어 켜지 않는다.
+// fndRefreshPerPin 을 1 로 두면 digitalWrite 로 핀마다 쓴다 (비교 측정용, sim/bench_fnd.c).
+// 시뮬레이션 보드에서는 프로그램이 delay 할 때 갱신 스레드가 실행된다.
+#ifndef FND_REFRESH_H
+#define FND_REFRESH_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <wiringPi.h>
+#include "gpio_bulk.h"
+
+#define FND_DIGITS      6
+#define FND_SEGS        8
+#define FND_REFRESH_HZ  100                                          // 자리마다 1초에 켜지는 횟수
+#define FND_SLOT_US     (1000000 / (FND_REFRESH_HZ * FND_DIGITS))    // 한 자리를 켜 두는 시간
+#define FND_SEG_G       0x40
+#define FND_SEG_DP      0x80
+
+typedef struct {
+    int sel[FND_DIGITS], seg[FND_SEGS];
+    const int* table;                      // '0'~'9', 'A'~'F' 패턴 (FndNumberTable)
+    uint32_t selMask, segMask;             // 선택 핀 전체, 세그먼트 핀 전체
+    uint32_t selBit[FND_DIGITS];
+    uint32_t segOn[256];                   // 패턴 -> 켤 세그먼트 핀
+    _Atomic uint64_t text;                 // 자리마다 패턴 한 바이트 (자리 0 이 최하위 바이트)
+    unsigned long scans, stores, late;     // 여섯 자리를 한 바퀴 돈 횟수, 핀/레지스터 쓰기 횟수, 늦어서 시각을 다시 맞춘 횟수
+    int started;
+} FndRefresh;
+
+static FndRefresh fndRefresh;
+static int fndRefreshPerPin = 0;
+
+//1. 갱신 스레드
+static void fndRefreshDigit(int pos, int pattern) {
+    FndRefresh* f = &fndRefresh;
+    if (fndRefreshPerPin) {
+        for (int i = 0; i < FND_DIGITS; i++) digitalWrite(f->sel[i], HIGH);
+        for (int i = 0; i < FND_SEGS; i++) digitalWrite(f->seg[i], (pattern >> i) & 1);
+        digitalWrite(f->sel[pos], LOW);
+        f->stores += FND_DIGITS + FND_SEGS + 1;
+        return;
+    }
+    gpioWriteLevels(f->selMask | f->segOn[pattern], HIGH);
+    gpioWriteLevels((f->segMask & ~f->segOn[pattern]) | f->selBit[pos], LOW);
+    f->stores += 2;
+}
+
+static PI_THREAD(fndRefreshThread) {
+    piHiPri(10);  // 다른 프로그램에 밀리면 한 자리가 오래 켜져 깜박인다
+    unsigned int next = micros();
+    int pos = 0;
+    while (1) {
+        uint64_t text = atomic_load_explicit(&fndRefresh.text, memory_order_relaxed);
+        fndRefreshDigit(pos, (int)(text >> (8 * pos)) & 0xFF);
+        if (++pos == FND_DIGITS) {
+            pos = 0;
+            fndRefresh.scans++;
+        }
+
+        // 켠 시각이 아니라 정해진 시각을 기준으로 기다려서 자리마다 켜진 시간을 같게 한다
+        next += FND_SLOT_US;
+        int left = (int)(next - micros());
+        if (left > 0) {
+            delayMicroseconds((unsigned int)left);
+        } else if (left < -FND_SLOT_US) {
+            next = micros();  // 한 자리 넘게 늦었으면 밀린 자리를 몰아서 켜지 않고 지금부터 다시
+            fndRefresh.late++;
+        }
+    }
+    return NULL;
+}
+
+// 핀을 출력으로 설정하고 모든 자리를 끈 뒤 갱신 스레드를 시작한다.
+// sel: 왼쪽 자리부터 선택 핀 (LOW 가 켜짐), seg: a~g, dp 핀 (HIGH 가 켜짐), table: FndNumberTable
+static int fndRefreshBegin(const int sel[FND_DIGITS], const int seg[FND_SEGS], const int table[16]) {
+    FndRefresh* f = &fndRefresh;
+    f->table = table;
+    f->selMask = f->segMask = 0;
+    for (int i = 0; i < FND_DIGITS; i++) {
+        f->sel[i] = sel[i];
+        pinMode(sel[i], OUTPUT);
+        digitalWrite(sel[i], HIGH);
+        f->selBit[i] = (sel[i] >= 0 && sel[i] < 32) ? 1u << sel[i] : 0;
+        f->selMask |= f->selBit[i];
+    }
+    for (int i = 0; i < FND_SEGS; i++) {
+        f->seg[i] = seg[i];
+        pinMode(seg[i], OUTPUT);
+        digitalWrite(seg[i], LOW);
+        if (seg[i] < 0 || seg[i] >= 32) fndRefreshPerPin = 1;  // GPSET0/GPCLR0 은 GPIO 0~31 만
+        else f->segMask |= 1u << seg[i];
+    }
+    for (int i = 0; i < FND_DIGITS; i++) {
+        if (f->selBit[i] == 0) fndRefreshPerPin = 1;
+    }
+    for (int p = 0; p < 256; p++) {
+        f->segOn[p] = 0;
+        for (int i = 0; i < FND_SEGS; i++) {
+            if (p & (1 << i)) f->segOn[p] |= 1u << (seg[i] & 31);
+        }
+    }
+    atomic_store_explicit(&f->text, 0, memory_order_relaxed);
+
+    if (f->started) return 0;
+    if (piThreadCreate(fndRefreshThread) != 0) {
+        fprintf(stderr, "FND 갱신 스레드 생성 실패\n");
+        return -1;
+    }
+    f->started = 1;
+    return 0;
+}
+
+//2. 표시할 글자 넘기기 (갱신 스레드가 다음 자리부터 새 글자를 켠다)
+// '0'~'9', 'A'~'F' (소문자도) 는 table, '-' 는 g, 나머지는 빈칸
+static inline int fndPattern(char ch) {
+    if (ch >= '0' && ch <= '9') return fndRefresh.table[ch - '0'];
+    if (ch >= 'A' && ch <= 'F') return fndRefresh.table[ch - 'A' + 10];
+    if (ch >= 'a' && ch <= 'f') return fndRefresh.table[ch - 'a' + 10];
+    if (ch == '-') return FND_SEG_G;
+    return 0;
+}
+
+// 왼쪽 자리부터 여섯 글자. '.' 은 자리를 차지하지 않고 앞 글자의 dp 를 켠다. 모자라면 나머지는 빈칸.
+static inline void fndShow(const char* text) {
+    uint64_t packed = 0;
+    int pos = 0;
+    for (; *text; text++) {
+        if (*text == '.') {
+            if (pos == 0) pos++;  // 맨 앞의 '.' 은 빈 자리의 dp
+            packed |= (uint64_t)FND_SEG_DP << (8 * (pos - 1));
+            continue;
+        }
+        if (pos == FND_DIGITS) break;
+        packed |= (uint64_t)(fndPattern(*text) & 0xFF) << (8 * pos++);
+    }
+    atomic_store_explicit(&fndRefresh.text, packed, memory_order_relaxed);
+}
+
+#endif
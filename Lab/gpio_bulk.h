@@ -0,0 +1,149 @@
+// GPIO 레벨 한꺼번에 읽기/쓰기 + 비트마스크 디바운스 (버튼을 핀에 하나씩 직접 연결한 실습 키패드용)
+//
+// BCM283x/BCM2711 의 GPLEV0 레지스터(GPIO 0~31 입력 레벨)를 /dev/gpiomem 으로 매핑해서
+// 버튼 전체를 32비트 읽기 한 번으로, 같은 순간에 샘플링한다 (digitalRead 12번 -> 메모리 읽기 1번).
+// 출력은 GPSET0/GPCLR0 에 비트마스크를 한 번 써서 여러 핀을 동시에 HIGH/LOW 로 바꾼다 (fnd_refresh.h).
+// /dev/gpiomem 이 없거나(라즈베리파이 5 는 GPIO 가 RP1 에 있어 레지스터 배치가 다름) 매핑에 실패하면
+// digitalRead/digitalWrite 로 핀마다 처리한다. 시뮬레이션 보드에서는 simGpioLevels/simGpioWrite 가 같은 역할을 한다.
+//
+//   실제 보드:  gcc ex2.c -lwiringPi -o ex2
+//   시뮬레이션: gcc -Isim/include "Lab/Week6(Device Control 2)/ex2.c" sim/sim_board.c -lm -o ex2_sim
+//
+// 디바운스는 비트마다 2비트 카운터를 두는 세로 카운터(vertical counter)로 전체 마스크를 한 번에 처리한다.
+// 읽은 값이 확정된 상태와 GPIO_KEYS_SAMPLE_MS 간격으로 4번 연속 다르면 그 비트의 상태를 바꾼다.
+// 버튼은 풀업 배선(눌리면 LOW)을 가정한다.
+#ifndef GPIO_BULK_H
+#define GPIO_BULK_H
+
+#include <stdint.h>
+#include <wiringPi.h>
+
+#ifndef SIM_BOARD
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#define GPIO_KEYS_SAMPLE_MS 5   // 디바운스 샘플 간격 (4번 연속 -> 15~20ms)
+#define GPIO_KEYS_MAX       32
+
+//1. 레벨 레지스터 읽기, 출력 레지스터 쓰기
+#ifndef SIM_BOARD
+#define GPIO_BULK_BLOCK 4096
+#define GPIO_GPSET0     7       // 0x1C / 4
+#define GPIO_GPCLR0     10      // 0x28 / 4
+#define GPIO_GPLEV0     13      // 0x34 / 4
+
+static volatile uint32_t* gpioBulkRegs = NULL;
+static int gpioBulkTried = 0;
+static int gpioBulkWritable = 0;
+
+// /dev/gpiomem 매핑 (처음 접근할 때 한 번). 실패하면 -1, 이후 digitalRead/digitalWrite 로 처리한다.
+// 쓰기 권한이 없으면 읽기 전용으로 매핑하고 쓰기만 핀마다 처리한다.
+static int gpioBulkSetup(void) {
+    if (gpioBulkTried) return gpioBulkRegs ? 0 : -1;
+    gpioBulkTried = 1;
+
+    int prot = PROT_READ | PROT_WRITE;
+    int fd = open("/dev/gpiomem", O_RDWR | O_SYNC | O_CLOEXEC);
+    if (fd < 0) {
+        prot = PROT_READ;
+        fd = open("/dev/gpiomem", O_RDONLY | O_SYNC | O_CLOEXEC);
+    }
+    if (fd < 0) return -1;
+    void* map = mmap(NULL, GPIO_BULK_BLOCK, prot, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return -1;
+    gpioBulkRegs = (volatile uint32_t*)map;
+    gpioBulkWritable = (prot & PROT_WRITE) != 0;
+    return 0;
+}
+#endif
+
+// mask 에 해당하는 GPIO(0~31) 의 레벨을 비트로 돌려준다 (1: HIGH)
+static uint32_t gpioReadLevels(uint32_t mask) {
+#ifdef SIM_BOARD
+    return simGpioLevels(mask);
+#else
+    if (gpioBulkSetup() == 0) return gpioBulkRegs[GPIO_GPLEV0] & mask;
+
+    uint32_t levels = 0;
+    for (int pin = 0; pin < 32; pin++) {
+        if ((mask & (1u << pin)) && digitalRead(pin) == HIGH) levels |= 1u << pin;
+    }
+    return levels;
+#endif
+}
+
+// mask 에 해당하는 출력 핀(0~31)을 한꺼번에 HIGH (GPSET0) 또는 LOW (GPCLR0) 로 바꾼다.
+// 다른 핀은 그대로다. pinMode(OUTPUT) 은 미리 해 둔다.
+static inline void gpioWriteLevels(uint32_t mask, int level) {
+#ifdef SIM_BOARD
+    simGpioWrite(mask, level);
+#else
+    if (gpioBulkSetup() == 0 && gpioBulkWritable) {
+        gpioBulkRegs[level ? GPIO_GPSET0 : GPIO_GPCLR0] = mask;
+        return;
+    }
+    for (int pin = 0; pin < 32; pin++) {
+        if (mask & (1u << pin)) digitalWrite(pin, level);
+    }
+#endif
+}
+
+//2. 비트마스크 디바운스
+typedef struct {
+    const int* pins;     // 버튼 핀 (BCM 번호, 0~31)
+    const char* keys;    // pins[i] 를 눌렀을 때 돌려줄 문자
+    int count;
+    uint32_t mask;       // 버튼 핀 전체
+    uint32_t pressed;    // 확정된 눌림 상태 (1: 눌림)
+    uint32_t cnt0, cnt1; // 비트별 2비트 카운터: 확정 상태와 다른 샘플이 연속된 횟수
+    uint32_t events;     // 아직 돌려주지 않은 새 눌림
+} GpioKeys;
+
+static inline void gpioKeysInit(GpioKeys* k, const int* pins, const char* keys, int count) {
+    k->pins = pins;
+    k->keys = keys;
+    k->count = count < GPIO_KEYS_MAX ? count : GPIO_KEYS_MAX;
+    k->mask = 0;
+    for (int i = 0; i < k->count; i++) k->mask |= 1u << pins[i];
+    k->pressed = k->cnt0 = k->cnt1 = k->events = 0;
+}
+
+// 한 번 읽어서 모든 버튼의 카운터를 동시에 진행. 새로 눌림이 확정된 비트를 돌려준다.
+static uint32_t gpioKeysSample(GpioKeys* k) {
+    uint32_t sample = ~gpioReadLevels(k->mask) & k->mask;  // 눌리면 LOW
+    uint32_t delta = sample ^ k->pressed;                   // 확정 상태와 다른 비트
+
+    k->cnt1 = (k->cnt1 ^ k->cnt0) & delta;  // 같아진 비트는 카운터가 0 으로 돌아간다
+    k->cnt0 = ~k->cnt0 & delta;
+    uint32_t toggle = delta & ~(k->cnt0 | k->cnt1);  // 4번째 샘플에서 카운터가 0 으로 넘어간 비트
+    k->pressed ^= toggle;
+
+    uint32_t down = toggle & k->pressed;
+    k->events |= down;
+    return down;
+}
+
+// 떨림이 가라앉을 때까지 샘플링하고, 새로 눌린 버튼 문자 하나를 돌려준다 (없으면 '\0').
+// 아무 변화가 없으면 레지스터를 한 번 읽고 바로 돌아온다. 동시에 눌린 버튼은 다음 호출에서 돌려준다.
+static inline char gpioKeysRead(GpioKeys* k) {
+    if (k->events == 0) {
+        gpioKeysSample(k);
+        while (k->cnt0 | k->cnt1) {
+            delay(GPIO_KEYS_SAMPLE_MS);
+            gpioKeysSample(k);
+        }
+    }
+    for (int i = 0; i < k->count; i++) {
+        uint32_t bit = 1u << k->pins[i];
+        if (k->events & bit) {
+            k->events &= ~bit;
+            return k->keys[i];
+        }
+    }
+    return '\0';
+}
+
+#endif
@@ -0,0 +1,250 @@
+// HD44780 LCD 한글 출력 (lcd_shadow.h 위, CGRAM 사용자 문자 8개를 음절 글꼴 캐시로 쓴다)
+//
+// HD44780 의 문자 ROM 에는 한글이 없고, 직접 정의할 수 있는 문자 (CGRAM) 는 8개뿐이다.
+// 한글 음절을 초성/중성/종성으로 나눠 5x8 칸 하나에 그린 뒤 (hangulGlyph) 비어 있거나
+// 가장 오래 쓰지 않은 CGRAM 슬롯에 올린다 (LRU). 이미 올라가 있는 음절은 다시 보내지 않는다.
+// CGRAM 한 글자를 바꾸려면 명령 1개 + 8바이트 + 커서 위치 명령이 필요하므로
+// 메뉴를 넘길 때 새로 나온 음절만 올리면 화면 전체를 다시 올리는 것보다 훨씬 빠르다.
+//
+//   hangulLcdInit(&hangul, &lcd);               // lcdShadowInit 다음
+//   lcdShadowClear(&lcd);
+//   hangulLcdPuts(&hangul, "1. 비밀번호 입력");  // ASCII 는 그대로, 한글 음절은 슬롯 문자로 frame 에 그린다
+//   hangulLcdFlush(&hangul);                    // 새 글꼴을 CGRAM 에 올리고 바뀐 칸만 보낸다
+//
+// 한 화면(frame)에 서로 다른 음절은 8개까지 나올 수 있다. 지금 frame 에 나오는 슬롯은 바꾸지 않으므로
+// 더 필요하면 그 음절은 HANGUL_MISSING 으로 그리고, hangulLcdFlush 가 그린 못한 음절 수를 돌려주고 stderr 에 알린다.
+// 새 화면을 그릴 때는 lcdShadowClear 를 먼저 불러야 지난 화면의 음절이 슬롯을 붙잡지 않는다.
+// LCD 로 보내는 것은 모두 hangulLcdFlush 로 한다 (lcdShadowFlush 를 직접 부르면 새 글꼴이 올라가지 않는다).
+//
+// 글꼴은 5x8 에 맞춘 근사다. 된소리 초성은 세로 모음 앞(3칸 폭)에서 예사소리 모양으로, 겹받침은 앞 자음으로 그리고,
+// ㅐ/ㅒ, ㅔ/ㅖ 는 같은 모양이다.
+#ifndef HANGUL_LCD_H
+#define HANGUL_LCD_H
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "lcd_shadow.h"
+
+#define HANGUL_SLOTS   8
+#define HANGUL_CODE0   8       // 슬롯 i 를 가리키는 문자 코드 HANGUL_CODE0 + i (8~15 는 0~7 과 같은 CGRAM 글자, 0 은 문자열 끝이라 피한다)
+#define HANGUL_MISSING '#'     // 슬롯이 모자라 그리지 못한 음절
+#define HANGUL_UNKNOWN '?'     // 한글 음절이 아닌 ASCII 밖의 글자
+#define HANGUL_FIRST   0xAC00  // '가'
+#define HANGUL_COUNT   11172
+
+typedef struct {
+    LcdShadow* lcd;
+    uint16_t code[HANGUL_SLOTS];                 // 슬롯에 든 음절 + 1 (0: 비어 있음)
+    unsigned long used[HANGUL_SLOTS];            // 마지막으로 쓴 순번 (LRU)
+    unsigned char glyph[HANGUL_SLOTS][8];
+    unsigned int dirty;                          // CGRAM 에 올려야 하는 슬롯 (비트)
+    int missing;                                 // 지난 hangulLcdFlush 이후 그리지 못한 음절
+    unsigned long tick, hits, misses, uploads, overflows;
+} HangulLcd;
+
+static int hangulLcdCache = 1;  // 0: 화면마다 슬롯을 비우고 모든 음절을 다시 올린다 (비교 측정용, sim/bench_hangul.c)
+
+//1. 음절 글꼴 (한 줄에 5비트, bit 4 가 왼쪽 칸)
+// 초성 19자: ㄱ ㄲ ㄴ ㄷ ㄸ ㄹ ㅁ ㅂ ㅃ ㅅ ㅆ ㅇ ㅈ ㅉ ㅊ ㅋ ㅌ ㅍ ㅎ
+// 좁은 모양 (3x4, 오른쪽에 세로 모음이 올 때)
+static const unsigned char hangulChoNarrow[19][4] = {
+    {7, 1, 1, 1}, {7, 1, 1, 1}, {4, 4, 4, 7}, {7, 4, 4, 7}, {7, 4, 4, 7}, {7, 3, 6, 7}, {7, 5, 5, 7},
+    {5, 7, 5, 7}, {5, 7, 5, 7}, {2, 2, 5, 5}, {2, 2, 5, 5}, {2, 5, 5, 2}, {7, 2, 5, 5}, {7, 2, 5, 5},
+    {2, 7, 2, 5}, {7, 1, 7, 1}, {7, 6, 4, 7}, {7, 2, 2, 7}, {2, 7, 5, 7}
+};
+// 넓은 모양 (5x3, 아래에 가로 모음이 올 때, 받침)
+static const unsigned char hangulConsWide[19][3] = {
+    {31, 1, 1}, {27, 9, 9}, {16, 16, 31}, {31, 16, 31}, {27, 18, 27}, {29, 21, 23}, {31, 17, 31},
+    {17, 31, 31}, {27, 31, 31}, {4, 10, 17}, {10, 21, 21}, {14, 17, 14}, {31, 4, 10}, {31, 10, 21},
+    {4, 31, 10}, {31, 15, 1}, {31, 30, 31}, {31, 10, 31}, {4, 31, 14}
+};
+// 종성 27자 -> hangulConsWide 번호 (겹받침은 앞 자음)
+static const unsigned char hangulJongCons[28] = {
+    0, 0, 1, 0, 2, 2, 2, 3, 5, 5, 5, 5, 5, 5, 5, 5, 6, 7, 7, 9, 10, 11, 12, 14, 15, 16, 17, 18
+};
+// 중성 21자 (ㅏ ㅐ ㅑ ㅒ ㅓ ㅔ ㅕ ㅖ ㅗ ㅘ ㅙ ㅚ ㅛ ㅜ ㅝ ㅞ ㅟ ㅠ ㅡ ㅢ ㅣ) 를 가로 획과 세로 획으로
+//   가로: 0 없음, 1 ㅗ, 2 ㅛ, 3 ㅜ, 4 ㅠ, 5 ㅡ
+//   세로: 0 없음, 1 ㅏ, 2 ㅐ, 3 ㅑ, 4 ㅓ, 5 ㅔ, 6 ㅕ, 7 ㅣ
+static const unsigned char hangulJungH[21] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 3, 3, 3, 3, 4, 5, 5, 0 };
+static const unsigned char hangulJungV[21] = { 1, 2, 3, 2, 4, 5, 6, 5, 0, 1, 2, 7, 0, 0, 4, 5, 7, 0, 0, 7, 7 };
+
+static inline void hangulDot(unsigned char g[8], int x, int y) {
+    g[y] |= (unsigned char)(0x10 >> x);
+}
+
+// 세로 모음: 3~4번 칸, y0~y1 줄
+static void hangulVowelV(unsigned char g[8], int kind, int y0, int y1) {
+    int m = (y0 + y1) / 2;
+    for (int y = y0; y <= y1; y++) {
+        if (kind == 1 || kind == 2 || kind == 3) hangulDot(g, 3, y);
+        if (kind >= 2 && kind != 3) hangulDot(g, 4, y);
+        if (kind == 5 && y >= m) hangulDot(g, 3, y);  // ㅔ: 왼쪽 획은 아래 절반만
+    }
+    switch (kind) {
+    case 1: hangulDot(g, 4, m); break;
+    case 3: hangulDot(g, 4, m - 1); hangulDot(g, 4, m + 1); break;
+    case 4: hangulDot(g, 3, m); break;
+    case 6: hangulDot(g, 3, m - 1); hangulDot(g, 3, m + 1); break;
+    }
+}
+
+// 가로 모음: x0~x1 칸, t, t+1 줄
+static void hangulVowelH(unsigned char g[8], int kind, int x0, int x1, int t) {
+    int c = (x0 + x1) / 2;
+    int bar = (kind == 1 || kind == 2) ? t + 1 : t;
+    for (int x = x0; x <= x1; x++) hangulDot(g, x, bar);
+    switch (kind) {
+    case 1: hangulDot(g, c, t); break;
+    case 2: hangulDot(g, c - 1, t); hangulDot(g, c + 1, t); break;
+    case 3: hangulDot(g, c, t + 1); break;
+    case 4: hangulDot(g, c - 1, t + 1); hangulDot(g, c + 1, t + 1); break;
+    }
+}
+
+// 음절 번호 (0 = '가') 의 5x8 글꼴
+static void hangulGlyph(int syllable, unsigned char g[8]) {
+    int cho = syllable / (21 * 28);
+    int jung = syllable / 28 % 21;
+    int jong = syllable % 28;
+    int h = hangulJungH[jung], v = hangulJungV[jung];
+    for (int y = 0; y < 8; y++) g[y] = 0;
+
+    if (h == 0) {                      // 세로 모음: 초성 왼쪽, 모음 오른쪽
+        int top = jong ? 0 : 1;
+        for (int y = 0; y < 4; y++) g[top + y] |= (unsigned char)(hangulChoNarrow[cho][y] << 2);
+        hangulVowelV(g, v, 0, jong ? 4 : 6);
+    } else if (v == 0) {               // 가로 모음: 초성 위, 모음 아래
+        int top = jong ? 0 : 1;
+        for (int y = 0; y < 3; y++) g[top + y] |= hangulConsWide[cho][y];
+        hangulVowelH(g, h, 0, 4, jong ? 3 : 5);
+    } else if (!jong) {                // 섞인 모음: 초성 왼쪽 위, 가로 획 아래, 세로 획 오른쪽
+        for (int y = 0; y < 4; y++) g[y] |= (unsigned char)(hangulChoNarrow[cho][y] << 2);
+        hangulVowelH(g, h, 0, 2, 4);
+        hangulVowelV(g, v, 0, 6);
+    } else {                           // 섞인 모음 + 받침: 초성을 세 줄로 줄인다 (가운데 아래 줄 생략)
+        static const int rows[3] = { 0, 1, 3 };
+        for (int y = 0; y < 3; y++) g[y] |= (unsigned char)(hangulChoNarrow[cho][rows[y]] << 2);
+        hangulVowelH(g, h, 0, 2, 3);
+        hangulVowelV(g, v, 0, 4);
+    }
+    if (jong) {                        // 받침: 아래 세 줄
+        for (int y = 0; y < 3; y++) g[5 + y] |= hangulConsWide[hangulJongCons[jong]][y];
+    }
+}
+
+//2. CGRAM 슬롯 캐시
+static inline void hangulLcdInit(HangulLcd* h, LcdShadow* lcd) {
+    h->lcd = lcd;
+    for (int i = 0; i < HANGUL_SLOTS; i++) {
+        h->code[i] = 0;
+        h->used[i] = 0;
+    }
+    h->dirty = 0;
+    h->missing = 0;
+    h->tick = h->hits = h->misses = h->uploads = h->overflows = 0;
+}
+
+// 음절이 든 슬롯. 없으면 지금 frame 에 나오지 않는 슬롯 중 비어 있거나 가장 오래 쓰지 않은 슬롯에 넣는다.
+// 모든 슬롯이 frame 에 나오고 있으면 -1
+static int hangulLcdSlot(HangulLcd* h, int syllable) {
+    uint16_t code = (uint16_t)(syllable + 1);
+    h->tick++;
+    for (int i = 0; i < HANGUL_SLOTS; i++) {
+        if (h->code[i] == code) {
+            h->used[i] = h->tick;
+            h->hits++;
+            return i;
+        }
+    }
+    h->misses++;
+
+    const LcdShadow* s = h->lcd;
+    unsigned int pinned = 0;
+    for (int r = 0; r < s->rows; r++) {
+        for (int c = 0; c < s->cols; c++) {
+            unsigned char ch = (unsigned char)s->frame[r][c];
+            if (ch >= HANGUL_CODE0 && ch < HANGUL_CODE0 + HANGUL_SLOTS) pinned |= 1u << (ch - HANGUL_CODE0);
+        }
+    }
+    int victim = -1;
+    for (int i = 0; i < HANGUL_SLOTS; i++) {
+        if (pinned & (1u << i)) continue;
+        if (h->code[i] == 0) {
+            victim = i;
+            break;
+        }
+        if (victim < 0 || h->used[i] < h->used[victim]) victim = i;
+    }
+    if (victim < 0) {
+        h->missing++;
+        h->overflows++;
+        return -1;
+    }
+    h->code[victim] = code;
+    h->used[victim] = h->tick;
+    hangulGlyph(syllable, h->glyph[victim]);
+    h->dirty |= 1u << victim;
+    return victim;
+}
+
+//3. frame 에 그리기 (UTF-8)
+static inline void hangulLcdPuts(HangulLcd* h, const char* text) {
+    const unsigned char* p = (const unsigned char*)text;
+    while (*p) {
+        if (*p < 0x80) {
+            lcdShadowPutchar(h->lcd, (char)*p++);
+            continue;
+        }
+        // 한글 음절은 UTF-8 3바이트 (1110xxxx 10xxxxxx 10xxxxxx)
+        unsigned int cp = 0;
+        if ((p[0] & 0xF0) == 0xE0 && (p[1] & 0xC0) == 0x80 && (p[2] & 0xC0) == 0x80) {
+            cp = (unsigned int)(p[0] & 0x0F) << 12 | (unsigned int)(p[1] & 0x3F) << 6 | (p[2] & 0x3F);
+            p += 3;
+        } else {
+            p++;
+            while ((*p & 0xC0) == 0x80) p++;  // 다른 길이의 글자는 건너뛴다
+        }
+        if (cp < HANGUL_FIRST || cp >= HANGUL_FIRST + HANGUL_COUNT) {
+            lcdShadowPutchar(h->lcd, HANGUL_UNKNOWN);
+            continue;
+        }
+        int slot = hangulLcdSlot(h, (int)(cp - HANGUL_FIRST));
+        lcdShadowPutchar(h->lcd, slot < 0 ? HANGUL_MISSING : (char)(HANGUL_CODE0 + slot));
+    }
+}
+
+__attribute__((format(printf, 2, 3)))
+static inline void hangulLcdPrintf(HangulLcd* h, const char* fmt, ...) {
+    char buffer[LCD_SHADOW_ROWS * LCD_SHADOW_COLS * 3 + 1];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(buffer, sizeof(buffer), fmt, args);
+    va_end(args);
+    hangulLcdPuts(h, buffer);
+}
+
+//4. LCD 에 반영: 새로 넣은 글꼴을 CGRAM 에 올린 뒤 바뀐 칸만 보낸다. 그리지 못한 음절 수를 돌려준다.
+// 슬롯을 바꾼 칸이 LCD 에 남아 있어도 frame 에 그 슬롯이 없으므로 lcdShadowFlush 가 곧 덮어쓴다.
+static inline int hangulLcdFlush(HangulLcd* h) {
+    for (int i = 0; i < HANGUL_SLOTS; i++) {
+        if (!(h->dirty & (1u << i))) continue;
+        hdCharDef(h->lcd->fd, i, h->glyph[i]);
+        h->uploads++;
+    }
+    h->dirty = 0;
+    lcdShadowFlush(h->lcd);
+
+    int missing = h->missing;
+    h->missing = 0;
+    if (missing > 0) {
+        fprintf(stderr, "LCD 한글: 한 화면에 서로 다른 음절이 %d개를 넘어 %d자를 '%c' 로 표시했습니다\n",
+                HANGUL_SLOTS, missing, HANGUL_MISSING);
+    }
+    if (!hangulLcdCache) {
+        for (int i = 0; i < HANGUL_SLOTS; i++) h->code[i] = 0;
+    }
+    return missing;
+}
+
+#endif
@@ -0,0 +1,238 @@
+// HD44780 문자 LCD 드라이버 (4비트, busy flag 확인)
+//
+// wiringPi lcd.c 는 RW 핀을 쓰지 않으므로 최악의 경우를 가정해 기다린다.
+// 니블마다 strobe 에 50us + 50us, 명령마다 delay(2), 지우기에 delay(5) 를 쓰므로
+// 글자 하나에 0.2ms, 위치 명령 하나에 2.2ms 가 걸린다.
+// 이 드라이버는 RW 핀 번호를 주면 (rw >= 0) 다음 바이트를 보내기 전에 busy flag (D7) 를 읽는다.
+// RW 가 GND 에 고정된 기존 배선 (wiringPi lcdInit 과 같음) 이 기본이므로 busy flag 는 직접 켤 때만 쓴다.
+// 컨트롤러가 일을 끝내는 즉시 보내므로 글자와 명령 모두 처리 시간 (약 40us) 만 걸린다.
+// RW 를 GND 에 고정했거나 (rw = -1) busy flag 가 응답하지 않으면 고정 지연으로 기다린다.
+//   - 초기화 때 busy flag 가 되면 일반 명령과 지우기 명령의 실제 처리 시간을 재서 25% 여유를 두고 쓴다.
+//     잰 값이 너무 짧으면 (명령 HD_MIN_EXEC_US, 지우기 HD_MIN_CLEAR_US 미만) D7 이 떠 있는 것으로 보고 쓰지 않는다
+//   - 잴 수 없으면 데이터시트 최악값 (fosc 190kHz: 명령/글자 53us, 지우기/홈 2.16ms)
+// 고정 지연도 보낸 시각부터 세므로, 그 사이 다른 일을 했으면 그만큼 덜 기다린다.
+//
+// 주의: RW 가 HIGH 인 동안은 LCD 가 D4~D7 을 구동한다. 5V 로 동작하는 LCD 모듈을 쓴다면
+//       라즈베리파이 입력(3.3V)에 레벨 변환 없이 연결하지 말고 rw = -1 로 쓴다.
+//
+// wiringPi lcd.h 처럼 hdInit 이 핸들을 돌려주고, 줄 끝에서는 다음 줄 처음으로 넘어간다.
+// 같은 E 핀으로 다시 hdInit 하면 같은 핸들을 다시 초기화한다.
+// 시뮬레이션 보드에서는 hdInit 이 같은 핀에 HD44780 모델을 연결한다 (simHd44780Attach).
+#ifndef HD44780_H
+#define HD44780_H
+
+#include <stdio.h>
+#include <wiringPi.h>
+
+#define HD_MAX_LCDS      2
+#define HD_EXEC_US       53     // 명령/글자 처리 시간 데이터시트 최악값
+#define HD_CLEAR_US      2160   // 지우기/홈
+#define HD_BUSY_LIMIT_US 10000  // 이보다 오래 busy 이면 응답 없음으로 본다
+#define HD_MIN_EXEC_US   20     // 보정 때 이보다 짧게 잰 명령 처리 시간은 믿지 않는다
+#define HD_MIN_CLEAR_US  1000   // 지우기도 같다 (fosc 350kHz 에서도 1.2ms 이상)
+
+typedef struct {
+    int rows, cols;
+    int rs, rw, e, d[4];          // rw < 0: GND 에 고정
+    int cx, cy;                   // 커서 위치 (줄 끝 넘김용)
+    int useBusy;                  // busy flag 로 기다린다
+    unsigned int execUs, clearUs; // 고정 지연
+    unsigned int readyUs;         // 고정 지연 기준: 이 시각 이후 다음 바이트를 보낼 수 있다
+    unsigned long polls;          // busy flag 를 읽은 횟수
+#ifdef SIM_BOARD
+    int simFd;                    // simLcdText 번호
+#endif
+} Hd44780;
+
+static Hd44780 hdLcds[HD_MAX_LCDS];
+static int hdCount = 0;
+
+//1. 버스
+static void hdPulse(const Hd44780* h) {
+    digitalWrite(h->e, HIGH);
+    delayMicroseconds(1);  // E 펄스 폭 450ns 이상
+    digitalWrite(h->e, LOW);
+    delayMicroseconds(1);
+}
+
+static void hdNibble(const Hd44780* h, int nibble) {
+    for (int i = 0; i < 4; i++) digitalWrite(h->d[i], (nibble >> i) & 1);
+    hdPulse(h);
+}
+
+// busy flag 가 내려갈 때까지 읽는다. limitUs 안에 내려가지 않으면 0
+static int hdPollReady(Hd44780* h, unsigned int limitUs) {
+    for (int i = 0; i < 4; i++) pinMode(h->d[i], INPUT);
+    digitalWrite(h->rs, LOW);
+    digitalWrite(h->rw, HIGH);
+    unsigned int start = micros();
+    int busy;
+    do {
+        digitalWrite(h->e, HIGH);
+        delayMicroseconds(1);
+        busy = digitalRead(h->d[3]);  // 상위 니블의 D7
+        digitalWrite(h->e, LOW);
+        delayMicroseconds(1);
+        hdPulse(h);                   // 하위 니블 (주소 카운터) 은 버린다
+        h->polls++;
+    } while (busy && micros() - start < limitUs);
+    digitalWrite(h->rw, LOW);
+    for (int i = 0; i < 4; i++) pinMode(h->d[i], OUTPUT);
+    return !busy;
+}
+
+// 다음 바이트를 보내도 될 때까지 기다린다
+static void hdReady(Hd44780* h) {
+    if (h->useBusy) {
+        if (hdPollReady(h, HD_BUSY_LIMIT_US)) return;
+        h->useBusy = 0;
+        fprintf(stderr, "LCD busy flag 응답 없음, 고정 지연으로 바꿉니다\n");
+    }
+    int left = (int)(h->readyUs - micros());
+    if (left > 0) delayMicroseconds((unsigned int)left);
+}
+
+static void hdSend(Hd44780* h, int rs, unsigned char value, unsigned int execUs) {
+    hdReady(h);
+    digitalWrite(h->rs, rs);
+    hdNibble(h, value >> 4);
+    hdNibble(h, value & 0x0F);
+    h->readyUs = micros() + execUs;
+}
+
+//2. 초기화
+// busy flag 로 명령 처리 시간을 잰다. busy flag 가 응답하지 않으면 0
+static unsigned int hdMeasure(Hd44780* h, unsigned char command) {
+    digitalWrite(h->rs, LOW);
+    hdNibble(h, command >> 4);
+    hdNibble(h, command & 0x0F);
+    unsigned int start = micros();
+    if (!hdPollReady(h, HD_BUSY_LIMIT_US)) return 0;
+    unsigned int us = micros() - start;
+    return us ? us : 1;
+}
+
+// busy flag 를 쓸 수 있는지 확인하고 고정 지연 값을 보정한다
+static void hdCalibrate(Hd44780* h) {
+    if (!hdPollReady(h, HD_BUSY_LIMIT_US)) return;
+    unsigned int execUs = hdMeasure(h, 0x06);  // 입력 모드: 커서 증가
+    unsigned int clearUs = execUs ? hdMeasure(h, 0x01) : 0;
+    if (execUs == 0 || clearUs == 0) {
+        fprintf(stderr, "LCD busy flag 응답 없음, 고정 지연으로 씁니다\n");
+        return;
+    }
+    if (execUs < HD_MIN_EXEC_US || clearUs < HD_MIN_CLEAR_US) {
+        fprintf(stderr, "LCD busy flag 값이 이상합니다 (명령 %uus, 지우기 %uus), 고정 지연으로 씁니다\n",
+                execUs, clearUs);
+        return;
+    }
+    h->useBusy = 1;
+    h->execUs = execUs + execUs / 4 + 1;
+    h->clearUs = clearUs + clearUs / 4 + 1;
+}
+
+// wiringPi lcdInit 과 같은 순서의 핀 (4비트) + RW. 실패하면 -1
+static int hdInit(int rows, int cols, int rs, int rw, int e, int d4, int d5, int d6, int d7) {
+    if (rows < 1 || rows > 4 || cols < 1 || cols > 20) return -1;
+    int fd = 0;
+    while (fd < hdCount && hdLcds[fd].e != e) fd++;
+    if (fd == HD_MAX_LCDS) return -1;
+    if (fd == hdCount) hdCount++;
+
+    Hd44780* h = &hdLcds[fd];
+    h->rows = rows;
+    h->cols = cols;
+    h->rs = rs;
+    h->rw = rw;
+    h->e = e;
+    h->d[0] = d4;
+    h->d[1] = d5;
+    h->d[2] = d6;
+    h->d[3] = d7;
+    h->useBusy = 0;
+    h->execUs = HD_EXEC_US;
+    h->clearUs = HD_CLEAR_US;
+    h->polls = 0;
+#ifdef SIM_BOARD
+    h->simFd = simHd44780Attach(rows, cols, rs, rw, e, d4, d5, d6, d7);
+#endif
+
+    pinMode(rs, OUTPUT);
+    pinMode(e, OUTPUT);
+    digitalWrite(rs, LOW);
+    digitalWrite(e, LOW);
+    if (rw >= 0) {
+        pinMode(rw, OUTPUT);
+        digitalWrite(rw, LOW);
+    }
+    for (int i = 0; i < 4; i++) {
+        pinMode(h->d[i], OUTPUT);
+        digitalWrite(h->d[i], LOW);
+    }
+
+    // 4비트 모드로 들어가기 (데이터시트 Figure 24). 이전 상태와 상관없이 8비트로 맞춘 뒤 바꾼다.
+    delay(50);
+    hdNibble(h, 0x3);
+    delay(5);
+    hdNibble(h, 0x3);
+    delayMicroseconds(150);
+    hdNibble(h, 0x3);
+    delayMicroseconds(150);
+    hdNibble(h, 0x2);
+    delayMicroseconds(150);
+    h->readyUs = micros();
+
+    hdSend(h, 0, rows > 1 ? 0x28 : 0x20, h->execUs);  // 4비트, 줄 수, 5x8
+    if (rw >= 0) hdCalibrate(h);
+    hdSend(h, 0, 0x0C, h->execUs);                    // 표시 켜기, 커서 끄기
+    hdSend(h, 0, 0x06, h->execUs);                    // 커서 증가
+    hdSend(h, 0, 0x01, h->clearUs);                   // 지우기
+    h->cx = h->cy = 0;
+    return fd;
+}
+
+//3. 화면
+static inline void hdPosition(int fd, int x, int y) {
+    Hd44780* h = &hdLcds[fd];
+    if (x < 0 || x >= h->cols || y < 0 || y >= h->rows) return;
+    int addr = (y & 1 ? 0x40 : 0x00) + (y >= 2 ? h->cols : 0) + x;  // 3, 4번째 줄은 1, 2번째 줄 뒤에 이어진다
+    hdSend(h, 0, (unsigned char)(0x80 | addr), h->execUs);
+    h->cx = x;
+    h->cy = y;
+}
+
+static inline void hdClear(int fd) {
+    Hd44780* h = &hdLcds[fd];
+    hdSend(h, 0, 0x01, h->clearUs);
+    h->cx = h->cy = 0;
+}
+
+static inline void hdHome(int fd) {
+    Hd44780* h = &hdLcds[fd];
+    hdSend(h, 0, 0x02, h->clearUs);
+    h->cx = h->cy = 0;
+}
+
+// lcdPutchar 와 같이 줄 끝에서 다음 줄 처음으로 넘어간다
+static inline void hdPutchar(int fd, unsigned char data) {
+    Hd44780* h = &hdLcds[fd];
+    hdSend(h, 1, data, h->execUs);
+    if (++h->cx == h->cols) {
+        int y = h->cy + 1 == h->rows ? 0 : h->cy + 1;
+        hdPosition(fd, 0, y);
+    }
+}
+
+static inline void hdPuts(int fd, const char* str) {
+    while (*str) hdPutchar(fd, (unsigned char)*str++);
+}
+
+// CGRAM 사용자 문자 (index 0~7). 끝나면 커서를 원래 자리로 돌린다.
+static inline void hdCharDef(int fd, int index, const unsigned char data[8]) {
+    Hd44780* h = &hdLcds[fd];
+    hdSend(h, 0, (unsigned char)(0x40 | (index & 7) << 3), h->execUs);
+    for (int i = 0; i < 8; i++) hdSend(h, 1, data[i], h->execUs);
+    hdPosition(fd, h->cx, h->cy);
+}
+
+#endif
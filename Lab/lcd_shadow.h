@@ -0,0 +1,112 @@
+// HD44780 문자 LCD 섀도 버퍼 (hd44780.h 위에서 바뀐 글자만 보내기)
+//
+// 루프마다 화면을 지우고 다시 쓰면 지우기 명령 (1.5ms 넘게) 과 한 화면 전체를 매번 보내야 하고,
+// 지워진 화면이 잠깐 보여 깜박인다.
+// 화면 내용은 frame 에 그리고, lcdShadowFlush 가 LCD 에 실제로 보이는 내용(shown)과 다른 칸만 보낸다.
+// LCD 커서는 글자를 쓸 때마다 오른쪽으로 움직이므로, 바뀐 칸이 바로 다음 칸이 아니면 위치 명령으로 옮긴다
+// (사이에 바뀌지 않은 칸이 하나뿐이면 위치 명령 대신 그 글자를 다시 쓴다).
+//
+//   실제 보드:  gcc ex4.c -lwiringPi -o ex4
+//   시뮬레이션: gcc -Isim/include "Lab/Week10(Sensor Control 2)/ex4.c" sim/sim_board.c -lm -o ex4_sim
+//
+// 시뮬레이션 보드는 HD44780 의 명령 처리 시간과 busy flag 를 흉내 내고, 종료할 때 보낸 글자/명령 수를 출력한다.
+#ifndef LCD_SHADOW_H
+#define LCD_SHADOW_H
+
+#include <stdarg.h>
+#include <stdio.h>
+#include "hd44780.h"
+
+#define LCD_SHADOW_ROWS 4
+#define LCD_SHADOW_COLS 20
+#define LCD_SHADOW_GAP  1   // 이 칸 수 이내의 변경은 사이 글자를 다시 쓴다 (위치 명령도 글자와 같은 1바이트)
+
+typedef struct {
+    int fd, rows, cols;
+    int x, y;                                      // frame 에 다음 글자를 쓸 위치
+    int cx, cy;                                    // LCD 커서 위치
+    char frame[LCD_SHADOW_ROWS][LCD_SHADOW_COLS];  // 보여주려는 화면
+    char shown[LCD_SHADOW_ROWS][LCD_SHADOW_COLS];  // LCD 에 보이는 화면
+    unsigned long chars, moves;                    // LCD 로 보낸 글자, 위치 명령 수
+} LcdShadow;
+
+//1. 초기화 (hdInit 직후 한 번, LCD 를 지우고 시작한다)
+static inline void lcdShadowInit(LcdShadow* s, int fd, int rows, int cols) {
+    s->fd = fd;
+    s->rows = rows < LCD_SHADOW_ROWS ? rows : LCD_SHADOW_ROWS;
+    s->cols = cols < LCD_SHADOW_COLS ? cols : LCD_SHADOW_COLS;
+    for (int r = 0; r < LCD_SHADOW_ROWS; r++) {
+        for (int c = 0; c < LCD_SHADOW_COLS; c++) s->frame[r][c] = s->shown[r][c] = ' ';
+    }
+    s->x = s->y = s->cx = s->cy = 0;
+    s->chars = s->moves = 0;
+    hdClear(fd);
+}
+
+//2. frame 에 그리기 (LCD 로는 아무것도 보내지 않는다)
+static inline void lcdShadowClear(LcdShadow* s) {
+    for (int r = 0; r < s->rows; r++) {
+        for (int c = 0; c < s->cols; c++) s->frame[r][c] = ' ';
+    }
+    s->x = s->y = 0;
+}
+
+static inline void lcdShadowPosition(LcdShadow* s, int x, int y) {
+    if (x < 0 || x >= s->cols || y < 0 || y >= s->rows) return;
+    s->x = x;
+    s->y = y;
+}
+
+// hdPutchar 와 같이 줄 끝에서 다음 줄 처음으로 넘어간다
+static inline void lcdShadowPutchar(LcdShadow* s, char ch) {
+    s->frame[s->y][s->x] = ch;
+    if (++s->x == s->cols) {
+        s->x = 0;
+        if (++s->y == s->rows) s->y = 0;
+    }
+}
+
+static inline void lcdShadowPuts(LcdShadow* s, const char* str) {
+    while (*str) lcdShadowPutchar(s, *str++);
+}
+
+__attribute__((format(printf, 2, 3)))
+static inline void lcdShadowPrintf(LcdShadow* s, const char* fmt, ...) {
+    char buffer[LCD_SHADOW_ROWS * LCD_SHADOW_COLS + 1];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(buffer, sizeof(buffer), fmt, args);
+    va_end(args);
+    lcdShadowPuts(s, buffer);
+}
+
+//3. LCD 에 반영
+// 글자 하나를 현재 커서 위치에 보낸다. 줄 끝에서는 hdPutchar 가 다음 줄로 위치 명령을 보낸다.
+static inline void lcdShadowSend(LcdShadow* s, char ch) {
+    hdPutchar(s->fd, (unsigned char)ch);
+    s->shown[s->cy][s->cx] = ch;
+    s->chars++;
+    if (++s->cx == s->cols) {
+        s->cx = 0;
+        if (++s->cy == s->rows) s->cy = 0;
+        s->moves++;
+    }
+}
+
+// shown 과 다른 칸만 보낸다. 바뀐 것이 없으면 LCD 에 접근하지 않는다.
+static inline void lcdShadowFlush(LcdShadow* s) {
+    for (int r = 0; r < s->rows; r++) {
+        for (int c = 0; c < s->cols; c++) {
+            if (s->frame[r][c] == s->shown[r][c]) continue;
+            if (s->cy != r || s->cx > c || c - s->cx > LCD_SHADOW_GAP) {
+                hdPosition(s->fd, c, r);
+                s->cx = c;
+                s->cy = r;
+                s->moves++;
+            }
+            for (int i = s->cx; i <= c; i++) lcdShadowSend(s, s->frame[r][i]);  // 사이의 같은 글자도 다시 쓴다
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,240 @@
+// 하드웨어 PWM 음 발생 + 타이머 스레드 음 순서기 (buzzer.c, ex2.c, ex3.c, Buzzertest.c, PWM.c)
+//
+// softToneCreate 는 핀마다 우선순위 높은 스레드를 만들어 반주기마다 잠들었다 깨면서 핀을 토글하므로
+// 잠에서 늦게 깨는 만큼 주파수가 흔들린다. 하드웨어 PWM 은 PWM 클럭이 파형을 만들고
+// 음을 바꿀 때만 레지스터를 쓴다.
+//   주파수 = 19.2MHz / 분주 / 범위
+// 분주는 TONE_DIVISOR (2, 9.6MHz) 로 고정하고 범위만 바꾼다. 분주가 작을수록 범위가 커서 주파수 오차가 작고
+// (5kHz 까지 0.03% 이내), pwmSetClock 은 PWM 클럭을 멈췄다가 다시 켜므로 음마다 부르면 소리가 끊긴다.
+// 음표의 범위는 TONE_NOTE 에서 상수식으로 계산되므로 음 표는 컴파일할 때 정해진다.
+//
+// tonePlay 는 음표 배열을 타이머 스레드(piThreadCreate, 프로그램에 하나)에 넘기고 바로 돌아온다.
+// 타이머 스레드가 정해진 시각마다 다음 음으로 바꾼다 (음마다 기다린 시간이 아니라 시작 시각 기준이라 밀리지 않는다).
+// 재생 중에 새 음을 넘기면 지금 음을 끊고 새 음부터 울린다.
+//
+// 하드웨어 PWM 은 GPIO 12/18 (채널 0), 13/19 (채널 1) 만 쓸 수 있다. 다른 핀이면 softTone 으로 울린다
+// (음 바꾸는 시각은 그대로 타이머 스레드가 정한다). 분주와 범위는 두 채널이 함께 쓰므로
+// 다른 채널을 pwmWrite 로 쓰는 프로그램에서는 toneSoftware 를 1 로 둔다.
+// 시뮬레이션 보드에서는 타이머 스레드가 delay 에서 다른 스레드와 번갈아 실행된다.
+#ifndef PWM_TONE_H
+#define PWM_TONE_H
+
+#include <stdio.h>
+#include <wiringPi.h>
+#include <softTone.h>
+#ifndef SIM_BOARD
+#include <errno.h>
+#include <semaphore.h>
+#include <time.h>
+#endif
+
+#define TONE_OSC_HZ     19200000
+#define TONE_DIVISOR    2
+#define TONE_CLOCK_HZ   (TONE_OSC_HZ / TONE_DIVISOR)
+#define TONE_RANGE(hz)  ((hz) > 0 ? (TONE_CLOCK_HZ + (hz) / 2) / (hz) : 0)  // 가장 가까운 범위 (반올림)
+#define TONE_LOCK       2    // piLock 번호 (요청 칸)
+#define TONE_PRIORITY   20
+#define TONE_IDLE_MS    5    // 시뮬레이션 보드에서 새 요청을 다시 확인하는 간격 (울리는 중에는 1ms)
+
+typedef struct {
+    unsigned short hz;   // 0: 쉼
+    unsigned short ms;   // 0: 다음 요청까지 계속
+    unsigned int range;  // TONE_RANGE(hz)
+} ToneNote;
+
+#define TONE_NOTE(hz, ms) { (hz), (ms), TONE_RANGE(hz) }
+#define TONE_REST(ms)     { 0, (ms), 0 }
+#define TONE_COUNT(notes) ((int)(sizeof(notes) / sizeof((notes)[0])))
+
+typedef struct {
+    int pin, hardware, started;
+    int duty;                     // 듀티 (%)
+    // 요청 칸 (TONE_LOCK 으로 보호)
+    const ToneNote* notes;
+    int count, repeat, pending;
+    ToneNote hold;                // toneWrite 로 바로 바꾼 음
+    unsigned long notesPlayed, late;  // 울린 음, 한 음 넘게 늦어서 시각을 다시 맞춘 횟수
+} ToneEngine;
+
+static ToneEngine tone = { .duty = 50 };
+static int toneSoftware = 0;  // 1: 핀과 상관없이 softTone 으로 울린다 (toneBegin 전에)
+#ifndef SIM_BOARD
+static sem_t toneSem;  // tonePlay -> 타이머 스레드
+#endif
+
+// 실행 중에 주파수를 정할 때 (범위를 상수로 만들 수 없을 때)
+static inline ToneNote toneNote(unsigned int hz, unsigned int ms) {
+    ToneNote n = { (unsigned short)hz, (unsigned short)ms, TONE_RANGE(hz) };
+    return n;
+}
+
+//1. 핀 출력
+static void toneOutput(const ToneNote* n) {
+    if (!tone.hardware) {
+        softToneWrite(tone.pin, n->hz);
+        return;
+    }
+    if (n->hz == 0) {
+        pwmWrite(tone.pin, 0);
+        return;
+    }
+    pwmSetRange(n->range);
+    pwmWrite(tone.pin, (int)((unsigned long long)n->range * tone.duty / 100));
+}
+
+//2. 타이머 스레드
+static int tonePending(void) {
+    piLock(TONE_LOCK);
+    int pending = tone.pending;
+    piUnlock(TONE_LOCK);
+    return pending;
+}
+
+#ifndef SIM_BOARD
+static void toneDeadline(struct timespec* ts, unsigned int us) {
+    clock_gettime(CLOCK_REALTIME, ts);
+    ts->tv_sec += us / 1000000;
+    ts->tv_nsec += (long)(us % 1000000) * 1000L;
+    if (ts->tv_nsec >= 1000000000L) {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+#endif
+
+// micros() 가 until 이 될 때까지 (forever 면 새 요청까지) 기다린다. 새 요청이 들어오면 1
+static int toneWaitUntil(unsigned int until, int forever) {
+    while (!tonePending()) {
+        int left = (int)(until - micros());
+        if (!forever && left <= 0) return 0;
+#ifdef SIM_BOARD
+        if (forever) delay(TONE_IDLE_MS);
+        else if (left > 1000) delay(1);
+        else delayMicroseconds((unsigned int)left);
+#else
+        if (forever) {
+            sem_wait(&toneSem);
+        } else {
+            struct timespec ts;
+            toneDeadline(&ts, (unsigned int)left);
+            if (sem_timedwait(&toneSem, &ts) == -1 && errno == ETIMEDOUT) return tonePending();
+        }
+#endif
+    }
+    return 1;
+}
+
+static PI_THREAD(tonePlayer) {
+    piHiPri(TONE_PRIORITY);
+    const ToneNote* notes = NULL;
+    int count = 0, repeat = 0, pos = 0;
+    ToneNote hold;
+    unsigned int next = 0;
+    while (1) {
+        if (pos == count && repeat && count > 0) pos = 0;
+        // 끝났으면 (또는 길이 0 인 음이면) 새 요청까지 기다린다
+        int forever = (pos == count);
+        if (toneWaitUntil(next, forever)) {
+            piLock(TONE_LOCK);
+            hold = tone.hold;
+            notes = (tone.notes == &tone.hold) ? &hold : tone.notes;
+            count = tone.count;
+            repeat = tone.repeat;
+            tone.pending = 0;
+            piUnlock(TONE_LOCK);
+            pos = 0;
+            next = micros();
+            if (count == 0) toneOutput(&hold);  // toneStop
+            continue;
+        }
+
+        const ToneNote* n = &notes[pos++];
+        toneOutput(n);
+        tone.notesPlayed++;
+        if (n->ms == 0) {
+            count = pos;  // 다음 요청까지 이 음을 유지
+            repeat = 0;
+            continue;
+        }
+        if ((int)(micros() - next) > (int)n->ms * 1000) {
+            next = micros();  // 한 음 넘게 늦었으면 밀린 음을 건너뛰지 않고 지금부터 다시
+            tone.late++;
+        }
+        next += n->ms * 1000u;
+        if (pos == count && !repeat) {
+            toneWaitUntil(next, 0);  // 마지막 음 길이만큼 울린 뒤 끈다
+            if (!tonePending()) {
+                ToneNote off = TONE_REST(0);
+                toneOutput(&off);
+            }
+        }
+    }
+    return NULL;
+}
+
+// 핀을 설정하고 타이머 스레드를 시작한다
+static inline int toneBegin(int pin) {
+    tone.pin = pin;
+    tone.hardware = !toneSoftware && (pin == 12 || pin == 13 || pin == 18 || pin == 19);
+    if (tone.hardware) {
+        pinMode(pin, PWM_OUTPUT);
+        pwmSetMode(PWM_MODE_MS);  // balanced 모드는 주파수가 듀티에 따라 바뀐다
+        pwmSetClock(TONE_DIVISOR);
+        pwmWrite(pin, 0);
+    } else {
+        softToneCreate(pin);
+        softToneWrite(pin, 0);
+    }
+    if (tone.started) return 0;
+
+#ifndef SIM_BOARD
+    sem_init(&toneSem, 0, 0);
+#endif
+    if (piThreadCreate(tonePlayer) != 0) {
+        fprintf(stderr, "음 타이머 스레드 생성 실패\n");
+        return -1;
+    }
+    tone.started = 1;
+    return 0;
+}
+
+//3. 음 넘기기 (모두 바로 돌아온다)
+static void toneRequest(const ToneNote* notes, int count, int repeat) {
+    piLock(TONE_LOCK);
+    tone.notes = notes;
+    tone.count = count;
+    tone.repeat = repeat;
+    tone.pending = 1;
+    piUnlock(TONE_LOCK);
+#ifndef SIM_BOARD
+    sem_post(&toneSem);
+#endif
+}
+
+// 음표 배열을 한 번 울린다. notes 는 끝날 때까지 그대로 있어야 한다 (static const 표)
+static inline void tonePlay(const ToneNote* notes, int count) {
+    toneRequest(notes, count, 0);
+}
+
+// 다음 요청까지 되풀이
+static inline void toneRepeat(const ToneNote* notes, int count) {
+    toneRequest(notes, count, 1);
+}
+
+// 지금 음을 끊고 hz 로 계속 울린다 (0: 끄기)
+static inline void toneWrite(unsigned int hz) {
+    piLock(TONE_LOCK);
+    tone.hold = toneNote(hz, 0);
+    piUnlock(TONE_LOCK);
+    if (hz == 0) toneRequest(NULL, 0, 0);
+    else toneRequest(&tone.hold, 1, 0);
+}
+
+// 실제로 나는 주파수 (하드웨어 PWM 은 범위를 정수로 맞춘 값)
+static inline double toneActualHz(const ToneNote* n) {
+    if (n->hz == 0) return 0;
+    if (!tone.hardware) return n->hz;
+    return (double)TONE_CLOCK_HZ / n->range;
+}
+
+#endif
@@ -0,0 +1,281 @@
+// 4상 스테퍼 모터 타이머 스레드 구동 (stepper.c, 28BYJ-48 + ULN2003)
+//
+// 예전 forward/backward 는 상마다 digitalWrite 4번 + delay(del) 였다. delay 는 ms 단위라 상 하나에 1ms 가
+// 가장 짧고 (1000 스텝/초, 실습은 5ms 로 200 스텝/초), 잠에서 늦게 깬 만큼과 digitalWrite 시간이 스텝마다 쌓였다.
+// 가속이 없어서 정지에서 바로 최고 속도로 시작했고, 부른 쪽은 이동이 끝날 때까지 멈춰 있었다.
+//
+// stepperMoveTo / stepperMove 는 목표 위치만 바꾸고 바로 돌아온다. 타이머 스레드(piThreadCreate, 프로그램에 하나)가
+//   1. 가속 표로 다음 스텝의 간격을 정한다 (사다리꼴: 가속 → 최고 속도 → 감속, 이동이 짧으면 삼각형)
+//   2. 정해진 시각(절대 시각)까지 잔다: 실제 보드는 clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME)
+//      으로 STEPPER_SPIN_US 전까지 자고 나머지는 시계를 보며 기다린다
+//   3. 다음 상을 GPSET0/GPCLR0 에 한 번씩 써서 네 핀을 한꺼번에 바꾼다 (gpio_bulk.h).
+//      바뀌는 핀만 쓰므로 반 스텝은 레지스터 한 번, 온 스텝은 켜기 → 끄기 두 번 (그 사이 100ns 정도 세 코일)
+// 시각은 스텝마다 앞 시각 + 간격이라 늦게 깬 만큼이 쌓이지 않는다. 한 스텝 넘게 늦으면
+// 밀린 스텝을 몰아서 내지 않고 (탈조) 지금부터 다시 센다 (late).
+//
+// 가속 표는 stepperConfig 에서 한 번 만든다: 정지에서 i 번째 스텝 간격 = sqrt(2(i+1)/a) - sqrt(2i/a).
+// 타이머 스레드는 곱셈, 나눗셈 없이 표만 읽는다. 움직이는 중에 목표가 바뀌면 지금 속도에서 이어서
+// 가속하거나 감속하고, 반대쪽이면 멈춘 뒤 돌아온다.
+// 반 스텝 (8상, 한 바퀴 4096 스텝) 과 온 스텝 (stepper.c 의 4상, 2048 스텝) 을 고를 수 있다.
+//
+//   실제 보드:  gcc stepper.c -lwiringPi -lm -o stepper
+//   시뮬레이션: gcc -Isim/include "Lab/Week6(Device Control 2)/stepper.c" sim/sim_board.c -lm -o stepper_sim
+// 시뮬레이션 보드에서는 타이머 스레드가 delayMicroseconds 에서 다른 스레드와 번갈아 실행된다.
+#ifndef STEPPER_MOTION_H
+#define STEPPER_MOTION_H
+
+#include <math.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <wiringPi.h>
+#include "gpio_bulk.h"
+#ifndef SIM_BOARD
+#include <errno.h>
+#include <semaphore.h>
+#include <time.h>
+#endif
+
+#define STEPPER_RAMP_MAX  2048  // 가속 표 길이 (최고 속도까지 가속하는 스텝 수)
+#define STEPPER_PRIORITY  50    // 음 타이머 스레드 (pwm_tone.h) 보다 높게
+#define STEPPER_SPIN_US   50    // 실제 보드에서 깨어난 뒤 시계를 보며 기다리는 시간 (clock_nanosleep 지연만큼)
+#define STEPPER_IDLE_MS   5     // 시뮬레이션 보드에서 새 목표를 다시 확인하는 간격
+
+// 상 표 (핀 A B C D 순서로 비트 3 2 1 0). 반 스텝은 8상 모두, 온 스텝은 홀수 칸 (stepper.c 의 setsteps 순서)
+static const unsigned char stepperPhases[8] = { 0x8, 0xC, 0x4, 0x6, 0x2, 0x3, 0x1, 0x9 };
+
+//1. 코일 (상 → 핀 마스크)
+typedef struct {
+    uint32_t mask;       // 네 핀
+    uint32_t on[8];      // 상마다 HIGH 인 핀
+    int stride;          // 1: 반 스텝, 2: 온 스텝
+    int phase;           // stepperPhases 칸
+} StepperCoils;
+
+static inline void stepperCoilsInit(StepperCoils* c, const int pins[4], int halfStep) {
+    c->mask = 0;
+    for (int i = 0; i < 4; i++) c->mask |= 1u << pins[i];
+    for (int p = 0; p < 8; p++) {
+        c->on[p] = 0;
+        for (int i = 0; i < 4; i++) {
+            if (stepperPhases[p] & (0x8 >> i)) c->on[p] |= 1u << pins[i];
+        }
+    }
+    c->stride = halfStep ? 1 : 2;
+    c->phase = halfStep ? 0 : 7;  // 정방향 첫 스텝이 1100
+}
+
+// dir (+1/-1) 쪽으로 한 스텝 간 상의 HIGH 핀
+static inline uint32_t stepperCoilsNext(StepperCoils* c, int dir) {
+    c->phase = (c->phase + dir * c->stride) & 7;
+    return c->on[c->phase];
+}
+
+// mask 핀을 levels 로 바꾼다. 바뀌는 핀만, 켜는 핀 먼저 (코일이 모두 꺼지는 순간이 없다)
+static inline void stepperWritePins(uint32_t* out, uint32_t mask, uint32_t levels) {
+    uint32_t set = levels & mask & ~*out;
+    uint32_t clr = *out & mask & ~levels;
+    if (set) gpioWriteLevels(set, HIGH);
+    if (clr) gpioWriteLevels(clr, LOW);
+    *out = (*out & ~mask) | (levels & mask);
+}
+
+//2. 가속 표
+typedef struct {
+    uint32_t ns[STEPPER_RAMP_MAX];  // 정지에서 i 번째 스텝까지의 간격
+    int len;                        // 가속 스텝 수 (len 부터는 최고 속도)
+    uint32_t cruiseNs;              // 최고 속도 간격
+} StepperRamp;
+
+// maxSps: 최고 속도 (스텝/초), accel: 가속도 (스텝/초^2)
+static inline void stepperRampInit(StepperRamp* r, unsigned int maxSps, unsigned int accel) {
+    r->cruiseNs = 1000000000u / (maxSps ? maxSps : 1);
+    r->len = 0;
+    double k = 2.0 / (accel ? accel : 1);
+    while (r->len < STEPPER_RAMP_MAX) {
+        double ns = 1e9 * (sqrt(k * (r->len + 1)) - sqrt(k * r->len));
+        if (ns <= r->cruiseNs) break;
+        r->ns[r->len++] = (uint32_t)(ns + 0.5);
+    }
+    if (r->len == STEPPER_RAMP_MAX) r->cruiseNs = r->ns[r->len - 1];  // 표가 모자라면 거기까지만 가속
+}
+
+// 움직임 상태 (위치, 방향, 가속 표의 몇 번째 속도인지)
+typedef struct {
+    long pos;
+    int dir;
+    int level;  // 0: 정지. level 스텝이면 멈출 수 있다
+} StepperState;
+
+// 다음 스텝 간격. ahead: 멈춰야 하는 곳까지 남은 스텝 (지나쳤으면 0 이하), level 은 한 스텝 진행한다
+static inline uint32_t stepperSpeed(const StepperRamp* r, int* level, long ahead) {
+    if (ahead <= *level && *level > 0) return r->ns[--*level];          // 감속 (멈출 거리)
+    if (ahead >= *level + 2 && *level < r->len) return r->ns[(*level)++];  // 가속
+    if (*level == r->len) return r->cruiseNs;                             // 최고 속도
+    return r->ns[*level > 0 ? *level - 1 : 0];                            // 한 스텝 남은 가속은 지금 속도로
+}
+
+// target 까지 가는 다음 스텝의 방향과 간격을 정하고 상태를 한 스텝 진행한다. 멈춰 있고 목표에 있으면 0
+static inline int stepperPlan(const StepperRamp* r, StepperState* s, long target, int* dir, uint32_t* ns) {
+    long d = target - s->pos;
+    if (s->level == 0) {
+        if (d == 0) return 0;
+        s->dir = d > 0 ? 1 : -1;
+    }
+    *ns = stepperSpeed(r, &s->level, d * s->dir);  // 지금 방향으로 남은 스텝 (반대쪽이면 0 이하)
+    *dir = s->dir;
+    s->pos += s->dir;
+    return 1;
+}
+
+//3. 타이머 스레드
+typedef struct {
+    StepperCoils coils;
+    StepperRamp ramp;
+    StepperState state;      // 타이머 스레드만 쓴다
+    uint32_t out;            // 네 핀의 지금 레벨
+    int started;
+    atomic_long target, pos;
+    atomic_int moving;
+    // 측정 (타이머 스레드가 쓴다)
+    unsigned long steps, late;       // 낸 스텝, 한 스텝 넘게 늦어서 시각을 다시 맞춘 횟수
+    uint64_t lateMaxNs, lateSumNs;   // 정한 시각보다 늦게 상을 바꾼 시간
+} StepperEngine;
+
+static StepperEngine stepper;
+#ifndef SIM_BOARD
+static sem_t stepperSem;      // stepperMoveTo -> 타이머 스레드
+static sem_t stepperDoneSem;  // 타이머 스레드 -> stepperWait
+#endif
+
+static inline uint64_t stepperNowNs(void) {
+#ifdef SIM_BOARD
+    return simNowNs();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+// 절대 시각 at (stepperNowNs 기준) 까지 기다린다
+static void stepperSleepUntil(uint64_t at) {
+#ifdef SIM_BOARD
+    uint64_t now = simNowNs();
+    if (at > now) delayMicroseconds((unsigned int)((at - now + 999) / 1000));
+#else
+    uint64_t wake = at - STEPPER_SPIN_US * 1000ULL;
+    struct timespec ts = { (time_t)(wake / 1000000000ULL), (long)(wake % 1000000000ULL) };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+    while (stepperNowNs() < at) {
+    }
+#endif
+}
+
+// 새 목표까지 기다린다
+static void stepperIdle(void) {
+#ifdef SIM_BOARD
+    delay(STEPPER_IDLE_MS);
+#else
+    sem_wait(&stepperSem);
+#endif
+}
+
+static PI_THREAD(stepperTimer) {
+    piHiPri(STEPPER_PRIORITY);
+    uint64_t next = stepperNowNs();  // 스레드가 돌기 전에 받은 목표
+    while (1) {
+        int dir;
+        uint32_t ns;
+        if (!stepperPlan(&stepper.ramp, &stepper.state, atomic_load(&stepper.target), &dir, &ns)) {
+            if (atomic_exchange(&stepper.moving, 0)) {
+#ifndef SIM_BOARD
+                sem_post(&stepperDoneSem);
+#endif
+            }
+            stepperIdle();
+            next = stepperNowNs();  // 첫 스텝은 목표를 받은 때부터
+            continue;
+        }
+        atomic_store(&stepper.moving, 1);
+        next += ns;
+        stepperSleepUntil(next);
+        stepperWritePins(&stepper.out, stepper.coils.mask, stepperCoilsNext(&stepper.coils, dir));
+        atomic_store(&stepper.pos, stepper.state.pos);
+
+        uint64_t now = stepperNowNs();
+        uint64_t late = now > next ? now - next : 0;
+        if (late > ns) {
+            next = now;  // 한 스텝 넘게 늦었으면 밀린 스텝을 몰아서 내지 않고 지금부터 다시
+            stepper.late++;
+        }
+        if (late > stepper.lateMaxNs) stepper.lateMaxNs = late;
+        stepper.lateSumNs += late;
+        stepper.steps++;
+    }
+    return NULL;
+}
+
+//4. 시작과 이동 (이동은 모두 바로 돌아온다)
+// 속도를 정한다: maxSps 스텝/초까지 accel 스텝/초^2 로 가속. 멈춰 있을 때만 (stepperWait 뒤)
+static inline void stepperConfig(unsigned int maxSps, unsigned int accel) {
+    stepperRampInit(&stepper.ramp, maxSps, accel);
+}
+
+// 핀 A B C D (BCM 번호, 0~31) 와 스텝 방식을 정하고 타이머 스레드를 시작한다. 위치는 0 부터
+static inline int stepperBegin(const int pins[4], int halfStep, unsigned int maxSps, unsigned int accel) {
+    stepperCoilsInit(&stepper.coils, pins, halfStep);
+    for (int i = 0; i < 4; i++) pinMode(pins[i], OUTPUT);
+    stepper.out = stepper.coils.mask;
+    stepperWritePins(&stepper.out, stepper.coils.mask, 0);
+    stepperConfig(maxSps, accel);
+    if (stepper.started) return 0;
+
+#ifndef SIM_BOARD
+    sem_init(&stepperSem, 0, 0);
+    sem_init(&stepperDoneSem, 0, 0);
+#endif
+    if (piThreadCreate(stepperTimer) != 0) {
+        fprintf(stderr, "스테퍼 타이머 스레드 생성 실패\n");
+        return -1;
+    }
+    stepper.started = 1;
+    return 0;
+}
+
+// 절대 위치 target (스텝) 으로
+static inline void stepperMoveTo(long target) {
+    atomic_store(&stepper.target, target);
+#ifndef SIM_BOARD
+    sem_post(&stepperSem);
+#endif
+}
+
+// 지금 목표에서 steps 만큼 (음수: 반대 방향)
+static inline void stepperMove(long steps) {
+    stepperMoveTo(atomic_load(&stepper.target) + steps);
+}
+
+// 타이머 스레드가 마지막으로 낸 스텝의 위치
+static inline long stepperPosition(void) {
+    return atomic_load(&stepper.pos);
+}
+
+// 목표에 닿지 않았거나 움직이는 중이면 1
+static inline int stepperBusy(void) {
+    return atomic_load(&stepper.moving) || atomic_load(&stepper.pos) != atomic_load(&stepper.target);
+}
+
+// 목표에 닿아 멈출 때까지 기다린다
+static inline void stepperWait(void) {
+    while (stepperBusy()) {
+#ifdef SIM_BOARD
+        delay(1);
+#else
+        sem_wait(&stepperDoneSem);  // 앞 이동에서 남은 신호로 깨도 다시 확인한다
+#endif
+    }
+}
+
+#endif
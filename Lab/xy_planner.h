@@ -0,0 +1,257 @@
+// XY 두 축 스테퍼 직선 보간 (자판기 나선 칸 대신 XY 로 음료를 집는 승강기, stepper_motion.h 의 모터 두 개)
+//
+// 축마다 stepper_motion.h 의 타이머 스레드를 하나씩 돌리면 두 축이 따로 가속하고 따로 늦어서
+// 대각선이 휘고 끝나는 시각도 다르다. 여기서는 타이머 스레드 하나가 두 축을 같이 낸다.
+//   - 틱마다 큰 축(스텝이 많은 축)은 한 스텝, 작은 축은 브레즌햄 오차가 넘칠 때만 한 스텝
+//     (직선에서 반 스텝 넘게 벗어나지 않는다)
+//   - 틱 간격은 큰 축 기준 가속 표 (stepper_motion.h 의 StepperRamp, stepperSpeed) 로 정한다.
+//     그래서 최고 속도는 빠른 축의 스텝/초다
+//   - 두 모터의 여덟 핀을 GPSET0/GPCLR0 에 한 번씩 써서 같이 바꾼다 (stepperWritePins)
+//
+// xyMoveTo 는 목표를 줄 (XY_QUEUE_MAX 칸) 에 넣고 바로 돌아온다. 줄에 선분이 더 있으면 이음에서 멈추지 않는다.
+// 이음의 속도 한도는 방향이 바뀌는 만큼 정한다: 큰 축 속도 v 로 넘어갈 때 축마다 속도가 v * |u1 - u2|
+// (u: 큰 축 스텝당 그 축 스텝) 만큼 한 번에 바뀌므로 그 값이 정지에서 첫 스텝 정도
+// (가속 표 XY_JUNCTION_LEVEL 칸) 가 되도록 한다. 같은 방향이면 최고 속도 그대로, 직각이면 거의 멈춘다.
+// 선분을 넣을 때마다 줄을 뒤에서부터 훑어 각 이음의 속도를 정한다 (뒤 선분이 짧으면 그 안에서 멈출 수 있게).
+// xyBlend 가 0 이면 선분마다 멈춘다 (비교 측정용, sim/bench_xy.c).
+//
+// 시뮬레이션 보드에서는 타이머 스레드가 delayMicroseconds 에서 다른 스레드와 번갈아 실행된다.
+#ifndef XY_PLANNER_H
+#define XY_PLANNER_H
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include "stepper_motion.h"
+
+#define XY_QUEUE_MAX       16
+#define XY_LOCK            3    // piLock 번호 (줄)
+#define XY_JUNCTION_LEVEL  4    // 이음에서 축 속도가 한 번에 바뀌어도 되는 만큼 (가속 표 칸)
+
+typedef struct {
+    long dx, dy;     // 스텝
+    long n;          // 틱 수 (큰 축 스텝 수)
+    int limit;       // 다음 선분과의 이음에서 속도 한도 (가속 표 칸)
+    int exit;        // 끝날 때 속도 (xyReplan 이 정한다)
+} XySegment;
+
+typedef struct {
+    StepperCoils x, y;
+    StepperRamp ramp;        // 큰 축 기준
+    uint32_t mask, out;      // 여덟 핀, 지금 레벨
+    int started;
+    // 줄 (XY_LOCK 으로 보호)
+    XySegment queue[XY_QUEUE_MAX];
+    int head, count;
+    long qx, qy;             // 마지막으로 넣은 목표
+    // 타이머 스레드만 쓴다
+    int level;
+    long done, err;          // 지금 선분에서 낸 틱, 브레즌햄 오차
+    atomic_long px, py;
+    atomic_int moving;
+    // 측정 (타이머 스레드가 쓴다)
+    unsigned long ticks, stepsX, stepsY, late;
+    unsigned long blended, stops;    // 멈추지 않고 넘어간 이음, 멈춘 이음
+    uint64_t lateMaxNs, lateSumNs;
+} XyPlanner;
+
+static XyPlanner xy;
+static int xyBlend = 1;  // 0: 선분마다 멈춘다
+#ifndef SIM_BOARD
+static sem_t xySem;      // xyMoveTo -> 타이머 스레드
+static sem_t xyDoneSem;  // 타이머 스레드 -> xyWait
+#endif
+
+//1. 줄과 이음 속도
+// 앞 선분 a 에서 b 로 넘어갈 때의 속도 한도
+static int xyJunction(const XySegment* a, const XySegment* b) {
+    if (!xyBlend) return 0;
+    double ux = (double)a->dx / a->n - (double)b->dx / b->n;
+    double uy = (double)a->dy / a->n - (double)b->dy / b->n;
+    double d = fabs(ux) > fabs(uy) ? fabs(ux) : fabs(uy);
+    if (d * d * xy.ramp.len <= XY_JUNCTION_LEVEL) return xy.ramp.len;
+    return (int)(XY_JUNCTION_LEVEL / (d * d));
+}
+
+// 뒤에서부터 이음 속도를 정한다: 마지막은 멈추고, 앞 이음은 한도와 뒤 선분 안에서 줄일 수 있는 만큼 중 작은 쪽
+static void xyReplan(void) {
+    int next = 0;
+    long nextN = 0;
+    for (int k = xy.count - 1; k >= 0; k--) {
+        XySegment* s = &xy.queue[(xy.head + k) % XY_QUEUE_MAX];
+        long exit = (k == xy.count - 1) ? 0 : next + nextN;
+        if (k < xy.count - 1 && exit > s->limit) exit = s->limit;
+        s->exit = (int)exit;
+        next = s->exit;
+        nextN = s->n;
+    }
+}
+
+//2. 타이머 스레드
+// 새 목표까지 기다린다
+static void xyIdle(void) {
+#ifdef SIM_BOARD
+    delay(STEPPER_IDLE_MS);
+#else
+    sem_wait(&xySem);
+#endif
+}
+
+static PI_THREAD(xyTimer) {
+    piHiPri(STEPPER_PRIORITY);
+    uint64_t next = stepperNowNs();
+    while (1) {
+        piLock(XY_LOCK);
+        if (xy.count == 0) {
+            piUnlock(XY_LOCK);
+            if (atomic_exchange(&xy.moving, 0)) {
+#ifndef SIM_BOARD
+                sem_post(&xyDoneSem);
+#endif
+            }
+            xyIdle();
+            next = stepperNowNs();  // 첫 틱은 목표를 받은 때부터
+            continue;
+        }
+        XySegment s = xy.queue[xy.head];
+        piUnlock(XY_LOCK);
+        atomic_store(&xy.moving, 1);
+        if (xy.done == 0) xy.err = s.n / 2;
+
+        uint32_t ns = stepperSpeed(&xy.ramp, &xy.level, s.n - xy.done + s.exit);
+        next += ns;
+        stepperSleepUntil(next);
+
+        // 큰 축은 한 스텝, 작은 축은 브레즌햄
+        long ax = labs(s.dx), ay = labs(s.dy);
+        int stepX = 1, stepY = 1;
+        if (ax >= ay) {
+            xy.err -= ay;
+            stepY = xy.err < 0;
+        } else {
+            xy.err -= ax;
+            stepX = xy.err < 0;
+        }
+        if (xy.err < 0) xy.err += s.n;
+        uint32_t on = stepX ? stepperCoilsNext(&xy.x, s.dx > 0 ? 1 : -1) : xy.x.on[xy.x.phase];
+        on |= stepY ? stepperCoilsNext(&xy.y, s.dy > 0 ? 1 : -1) : xy.y.on[xy.y.phase];
+        stepperWritePins(&xy.out, xy.mask, on);
+        if (stepX) atomic_fetch_add(&xy.px, s.dx > 0 ? 1 : -1);
+        if (stepY) atomic_fetch_add(&xy.py, s.dy > 0 ? 1 : -1);
+        xy.stepsX += stepX;
+        xy.stepsY += stepY;
+        xy.ticks++;
+
+        uint64_t now = stepperNowNs();
+        uint64_t late = now > next ? now - next : 0;
+        if (late > ns) {
+            next = now;  // 한 틱 넘게 늦었으면 몰아서 내지 않고 지금부터 다시
+            xy.late++;
+        }
+        if (late > xy.lateMaxNs) xy.lateMaxNs = late;
+        xy.lateSumNs += late;
+
+        if (++xy.done == s.n) {  // 선분 끝
+            piLock(XY_LOCK);
+            xy.head = (xy.head + 1) % XY_QUEUE_MAX;
+            xy.count--;
+            int more = xy.count > 0;
+            piUnlock(XY_LOCK);
+            xy.done = 0;
+            if (more && xy.level > 0) xy.blended++;
+            else if (more) xy.stops++;
+        }
+    }
+    return NULL;
+}
+
+//3. 시작과 이동 (이동은 모두 바로 돌아온다)
+// 큰 축 속도를 정한다: maxSps 스텝/초까지 accel 스텝/초^2. 멈춰 있을 때만 (xyWait 뒤)
+static inline void xyConfig(unsigned int maxSps, unsigned int accel) {
+    stepperRampInit(&xy.ramp, maxSps, accel);
+}
+
+// 두 모터의 핀 A B C D (BCM 번호, 0~31) 와 스텝 방식을 정하고 타이머 스레드를 시작한다. 위치는 (0, 0) 부터
+static inline int xyBegin(const int xPins[4], const int yPins[4], int halfStep, unsigned int maxSps,
+                          unsigned int accel) {
+    stepperCoilsInit(&xy.x, xPins, halfStep);
+    stepperCoilsInit(&xy.y, yPins, halfStep);
+    xy.mask = xy.x.mask | xy.y.mask;
+    for (int i = 0; i < 4; i++) {
+        pinMode(xPins[i], OUTPUT);
+        pinMode(yPins[i], OUTPUT);
+    }
+    xy.out = xy.mask;
+    stepperWritePins(&xy.out, xy.mask, 0);
+    xyConfig(maxSps, accel);
+    if (xy.started) return 0;
+
+#ifndef SIM_BOARD
+    sem_init(&xySem, 0, 0);
+    sem_init(&xyDoneSem, 0, 0);
+#endif
+    if (piThreadCreate(xyTimer) != 0) {
+        fprintf(stderr, "XY 타이머 스레드 생성 실패\n");
+        return -1;
+    }
+    xy.started = 1;
+    return 0;
+}
+
+// (x, y) 까지 직선으로 가는 선분을 줄에 넣는다. 줄이 차 있으면 -1 (앞 선분이 끝나면 다시)
+static inline int xyMoveTo(long x, long y) {
+    piLock(XY_LOCK);
+    if (xy.count == XY_QUEUE_MAX) {
+        piUnlock(XY_LOCK);
+        return -1;
+    }
+    XySegment s = { x - xy.qx, y - xy.qy, 0, 0, 0 };
+    s.n = labs(s.dx) > labs(s.dy) ? labs(s.dx) : labs(s.dy);
+    if (s.n > 0) {
+        if (xy.count > 0) {
+            XySegment* last = &xy.queue[(xy.head + xy.count - 1) % XY_QUEUE_MAX];
+            last->limit = xyJunction(last, &s);
+        }
+        xy.queue[(xy.head + xy.count) % XY_QUEUE_MAX] = s;
+        xy.count++;
+        xy.qx = x;
+        xy.qy = y;
+        xyReplan();
+    }
+    piUnlock(XY_LOCK);
+#ifndef SIM_BOARD
+    sem_post(&xySem);
+#endif
+    return 0;
+}
+
+// 줄에 남은 선분 수 (지금 가는 선분 포함)
+static inline int xyQueued(void) {
+    piLock(XY_LOCK);
+    int count = xy.count;
+    piUnlock(XY_LOCK);
+    return count;
+}
+
+// 타이머 스레드가 마지막으로 낸 틱의 위치
+static inline void xyPosition(long* x, long* y) {
+    *x = atomic_load(&xy.px);
+    *y = atomic_load(&xy.py);
+}
+
+// 줄에 선분이 남았거나 움직이는 중이면 1
+static inline int xyBusy(void) {
+    return atomic_load(&xy.moving) || xyQueued() > 0;
+}
+
+// 줄의 선분을 모두 가고 멈출 때까지 기다린다
+static inline void xyWait(void) {
+    while (xyBusy()) {
+#ifdef SIM_BOARD
+        delay(1);
+#else
+        sem_wait(&xyDoneSem);  // 앞 이동에서 남은 신호로 깨도 다시 확인한다
+#endif
+    }
+}
+
+#endif
@@ -9,6 +9,17 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <softPwm.h>
+#include "vend_stage.h"
+#include "vend_metrics.h"
+#include "term_screen.h"   // 화면 출력: 이중 버퍼, 바뀐 칸만 출력
+#include "ui_text.h"       // 고정 안내문 표, 숫자만 바뀌는 줄
+#include "gpio_profile.h"  // -DGPIO_PROFILE 일 때만 동작, wiringPi 헤더들 뒤에 포함
+#include "keypad.h"        // GPIO 를 쓰는 헤더는 gpio_profile.h 뒤에 (프로파일에 포함되도록)
+#include "buzzer.h"        // 소리는 재생 스레드가 울리고 playXxxSound 는 바로 돌아온다
+#include "voice.h"         // 음성 안내 (GPIO 18 PWM, 없으면 buzzer.h)
+#include "servo.h"         // 서보 채널은 시작할 때 한 번만 만들고 배출 동작은 타임라인 단계로
+#include "actuator.h"      // 투입/배출/잔돈 구동기를 타임라인으로 겹쳐 실행
+#include "pwm_alloc.h"     // 음성/모터/서보가 하드웨어 PWM 채널 두 개를 나눠 쓴다
 
 
 // 음료 구조체 정의
@@ -40,11 +51,13 @@ void moveCursor(int row, int col);
 void playInputSound();
 void playSuccessSound();
 void playFailureSound();
+void playPrompt(int prompt);
 void MotorControl(unsigned char speed, unsigned char rotate);
 void MotorStopGradual();
 void MotorStop();
 void setupMotorPins();
-void playBuzzer(int frequency, int duration);
+int actMotor(ActTimeline* t, unsigned char rotate, unsigned int ms, int after);
+void holdMessage(uint32_t shownMs, unsigned int ms);
 
 
 //1. 센서 및 핀 정의
@@ -75,6 +88,11 @@ int machineBalance = 10000;  // 자판기 초기 잔고
 #define MOTOR_PWM_PIN 19  // PWM 핀
 #define MOTOR_MT_P_PIN 23   // 모터의 양극 핀
 #define MOTOR_MT_N_PIN 24   // 모터의 음극 핀
+#define MOTOR_PWM_HZ 20000      // 하드웨어 PWM 반송파 (들리지 않게)
+#define MOTOR_PWM_MAX_HZ 40000  // 음성 반송파(37.5kHz)와 채널 설정을 같이 쓸 수 있다
+#define MOTOR_SOFT_RANGE 100    // 하드웨어 채널을 못 받으면 softPwm (100Hz, 속도 0~100)
+
+static PwmOut motorPwm;
 
 // 모터 회전 방향 정의
 #define FORWARD 1  // 정방향 회전
@@ -93,47 +111,97 @@ int prevState; // 전역 변수로 선언
 int dht11_dat[5] = {0};
 
 //2. 입력 처리 및 유틸리티
-//메시지 출력 위치 및 내용을 저장하는 구조체 정의
-typedef struct {
-    int row;           // 출력 행
-    int col;           // 출력 열
-    char message[100]; // 출력할 메시지
-} Message;
-
-//메시지 출력 함수(덮어씌우는 문제 방지)
-void printMessageStruct(Message msg) {
-    moveCursor(msg.row, msg.col);   // 지정된 위치로 커서 이동
-    printf("\033[K");               // 현재 커서 위치부터 줄 끝까지 삭제
-    printf("%s", msg.message);      // 메시지 출력
-    fflush(stdout);                 // 출력 강제 갱신
+//메시지 출력 위치 및 내용 (고정 안내문은 커서 이동, 줄 지우기까지 붙여서 한 표에 둔다, ui_text.h)
+#define MSG_CASH_PROMPT  0
+#define MSG_NO_CHANGE    1
+#define MSG_CASH_PAID    2
+#define MSG_SHORT        3
+#define MSG_HOME         4
+#define MSG_CLEAR        5
+#define MSG_CARD_WAIT    6
+#define MSG_CARD_PAID    7
+#define MSG_CARD_FAILED  8
+#define MSG_PAY_CHOICE   9
+#define MSG_NO_CASH      10
+#define MSG_PAY_HOME     11
+#define MSG_PAY_INVALID  12
+#define MSG_COUNT        13
+
+static const UiText messages[MSG_COUNT] = {
+    [MSG_CASH_PROMPT] = UI_TEXT(6, 1, "현금을 입력하세요 (100원 단위, 최대 5자리): "),
+    [MSG_NO_CHANGE]   = UI_TEXT(8, 1, "거스름돈이 부족합니다. 잔고를 충전해주세요."),
+    [MSG_CASH_PAID]   = UI_TEXT(8, 1, "결제가 완료되었습니다! 음료를 제공 중입니다."),
+    [MSG_SHORT]       = UI_TEXT(8, 1, "금액이 부족합니다. 다시 입력해주세요."),
+    [MSG_HOME]        = UI_TEXT(8, 1, "홈 화면으로 돌아갑니다."),
+    [MSG_CLEAR]       = UI_TEXT(8, 1, ""),  // 8행 메시지 지우기
+    [MSG_CARD_WAIT]   = UI_TEXT(1, 1, "카드를 리더기에 대주세요..."),
+    [MSG_CARD_PAID]   = UI_TEXT(9, 1, "카드 결제가 완료되었습니다."),
+    [MSG_CARD_FAILED] = UI_TEXT(9, 1, "카드 결제가 실패했습니다. 다시 시도해주세요."),
+    [MSG_PAY_CHOICE]  = UI_TEXT(1, 1, "결제 방식을 선택하세요:\n1. 현금 결제\n2. 카드 결제"),
+    [MSG_NO_CASH]     = UI_TEXT(5, 1, "현금 결제 불가: 자판기 잔고 부족\n"),
+    [MSG_PAY_HOME]    = UI_TEXT(9, 1, "홈 화면으로 돌아갑니다."),
+    [MSG_PAY_INVALID] = UI_TEXT(9, 1, "잘못된 선택입니다. 다시 시도하세요."),
+};
+
+//메시지 출력 함수(덮어씌우는 문제 방지): 줄을 지우고 만들어 둔 글자를 그대로 보낸다
+// 화면에는 기다리기 전 (readKeypad, holdMessage, delay 앞) 의 screenFlush 에서 한 번에 나간다
+void printText(const char* text, int len) {
+    STAGE_BEGIN(STAGE_RENDER);
+    vendMetricKeyEcho();
+    screenWrite(text, len);
+    STAGE_END(STAGE_RENDER);
+}
+
+void printMessage(int id) {
+    printText(messages[id].text, messages[id].len);
+}
+
+void printLine(const UiLine* line) {
+    printText(line->buf, line->len);
+}
+
+// 메시지를 띄운 뒤 ms 가 지날 때까지 (구동기를 기다리는 동안 이미 지났으면 바로 돌아온다)
+void holdMessage(uint32_t shownMs, unsigned int ms) {
+    screenFlush();
+    uint32_t shown = millis() - shownMs;
+    if (shown < ms) delay(ms - shown);
+}
+
+// 숫자가 바뀐 줄만 다시 출력
+void printNumber(UiLine* line, int value) {
+    if (uiLineSetNumber(line, value)) printLine(line);
 }
 
 // ANSI 화면 초기화 함수
 void clearScreen() {
-    printf("\033[2J"); // 화면 전체 지우기
-    printf("\033[H");  // 커서를 화면 맨 위로 이동
+    vendMetricKeyEcho();  // 키 입력에 대한 화면 반응
+    screenPrintf("\033[2J"); // 화면 전체 지우기
+    screenPrintf("\033[H");  // 커서를 화면 맨 위로 이동
 }
 
 // ANSI 커서 이동 함수  결제 시스템에서 사용자 입력받는 화면이 계속 깜빡이는 문제를 해결하기 위해
 //입력된 값이나 동적인 부분만 갱신하도록 변경
 void moveCursor(int row, int col) {
-    printf("\033[%d;%dH", row, col); // row행 col열로 커서 이동
+    vendMetricKeyEcho();
+    screenPrintf("\033[%d;%dH", row, col); // row행 col열로 커서 이동
 }
 
 //초기 출력
 void displayMainMenu() {
+    STAGE_BEGIN(STAGE_RENDER);
     clearScreen();
-    printf("음료 자판기에 오신 것을 환영합니다!\n");
-    printf("잔고: %d원\n", machineBalance);
-    printf("1번: 사용자 선택 / 2번: 음료 추천 시스템\n");
-    fflush(stdout);
+    screenPrintf("음료 자판기에 오신 것을 환영합니다!\n");
+    screenPrintf("잔고: %d원\n", machineBalance);
+    screenPrintf("1번: 사용자 선택 / 2번: 음료 추천 시스템\n");
+    screenFlush();
+    STAGE_END(STAGE_RENDER);
 }
 
 // 음료 목록 표시
 void displayDrinks(Drink drinks[], int startIdx, int endIdx) {
-    printf("\n음료 목록 (페이지 %d):\n", (startIdx / 5) + 1);
+    screenPrintf("\n음료 목록 (페이지 %d):\n", (startIdx / 5) + 1);
     for (int i = startIdx; i <= endIdx && i < 40; i++) {
-        printf("%d. %s\n", i + 1, drinks[i].name);
+        screenPrintf("%d. %s\n", i + 1, drinks[i].name);
     }
 
 }
@@ -150,127 +218,76 @@ char keys[4][4] = {
 int rowPins[4] = {ROW1, ROW2, ROW3, ROW4};
 int colPins[4] = {COL1, COL2, COL3, COL4};
 
-// 디바운스 함수
-int debouncePin(int pin) {
-    if (digitalRead(pin) == HIGH) {  // 첫 번째 HIGH 감지
-        delay(50);  // 50ms 동안 안정화 대기
-        if (digitalRead(pin) == HIGH) {  // 다시 확인
-            while (digitalRead(pin) == HIGH);  // 키가 떼어질 때까지 대기
-            delay(50);  // 떼어진 후 다시 안정화
-            return 1;  // 안정적으로 눌림 확인
-        }
-    }
-    return 0;
-}
+#define KEY_WAIT_MS 20  // readKeypad 가 키 이벤트를 기다리는 최대 시간
+
+#define ADMIN_CHORD 'M'  // H+E 1.5초: 관리자 모드 진입 (키패드 조합 이벤트 id)
+
+// H+E 를 함께 누른 뒤 모두 뗄 때까지 (관리자 모드 조합이므로 일반 키로 넘기지 않음)
+static int homeEnterChord = 0;
+// 관리자 모드 조합이 완성되어 isHomeAndEnterLongPressed 에서 처리할 차례
+static int adminChordPending = 0;
 
 // 키패드 읽기 함수
+// 인터럽트 스캐너의 이벤트 큐에서 키를 꺼낸다. KEY_WAIT_MS 동안 키가 없으면 '\0'
+// 관리자 모드 조합이 완성되면 '\0' 을 반환하고 isHomeAndEnterLongPressed 가 처리한다
 char readKeypad() {
-    char keyPressed = '\0';
-
-    for (int row = 0; row < 4; row++) {
-        digitalWrite(rowPins[row], HIGH);  // 해당 행 활성화
-        delayMicroseconds(100);  // 안정화 대기
-
-        for (int col = 0; col < 4; col++) {
-            if (digitalRead(colPins[col]) == HIGH) {  // 키가 눌렸는지 확인
-                delay(50);  // 디바운싱
-                if (digitalRead(colPins[col]) == HIGH) {  // 안정된 상태 확인
-                    keyPressed = keys[row][col];  // 눌린 키 값
-                    while (digitalRead(colPins[col]) == HIGH);  // 키가 떼어질 때까지 대기
-                    delay(50);  // 안정화 대기
-                    digitalWrite(rowPins[row], LOW);  // 행 비활성화
-                    return keyPressed;  // 키 반환
-                }
-            }
+    uint16_t chord = keypadKeyMask('H') | keypadKeyMask('E');
+    KeyEvent ev;
+
+    screenFlush();  // 키를 기다리기 전에 그려 둔 화면을 내보냄 (바뀐 것이 없으면 아무것도 하지 않음)
+    STAGE_BEGIN(STAGE_KEY_SCAN);
+    vendMetricsPoll();  // 통계 덤프 요청 처리
+    gpioProfPoll();     // -DGPIO_PROFILE: 키를 기다리는 동안 온 Ctrl+C, USR2 처리
+    while (keypadNextEvent(&ev, KEY_WAIT_MS)) {
+        vendMetricCountAdd(CNT_DEBOUNCE_REJECT, keypadTakeRejects());
+        vendMetricCountAdd(CNT_KEY_GHOST, keypadTakeGhosts());
+        if ((ev.held & chord) == chord) homeEnterChord = 1;
+
+        if (ev.type == KEY_CHORD) {
+            if (ev.key != ADMIN_CHORD) continue;
+            screenPrintf("\n관리자 모드 진입 조건 충족. 두 키를 떼세요.\n");
+            screenFlush();
+            adminChordPending = 1;
+            break;
+        } else if (ev.type == KEY_LONG) {
+            continue;
+        } else if (ev.key == 'H' || ev.key == 'E') {
+            // 관리자 모드 조합일 수 있으므로 H/E 는 뗄 때 일반 키로 넘긴다
+            if (ev.type != KEY_RELEASE) continue;
+            int wasChord = homeEnterChord;
+            if ((ev.held & chord) == 0) homeEnterChord = 0;
+            if (wasChord) continue;
+        } else if (ev.type != KEY_PRESS) {
+            continue;
         }
-        digitalWrite(rowPins[row], LOW);  // 행 비활성화
+
+        vendMetricKeyPress(ev.timeUs);
+        STAGE_END(STAGE_KEY_SCAN);
+        vendMetricKeyReturned();
+        return ev.key;  // 키 반환
     }
+    vendMetricCountAdd(CNT_DEBOUNCE_REJECT, keypadTakeRejects());
+    vendMetricCountAdd(CNT_KEY_GHOST, keypadTakeGhosts());
+    STAGE_DROP(STAGE_KEY_SCAN);
     return '\0';  // 키 입력이 없으면 NULL 반환
 }
 
-// 키패드 핀 모드 설정 함수
+// 키패드 핀 모드 설정 함수 (행은 HIGH 로 대기, 열은 풀다운 입력 + 인터럽트)
 void setupKeypadPins() {
-    // 행 핀을 출력으로 설정
-    for (int i = 0; i < 4; i++) {
-        pinMode(rowPins[i], OUTPUT);
-        digitalWrite(rowPins[i], LOW); // 초기 상태 LOW
-    }
-
-    // 열 핀을 입력으로 설정 (Pull-down 저항 활성화)
-    for (int i = 0; i < 4; i++) {
-        pinMode(colPins[i], INPUT);
-        pullUpDnControl(colPins[i], PUD_DOWN); // 풀다운 저항
-    }
+    keypadAddChord(ADMIN_CHORD, "HE", 1500);
+    keypadBegin(rowPins, colPins, keys);  // 스캐너 스레드 시작
 }
 
-//관리자 모드 진입 확인
+//관리자 모드 진입 확인 (막히지 않음)
+// 조합은 키패드가 판정하므로 readKeypad 가 받아 둔 조합 이벤트가 있는지만 본다
 int isHomeAndEnterLongPressed() {
-    int duration = 0;
-    int hPressed = 0, ePressed = 0;
-
-    // 두 키를 1.5초 동안 동시에 눌렀는지 확인
-    while (1) {
-        hPressed = 0;
-        ePressed = 0;
-
-        // 키 상태 확인
-        for (int row = 0; row < 4; row++) {
-            digitalWrite(rowPins[row], HIGH);
-            delayMicroseconds(100);
-
-            for (int col = 0; col < 4; col++) {
-                if (digitalRead(colPins[col]) == HIGH) {
-                    char currentKey = keys[row][col];
-                    if (currentKey == 'H') hPressed = 1;
-                    if (currentKey == 'E') ePressed = 1;
-                }
-            }
-            digitalWrite(rowPins[row], LOW);
-        }
-
-        if (hPressed && ePressed) {
-            delay(100);  // 디바운싱
-            duration += 100;
-
-            if (duration >= 1500) {
-                printf("\n관리자 모드 진입 조건 충족. 두 키를 떼세요.\n");
-                fflush(stdout);
-
-                // 키가 눌린 상태가 끝나길 기다림
-                while (hPressed || ePressed) {
-                    hPressed = 0;
-                    ePressed = 0;
-
-                    for (int row = 0; row < 4; row++) {
-                        digitalWrite(rowPins[row], HIGH);
-                        delayMicroseconds(100);
-
-                        for (int col = 0; col < 4; col++) {
-                            if (digitalRead(colPins[col]) == HIGH) {
-                                char currentKey = keys[row][col];
-                                if (currentKey == 'H') hPressed = 1;
-                                if (currentKey == 'E') ePressed = 1;
-                            }
-                        }
-                        digitalWrite(rowPins[row], LOW);
-                    }
-                    delay(50);  // 안정화 대기
-                }
-
-                printf("\n관리자 모드로 진입합니다.\n");
-                fflush(stdout);
-                return 1;
-            }
-        } else {
-            duration = 0;  // 키가 하나라도 떼어진 경우 초기화
-        }
-
-        if (!hPressed && !ePressed) break;
-    }
-    return 0;
+    if (!adminChordPending) return 0;
+    adminChordPending = 0;
+    screenPrintf("\n관리자 모드로 진입합니다.\n");
+    screenFlush();
+    return 1;
 }
 
-
 //3. 음료 관련
 // 음료 데이터 초기화 함수
 void initializeDrinks(Drink drinks[]) {
@@ -407,39 +424,45 @@ void selectDrink(Drink drinks[]) {
     int drinkNumber = 0;    // 선택된 음료 번호
 
     while (1) {
+        STAGE_BEGIN(STAGE_RENDER);
         clearScreen();
         int startIdx = currentPage * drinksPerPage;
         int endIdx = startIdx + drinksPerPage - 1;
         if (endIdx >= totalDrinks) endIdx = totalDrinks - 1;
 
-        printf("\n음료 목록 (페이지 %d):\n", currentPage + 1);
+        screenPrintf("\n음료 목록 (페이지 %d):\n", currentPage + 1);
         for (int i = startIdx; i <= endIdx; i++) {
-            printf("%d. %s %s\n", i + 1, drinks[i].name, (drinks[i].isSoldOut ? "(품절)" : ""));
+            screenPrintf("%d. %s %s\n", i + 1, drinks[i].name, (drinks[i].isSoldOut ? "(품절)" : ""));
         }
-        printf("\n음료 번호 입력 (D: 다음 페이지, H: 홈): ");
-        fflush(stdout);
+        screenPrintf("\n음료 번호 입력 (D: 다음 페이지, H: 홈): ");
+        screenFlush();
+        STAGE_END(STAGE_RENDER);
 
         drinkNumber = 0;  // 초기화
         while (1) {
             char key = readKeypad();
             if (key >= '0' && key <= '9') {
                 drinkNumber = drinkNumber * 10 + (key - '0');
-                printf("%c", key);
-                fflush(stdout);
+                vendMetricKeyEcho();
+                screenPrintf("%c", key);
+                screenFlush();
             } else if (key == 'E') {
-                printf("\n디버깅: 입력된 음료 번호 = %d\n", drinkNumber);
+                screenPrintf("\n디버깅: 입력된 음료 번호 = %d\n", drinkNumber);
                 if (drinkNumber >= startIdx + 1 && drinkNumber <= endIdx + 1) {
                     if (drinks[drinkNumber - 1].isSoldOut) {
-                        printf("\n선택한 음료는 품절입니다. 다른 음료를 선택하세요.\n");
+                        screenPrintf("\n선택한 음료는 품절입니다. 다른 음료를 선택하세요.\n");
+                        screenFlush();
+                        playPrompt(VOICE_SOLD_OUT);  // "품절입니다"
                         delay(2000);
                     } else {
                         clearScreen();
-                        printf("선택된 음료: %s\n", drinks[drinkNumber - 1].name);
+                        screenPrintf("선택된 음료: %s\n", drinks[drinkNumber - 1].name);
                         paymentSystem(&drinks[drinkNumber - 1], drinks);
                         return;
                     }
                 } else {
-                    printf("\n잘못된 입력입니다. 현재 페이지의 음료를 선택해주세요.\n");
+                    screenPrintf("\n잘못된 입력입니다. 현재 페이지의 음료를 선택해주세요.\n");
+                    screenFlush();
                     delay(2000);
                 }
                 break;
@@ -447,7 +470,8 @@ void selectDrink(Drink drinks[]) {
                 currentPage = (currentPage + 1) % ((totalDrinks + drinksPerPage - 1) / drinksPerPage);
                 break;
             } else if (key == 'H') {
-                printf("홈 화면으로 돌아갑니다.\n");
+                screenPrintf("홈 화면으로 돌아갑니다.\n");
+                screenFlush();
                 delay(2000);
                 return;
             }
@@ -478,16 +502,16 @@ void manageDrinkStock(Drink drinks[]) {
         if (endIdx >= totalDrinks) endIdx = totalDrinks - 1;
 
         // 현재 음료 목록과 재고 상태 출력
-        printf("=== 음료 재고 관리 === (페이지 %d)\n\n", currentPage + 1);
+        screenPrintf("=== 음료 재고 관리 === (페이지 %d)\n\n", currentPage + 1);
         for (int i = startIdx; i <= endIdx; i++) {
-            printf("%d. %s - 재고: %d개 %s\n", 
+            screenPrintf("%d. %s - 재고: %d개 %s\n", 
                 i + 1, 
                 drinks[i].name, 
                 drinks[i].stock, 
                 (drinks[i].isSoldOut ? "(품절)" : ""));
         }
-        printf("\n입고할 음료 번호를 입력하세요 (D: 다음 페이지, H: 홈 버튼): ");
-        fflush(stdout);
+        screenPrintf("\n입고할 음료 번호를 입력하세요 (D: 다음 페이지, H: 홈 버튼): ");
+        screenFlush();
 
         char key;
         drinkNumber = 0;  // 초기화
@@ -495,8 +519,9 @@ void manageDrinkStock(Drink drinks[]) {
             key = readKeypad();
             if (key >= '0' && key <= '9') {
                 drinkNumber = drinkNumber * 10 + (key - '0');
-                printf("%c", key);
-                fflush(stdout);
+                vendMetricKeyEcho();
+                screenPrintf("%c", key);
+                screenFlush();
             } else if (key == 'E') {  // 엔터 입력 시 확인
                 if (drinkNumber >= 1 && drinkNumber <= totalDrinks) {
                     if (drinkNumber - 1 >= startIdx && drinkNumber - 1 <= endIdx) {
@@ -504,28 +529,28 @@ void manageDrinkStock(Drink drinks[]) {
                         drinks[drinkNumber - 1].stock += 10;
                         drinks[drinkNumber - 1].isSoldOut = 0;  // 품절 해제
                         moveCursor(7 + drinkNumber - startIdx, 1);  // 음료 위치로 이동
-                        printf("\033[K");  // 기존 메시지 삭제
+                        screenPrintf("\033[K");  // 기존 메시지 삭제
                         moveCursor(10,1);
-                        printf("%d. %s - 재고: %d개 %s\n", 
+                        screenPrintf("%d. %s - 재고: %d개 %s\n", 
                             drinkNumber, 
                             drinks[drinkNumber - 1].name, 
                             drinks[drinkNumber - 1].stock, 
                             (drinks[drinkNumber - 1].isSoldOut ? "(품절)" : ""));
-                        fflush(stdout);
+                        screenFlush();
                         delay(2000);
                         break;
                     } else {
                         // 선택된 음료가 현재 페이지 범위를 벗어남
                         moveCursor(11, 1);
-                        printf("잘못된 음료 번호입니다. 현재 페이지에서 선택해주세요.\n");
-                        fflush(stdout);
+                        screenPrintf("잘못된 음료 번호입니다. 현재 페이지에서 선택해주세요.\n");
+                        screenFlush();
                         delay(2000);
                         break;
                     }
                 } else {
                     moveCursor(11, 1);
-                    printf("잘못된 음료 번호입니다. 다시 입력하세요.\n");
-                    fflush(stdout);
+                    screenPrintf("잘못된 음료 번호입니다. 다시 입력하세요.\n");
+                    screenFlush();
                     delay(2000);
                     break;
                 }
@@ -536,7 +561,8 @@ void manageDrinkStock(Drink drinks[]) {
                 }
                 break;  // 페이지 전환
             } else if (key == 'H') {  // 홈 버튼 입력 시 관리자 메뉴로 돌아감
-                printf("\n관리자 메뉴로 돌아갑니다.\n");
+                screenPrintf("\n관리자 메뉴로 돌아갑니다.\n");
+                screenFlush();
                 delay(2000);
                 return;
             }
@@ -555,37 +581,32 @@ void cashPaymentSystem(Drink* selectedDrink, Drink drinks[]) {
     int inputIndex = 0;
     int prevState = 2;  // 현재 상태를 현금 결제 시스템으로 설정
 
-    // 초기 메시지 출력
-    Message initialMsg = {1, 1, ""};
-    snprintf(initialMsg.message, sizeof(initialMsg.message), "선택된 음료: %s", selectedDrink->name);
-    printMessageStruct(initialMsg);
+    // 초기 메시지 출력 (숫자 줄은 이후 숫자가 바뀔 때만 숫자 자리부터 고쳐서 다시 출력)
+    UiLine nameLine, priceLine, receivedLine, changeLine, inputLine;
+    UI_LINE(&nameLine, 1, 1, "선택된 음료: ", "");
+    uiLineSetText(&nameLine, selectedDrink->name);
+    printLine(&nameLine);
 
-    Message priceMsg = {2, 1, ""};
-    snprintf(priceMsg.message, sizeof(priceMsg.message), "음료 가격: %d원", selectedDrink->price);
-    printMessageStruct(priceMsg);
+    UI_LINE(&priceLine, 2, 1, "음료 가격: ", "원");
+    printNumber(&priceLine, selectedDrink->price);
 
-    Message receivedMsg = {3, 1, "받은 금액: 0원"};
-    printMessageStruct(receivedMsg);
+    UI_LINE(&receivedLine, 3, 1, "받은 금액: ", "원");
+    printNumber(&receivedLine, 0);
 
-    Message changeMsg = {4, 1, ""};
-    snprintf(changeMsg.message, sizeof(changeMsg.message), "거스름돈: %d원", change);
-    printMessageStruct(changeMsg);
+    UI_LINE(&changeLine, 4, 1, "거스름돈: ", "원");
+    printNumber(&changeLine, change);
 
-    Message inputPrompt = {6, 1, "현금을 입력하세요 (100원 단위, 최대 5자리): "};
-    printMessageStruct(inputPrompt);
+    printMessage(MSG_CASH_PROMPT);
+    UI_LINE(&inputLine, 6, 45, "", "");  // 프롬프트 뒤 입력 숫자 자리
 
-    // 버저 핀 초기화
-    pinMode(BUZZER_PIN, OUTPUT);
-
-    // 모터 핀 초기화
-    int servoPin = selectedDrink->servoPin;
-    pinMode(servoPin, OUTPUT);
-    softPwmCreate(servoPin, 0, 200);  // 서보 모터 PWM 설정
+    int servoPin = selectedDrink->servoPin;  // 서보 채널은 main 에서 만들어 둔다 (servoBegin)
+    static ActTimeline sale;  // 거래의 구동기 타임라인 (돌아가기 전에 끝날 때까지 기다린다)
 
     while (1) {
         // 관리자 모드 진입 체크
         if (isHomeAndEnterLongPressed()) {
-            printf("\n관리자 모드로 진입합니다.\n");
+            screenPrintf("\n관리자 모드로 진입합니다.\n");
+            screenFlush();
             delay(2000);
             enterAdminMode(drinks, &prevState);  // 현재 상태 전달
             return;
@@ -604,68 +625,54 @@ void cashPaymentSystem(Drink* selectedDrink, Drink drinks[]) {
 
                 playInputSound(); // 입력 소리
 
-                // 받은 금액 및 거스름돈 갱신
-                snprintf(receivedMsg.message, sizeof(receivedMsg.message), "받은 금액: %d원", receivedAmount);
-                printMessageStruct(receivedMsg);
-
-                snprintf(changeMsg.message, sizeof(changeMsg.message), "거스름돈: %d원", change);
-                printMessageStruct(changeMsg);
+                // 받은 금액 및 거스름돈 갱신 (바뀐 줄만)
+                printNumber(&receivedLine, receivedAmount);
+                printNumber(&changeLine, change);
             }
         } else if (key == 'D') {  // 마지막 입력 삭제
             if (inputIndex > 0) {
                 inputBuffer[--inputIndex] = '\0';  // 입력 버퍼에서 마지막 문자 제거
 
-                // 입력 영역 초기화
-                moveCursor(6, 1);  // "현금을 입력하세요..." 줄 위치로 이동
-                printf("현금을 입력하세요 (100원 단위, 최대 5자리):     ");  // 초기화된 메시지 출력
-                fflush(stdout);
-
-                // 현재 입력값 출력
-                if (inputIndex > 0) {
-                    moveCursor(6, 45);  // 숫자를 출력할 위치로 이동
-                    printf("%s", inputBuffer);
-                } else {
-                    moveCursor(6, 45);  // 입력값 없는 경우 빈 칸으로 초기화
-                    printf("     ");
-                }
-                fflush(stdout);
+                // 입력 영역: 프롬프트 뒤 숫자 자리만 지우고 현재 입력값 출력
+                uiLineSetText(&inputLine, inputBuffer);
+                printLine(&inputLine);
 
                 // 받은 금액 및 거스름돈 계산
                 receivedAmount = (inputIndex > 0) ? atoi(inputBuffer) : 0;
                 change = receivedAmount - selectedDrink->price;
 
-                // 받은 금액 및 거스름돈 메시지 업데이트
-                snprintf(receivedMsg.message, sizeof(receivedMsg.message), "받은 금액: %d원", receivedAmount);
-                printMessageStruct(receivedMsg);
-
-                snprintf(changeMsg.message, sizeof(changeMsg.message), "거스름돈: %d원", change);
-                printMessageStruct(changeMsg);
+                // 받은 금액 및 거스름돈 메시지 업데이트 (바뀐 줄만)
+                printNumber(&receivedLine, receivedAmount);
+                printNumber(&changeLine, change);
             }
         } else if (key == 'E') {  // Enter 키 처리
-            // 금액 입력 후 정방향 회전
-            MotorControl(50, FORWARD);
-            delay(1000);  // 모터가 동작하는 동안 대기
-            MotorStop();
+            STAGE_BEGIN(STAGE_PAYMENT);
+            uint32_t paymentStartUs = micros();
+            // 금액 입력 후 정방향 회전 (지폐 투입). 결과에 따라 반환/배출 단계를 같은 타임라인에 더한다
+            actInit(&sale);
+            int intake = actMotor(&sale, FORWARD, 1000, -1);
 
             if (receivedAmount >= selectedDrink->price) {
                 change = receivedAmount - selectedDrink->price;
 
                 if (change > machineBalance) {
+                    STAGE_END(STAGE_PAYMENT);
+                    vendMetricCount(CNT_CASH_NO_CHANGE);
+                    // 반대 방향으로 회전 (지폐 반환), 메시지와 소리는 모터가 도는 동안
+                    actMotor(&sale, REVERSE, 1000, intake);
+                    actStart(&sale);
+                    uint32_t shownMs = millis();
+
                     // 잔돈 부족 메시지 출력 및 초기화
-                    Message errorMsg = {8, 1, "거스름돈이 부족합니다. 잔고를 충전해주세요."};
-                    printMessageStruct(errorMsg);
+                    printMessage(MSG_NO_CHANGE);
                     playFailureSound(); // 실패 소리
 
-                    // 반대 방향으로 회전
-                    MotorControl(50, REVERSE);
-                    delay(1000);
-                    MotorStop();
-
-                    delay(1500);
+                    screenFlush();  // 구동기가 도는 동안 메시지가 보이도록
+                    actWait(&sale);
+                    holdMessage(shownMs, 1500);
 
                     // 메시지 초기화
-                    snprintf(errorMsg.message, sizeof(errorMsg.message), "");
-                    printMessageStruct(errorMsg);
+                    printMessage(MSG_CLEAR);
 
                     memset(inputBuffer, 0, sizeof(inputBuffer));
                     inputIndex = 0;
@@ -673,55 +680,58 @@ void cashPaymentSystem(Drink* selectedDrink, Drink drinks[]) {
                     change = -selectedDrink->price;
 
                     // 받은 금액 및 거스름돈 초기화
-                    snprintf(receivedMsg.message, sizeof(receivedMsg.message), "받은 금액: 0원");
-                    printMessageStruct(receivedMsg);
-
-                    snprintf(changeMsg.message, sizeof(changeMsg.message), "거스름돈: %d원", change);
-                    printMessageStruct(changeMsg);
+                    printNumber(&receivedLine, receivedAmount);
+                    printNumber(&changeLine, change);
 
                     continue;
                 }
 
-                // 결제 성공 메시지 출력
-                Message successMsg = {8, 1, "결제가 완료되었습니다! 음료를 제공 중입니다."};
-                printMessageStruct(successMsg);
-                playSuccessSound(); // 성공 소리
-
-                // 서보 모터 동작
-                if (servoPin > 0) {
-                    softPwmWrite(servoPin, 5); // 서보모터 동작
-                    delay(2000);
-                    softPwmWrite(servoPin, 15); // 원래 위치로 복귀
-                }
+                STAGE_END(STAGE_PAYMENT);
+                vendMetricCount(CNT_CASH_OK);
 
-                // 잔돈 반환 로직
+                // 서보 모터 동작과 잔돈 반환은 지폐 투입이 끝나면 같이 (서보와 모터는 다른 자원)
+                STAGE_BEGIN(STAGE_DISPENSE);
+                servoStroke(&sale, servoPin, intake);  // 밀기 → 2초 → 복귀
                 if (change > 0) {
-                    MotorControl(50, REVERSE);  // 잔돈 반환
-                    delay(1000);
-                    MotorStop();
+                    actMotor(&sale, REVERSE, 1000, intake);  // 잔돈 반환
                 }
+                actStart(&sale);
+                uint32_t shownMs = millis();
+
+                // 결제 성공 메시지 출력
+                printMessage(MSG_CASH_PAID);
+                playSuccessSound(); // 성공 소리
 
-                // 재고 업데이트
+                // 재고 업데이트 (구동기가 움직이는 동안)
+                STAGE_BEGIN(STAGE_STOCK);
                 updateDrinkStock(selectedDrink);
                 machineBalance -= change;               // 잔돈 차감
-                delay(2000);
+                STAGE_END(STAGE_STOCK);
+
+                screenFlush();
+                actWait(&sale);
+                STAGE_END(STAGE_DISPENSE);
+                vendMetricRecord(HIST_PAY_DISPENSE, micros() - paymentStartUs);
+                holdMessage(shownMs, 2000);
                 return;
             } else {
-                // 금액 부족 메시지 출력 및 초기화
-                Message insufficientMsg = {8, 1, "금액이 부족합니다. 다시 입력해주세요."};
-                printMessageStruct(insufficientMsg);
-                playFailureSound(); // 실패 소리
+                STAGE_END(STAGE_PAYMENT);
+                vendMetricCount(CNT_CASH_SHORT);
+                // 반대 방향으로 회전 (지폐 반환), 메시지와 안내는 모터가 도는 동안
+                actMotor(&sale, REVERSE, 1000, intake);
+                actStart(&sale);
+                uint32_t shownMs = millis();
 
-                // 반대 방향으로 회전
-                MotorControl(50, REVERSE);
-                delay(1000);
-                MotorStop();
+                // 금액 부족 메시지 출력 및 초기화
+                printMessage(MSG_SHORT);
+                playPrompt(VOICE_SHORT); // "금액이 부족합니다"
 
-                delay(1500);
+                screenFlush();
+                actWait(&sale);
+                holdMessage(shownMs, 1500);
 
                 // 메시지 초기화
-                snprintf(insufficientMsg.message, sizeof(insufficientMsg.message), "");
-                printMessageStruct(insufficientMsg);
+                printMessage(MSG_CLEAR);
 
                 memset(inputBuffer, 0, sizeof(inputBuffer));
                 inputIndex = 0;
@@ -729,20 +739,16 @@ void cashPaymentSystem(Drink* selectedDrink, Drink drinks[]) {
                 change = -selectedDrink->price;
 
                 // 받은 금액 및 거스름돈 초기화
-                snprintf(receivedMsg.message, sizeof(receivedMsg.message), "받은 금액: 0원");
-                printMessageStruct(receivedMsg);
-
-                snprintf(changeMsg.message, sizeof(changeMsg.message), "거스름돈: %d원", change);
-                printMessageStruct(changeMsg);
+                printNumber(&receivedLine, receivedAmount);
+                printNumber(&changeLine, change);
             }
         } else if (key == 'H') {  // 홈 버튼 처리
-            Message homeMsg = {8, 1, "홈 화면으로 돌아갑니다."};
-            printMessageStruct(homeMsg);
+            printMessage(MSG_HOME);
+            screenFlush();
             delay(2000);
 
             // 메시지 초기화
-            snprintf(homeMsg.message, sizeof(homeMsg.message), "");
-            printMessageStruct(homeMsg);
+            printMessage(MSG_CLEAR);
 
             return;
         }
@@ -752,26 +758,29 @@ void cashPaymentSystem(Drink* selectedDrink, Drink drinks[]) {
 
 // Python 스크립트를 실행하는 함수
 int executeRFIDScript() {
+#ifdef SIM_BOARD
+    return simRfidRead();  // 시뮬레이션 보드: 스크립트로 지정한 카드 인식 결과
+#endif
     int ret = system("python3 cardread.py");  // Python 스크립트 실행
     if (ret != 0) {
-        printf("RFID 태그 읽기 실패: Python 스크립트 오류.\n");
+        screenPrintf("RFID 태그 읽기 실패: Python 스크립트 오류.\n");
         return 0;  // 실패 반환
     }
 
     // Python 스크립트가 정상 실행된 경우 RFID 데이터를 확인
     FILE* file = fopen("rfid_data.txt", "r");
     if (file == NULL) {
-        printf("Error: rfid_data.txt 파일을 열 수 없습니다.\n");
+        screenPrintf("Error: rfid_data.txt 파일을 열 수 없습니다.\n");
         return 0;
     }
 
     char id[20];
     if (fgets(id, sizeof(id), file) != NULL) {
-        printf("RFID 태그 ID: %s\n", id);
+        screenPrintf("RFID 태그 ID: %s\n", id);
         fclose(file);
         return 1;  // 성공 반환
     } else {
-        printf("파일에서 RFID ID를 읽을 수 없습니다.\n");
+        screenPrintf("파일에서 RFID ID를 읽을 수 없습니다.\n");
         fclose(file);
         return 0;  // 실패 반환
     }
@@ -780,52 +789,57 @@ int executeRFIDScript() {
 // 카드 결제 로직 함수
 void cardPaymentSystem(Drink* selectedDrink) {
     clearScreen();
-    Message rfidMsg = {1, 1, "카드를 리더기에 대주세요..."};  // 카드 리더 메시지
-    printMessageStruct(rfidMsg);
-
-    // 서보 모터 초기화
-    int servoPin = selectedDrink->servoPin; // 선택된 음료의 서보 핀
-    pinMode(servoPin, OUTPUT);
-    softPwmCreate(servoPin, 0, 200); // 선택된 서보 모터 PWM 설정
+    printMessage(MSG_CARD_WAIT);  // 카드 리더 메시지
 
     // **카드 인식 대기 소리 (삐빅)**
-    playBuzzer(1000, 100); // 1000Hz, 100ms
-    delay(50);            // 200ms 대기
-    playBuzzer(1000, 100); // 두 번째 삐빅
+    playPrompt(VOICE_CARD); // 1000Hz 100ms, 쉼 50ms, 1000Hz 100ms
 
     // RFID 태그 읽기 시도
+    STAGE_BEGIN(STAGE_PAYMENT);
+    uint32_t paymentStartUs = micros();
+    screenFlush();  // 카드를 읽는 동안 안내가 보이도록
     int cardReadSuccess = executeRFIDScript();
+    STAGE_END(STAGE_PAYMENT);
+    vendMetricCount(cardReadSuccess ? CNT_CARD_OK : CNT_CARD_FAIL);
 
     if (cardReadSuccess) {
+        // 서보 모터 동작 (메시지, 소리, 재고 갱신은 서보가 움직이는 동안)
+        static ActTimeline sale;
+        STAGE_BEGIN(STAGE_DISPENSE);
+        actInit(&sale);
+        servoStroke(&sale, selectedDrink->servoPin, -1);  // 밀기 → 2초 → 복귀
+        actStart(&sale);
+        uint32_t shownMs = millis();
+
         // 결제 성공
-        Message successMsg = {9, 1, "카드 결제가 완료되었습니다."};
-        printMessageStruct(successMsg);
+        printMessage(MSG_CARD_PAID);
 
 
         // **결제 완료 소리**
         playSuccessSound(); // 1500Hz, 200ms
 
-        // 서보 모터 동작
-        if (selectedDrink->servoPin > 0) {
-            softPwmWrite(selectedDrink->servoPin, 5); // 서보모터 동작
-            delay(2000);
-            softPwmWrite(selectedDrink->servoPin, 15); // 원래 위치로 복귀
-        } else {
-            printf("\n서보모터 동작이 필요하지 않은 음료입니다.\n");
+        if (selectedDrink->servoPin <= 0) {
+            screenPrintf("\n서보모터 동작이 필요하지 않은 음료입니다.\n");
         }
 
         // 재고 업데이트
+        STAGE_BEGIN(STAGE_STOCK);
         updateDrinkStock(selectedDrink);
+        STAGE_END(STAGE_STOCK);
 
-        delay(3000);  // 3초 대기
+        screenFlush();
+        actWait(&sale);
+        STAGE_END(STAGE_DISPENSE);
+        vendMetricRecord(HIST_PAY_DISPENSE, micros() - paymentStartUs);
+        holdMessage(shownMs, 3000);  // 3초 대기 (배출 시간 포함)
         } else {
 
         // **결제 실패 소리**
         playFailureSound(); // 실패 소리 (500Hz, 300ms)
 
         // 결제 실패
-        Message failMsg = {9, 1, "카드 결제가 실패했습니다. 다시 시도해주세요."};
-        printMessageStruct(failMsg);
+        printMessage(MSG_CARD_FAILED);
+        screenFlush();
         delay(3000);  // 3초 대기
     }
 }
@@ -836,29 +850,28 @@ void paymentSystem(Drink* selectedDrink, Drink drinks[]) {
 
         // 관리자 모드 진입 체크
         if (isHomeAndEnterLongPressed()) {
-            printf("\n관리자 모드로 진입합니다.\n");
+            screenPrintf("\n관리자 모드로 진입합니다.\n");
+            screenFlush();
             delay(2000);
             enterAdminMode(drinks, &prevState);  // 현재 상태 전달
             return;
         }
 
         clearScreen(); // 화면 초기화
-        Message paymentChoiceMsg = {1, 1, "결제 방식을 선택하세요:\n1. 현금 결제\n2. 카드 결제"};
-        printMessageStruct(paymentChoiceMsg);
-        fflush(stdout);
+        printMessage(MSG_PAY_CHOICE);
 
         char key = '\0';
-        while (key == '\0') {
+        while (key == '\0' && !adminChordPending) {
             key = readKeypad();
         }
+        if (key == '\0') continue;  // 관리자 모드 조합 (반복문 처음에서 진입)
 
         if (key == '1') {
             // 현금 결제
             if (machineBalance < selectedDrink->price) {
                 // 잔고 부족 시 메시지 출력
-                Message cashMsg = {5, 1, "현금 결제 불가: 자판기 잔고 부족\n"};
-                printMessageStruct(cashMsg);
-                fflush(stdout);
+                printMessage(MSG_NO_CASH);
+                screenFlush();
                 delay(2000); // 메시지를 사용자에게 보여주기 위해 대기
                 return; // 현금 결제 종료
             } else {
@@ -871,13 +884,13 @@ void paymentSystem(Drink* selectedDrink, Drink drinks[]) {
             break;  // 결제 완료 후 루프 탈출
         } else if (key == 'H') {
             // 홈으로 돌아가기
-            Message homeMsg = {9, 1, "홈 화면으로 돌아갑니다."};
-            printMessageStruct(homeMsg);
+            printMessage(MSG_PAY_HOME);
+            screenFlush();
             delay(3000);  // 3초 대기
             return;
         } else {
-            Message invalidChoiceMsg = {9, 1, "잘못된 선택입니다. 다시 시도하세요."};
-            printMessageStruct(invalidChoiceMsg);
+            printMessage(MSG_PAY_INVALID);
+            screenFlush();
             delay(2000); // 잘못된 선택 대기
         }
     }
@@ -891,24 +904,27 @@ void enterAdminMode(Drink drinks[], int* prevState) {
     int inputIndex = 0;
 
     clearScreen();
-    printf("관리자 모드 진입\n비밀번호를 입력하세요: ");
-    fflush(stdout);
+    screenPrintf("관리자 모드 진입\n비밀번호를 입력하세요: ");
+    screenFlush();
 
     while (1) {
         char key = readKeypad();
 
         if (key >= '0' && key <= '9' && inputIndex < 4) {
             inputPassword[inputIndex++] = key;
-            printf("*"); // 비밀번호 입력 표시
-            fflush(stdout);
+            vendMetricKeyEcho();
+            screenPrintf("*"); // 비밀번호 입력 표시
+            screenFlush();
         } else if (key == 'E') {  // 엔터 입력
             inputPassword[inputIndex] = '\0';
             if (strcmp(inputPassword, ADMIN_PASSWORD) == 0) {
-                printf("\n비밀번호 확인 완료. 관리자 모드로 진입합니다.\n");
+                screenPrintf("\n비밀번호 확인 완료. 관리자 모드로 진입합니다.\n");
+                screenFlush();
                 delay(2000);
 
                 // 관리자 메뉴 호출
                 adminMenu(drinks);
+                adminChordPending = 0;  // 관리자 모드 안에서 누른 조합은 무시
 
                 // 관리자 모드 종료 후 이전 상태로 복귀
                 if (*prevState == 1) {
@@ -921,21 +937,24 @@ void enterAdminMode(Drink drinks[], int* prevState) {
                 return;
             } else {
                 // 비밀번호 틀렸을 때 처리
-                printf("\n비밀번호가 틀렸습니다. 다시 시도하세요.\n");
+                screenPrintf("\n비밀번호가 틀렸습니다. 다시 시도하세요.\n");
+                screenFlush();
                 delay(1500);
 
                 // 메시지 및 입력 초기화
                 moveCursor(1, 1); // 화면 상단으로 이동
-                printf("\033[J"); // 화면 지우기 (현재 줄 아래 모두 삭제)
-                printf("관리자 모드 진입\n비밀번호를 입력하세요: ");
-                fflush(stdout);
+                screenPrintf("\033[J"); // 화면 지우기 (현재 줄 아래 모두 삭제)
+                screenPrintf("관리자 모드 진입\n비밀번호를 입력하세요: ");
+                screenFlush();
 
                 // 입력값 초기화
                 inputIndex = 0;
                 memset(inputPassword, 0, sizeof(inputPassword));
             }
         } else if (key == 'H') {  // 홈 버튼으로 관리자 모드 종료
-            printf("\n관리자 모드를 종료합니다.\n");
+            adminChordPending = 0;
+            screenPrintf("\n관리자 모드를 종료합니다.\n");
+            screenFlush();
             delay(2000);
 
             // 이전 상태로 복귀
@@ -953,12 +972,12 @@ void enterAdminMode(Drink drinks[], int* prevState) {
 void adminMenu(Drink drinks[]) {
     while (1) {
         clearScreen();
-        printf("=== 관리자 모드 ===\n");
-        printf("1. 잔고 채우기\n");
-        printf("2. 음료 재고 관리\n");
-        printf("H. 관리자 모드 종료\n");
-        printf("선택: ");
-        fflush(stdout);
+        screenPrintf("=== 관리자 모드 ===\n");
+        screenPrintf("1. 잔고 채우기\n");
+        screenPrintf("2. 음료 재고 관리\n");
+        screenPrintf("H. 관리자 모드 종료\n");
+        screenPrintf("선택: ");
+        screenFlush();
 
         char key = '\0';
         while (key == '\0') {  // 입력이 있을 때까지 대기
@@ -970,11 +989,13 @@ void adminMenu(Drink drinks[]) {
         } else if (key == '2') {
             manageDrinkStock(drinks);  // 음료 관리 함수 호출
         } else if (key == 'H') {
-            printf("관리자 모드를 종료합니다.\n");
+            screenPrintf("관리자 모드를 종료합니다.\n");
+            screenFlush();
             delay(2000);
             return;
         } else {
-            printf("잘못된 입력입니다. 다시 선택해주세요.\n");
+            screenPrintf("잘못된 입력입니다. 다시 선택해주세요.\n");
+            screenFlush();
             delay(2000);
         }
     }
@@ -987,44 +1008,46 @@ void addMachineBalance() {
     int inputIndex = 0;
 
     clearScreen();
-    printf("현재 잔고: %d원\n", machineBalance);
-    printf("충전할 금액을 입력하세요 (100원 단위): ");
-    fflush(stdout);
+    screenPrintf("현재 잔고: %d원\n", machineBalance);
+    screenPrintf("충전할 금액을 입력하세요 (100원 단위): ");
+    screenFlush();
 
     while (1) {
         char key = readKeypad();
 
         if (key >= '0' && key <= '9' && inputIndex < 5) {
             inputBuffer[inputIndex++] = key;
-            printf("%c", key);
-            fflush(stdout);
+            vendMetricKeyEcho();
+            screenPrintf("%c", key);
+            screenFlush();
         } else if (key == 'E') {  // 엔터 입력
             inputAmount = atoi(inputBuffer);
             if (inputAmount % 100 == 0 && inputAmount > 0) {
                 machineBalance += inputAmount;
                 moveCursor(3, 1);  // 결과 출력 위치
-                printf("잔고가 %d원으로 충전되었습니다.\n", machineBalance);
-                fflush(stdout);
+                screenPrintf("잔고가 %d원으로 충전되었습니다.\n", machineBalance);
+                screenFlush();
                 delay(2000);
                 return;
             } else {
                 // 메시지 및 입력 초기화
                 moveCursor(3, 1);  // "충전할 금액을 입력하세요" 아래로 이동
-                printf("\033[J");  // 현재 커서 아래 모든 내용 삭제
-                printf("올바르지 않은 금액입니다. 100원 단위로 다시 입력해주세요.\n");
-                fflush(stdout);
+                screenPrintf("\033[J");  // 현재 커서 아래 모든 내용 삭제
+                screenPrintf("올바르지 않은 금액입니다. 100원 단위로 다시 입력해주세요.\n");
+                screenFlush();
                 delay(2000);
 
                 // 입력 초기화
                 moveCursor(2, 1);  // 다시 입력 위치로 이동
-                printf("\033[J");  // 메시지 초기화
-                printf("충전할 금액을 입력하세요 (100원 단위): ");
-                fflush(stdout);
+                screenPrintf("\033[J");  // 메시지 초기화
+                screenPrintf("충전할 금액을 입력하세요 (100원 단위): ");
+                screenFlush();
                 memset(inputBuffer, 0, sizeof(inputBuffer));
                 inputIndex = 0;
             }
         } else if (key == 'H') {
-            printf("\n관리자 메뉴로 돌아갑니다.\n");
+            screenPrintf("\n관리자 메뉴로 돌아갑니다.\n");
+            screenFlush();
             delay(2000);
             return;
         }
@@ -1036,8 +1059,9 @@ void addMachineBalance() {
 // 음료 추천 로직 함수
 void recommendDrink(Drink drinks[], int isCold, int caffeine, int mood, int taste) {
     while (1) {
+        STAGE_BEGIN(STAGE_RENDER);
         clearScreen();
-        printf("추천 음료 목록:\n");
+        screenPrintf("추천 음료 목록:\n");
         int count = 0;
         int indices[40];  // 추천 음료의 원래 인덱스를 저장할 배열
 
@@ -1048,42 +1072,47 @@ void recommendDrink(Drink drinks[], int isCold, int caffeine, int mood, int tast
                 (taste == 3 || drinks[i].taste == taste) &&
                 drinks[i].stock > 0) {
                 indices[count++] = i;
-                printf("%d. %s (가격: %d원, 재고: %d개)\n",
+                screenPrintf("%d. %s (가격: %d원, 재고: %d개)\n",
                     count, drinks[i].name, drinks[i].price, drinks[i].stock);
             }
         }
 
         if (count == 0) {
-            printf("조건에 맞는 음료가 없습니다.\n");
+            screenPrintf("조건에 맞는 음료가 없습니다.\n");
+            STAGE_END(STAGE_RENDER);
+            screenFlush();
             delay(3000);
             return;
         }
 
-        printf("\n음료 번호를 입력하세요. (H: 홈으로 돌아가기): ");
-        fflush(stdout);
+        screenPrintf("\n음료 번호를 입력하세요. (H: 홈으로 돌아가기): ");
+        screenFlush();
+        STAGE_END(STAGE_RENDER);
 
         int drinkNumber = 0;
         while (1) {
             char key = readKeypad();
             if (key >= '0' && key <= '9') {
                 drinkNumber = drinkNumber * 10 + (key - '0');
-                printf("%c", key);
-                fflush(stdout);
+                vendMetricKeyEcho();
+                screenPrintf("%c", key);
+                screenFlush();
             } else if (key == 'E') {
                 if (drinkNumber >= 1 && drinkNumber <= count) {
                     int selectedIndex = indices[drinkNumber - 1];
                     clearScreen();
-                    printf("선택된 음료: %s\n", drinks[selectedIndex].name);
+                    screenPrintf("선택된 음료: %s\n", drinks[selectedIndex].name);
                     paymentSystem(&drinks[selectedIndex], drinks);
                     return;
                 } else {
-                    printf("\n잘못된 음료 번호입니다.\n");
+                    screenPrintf("\n잘못된 음료 번호입니다.\n");
+                    screenFlush();
                     delay(2000);
                     break;
                 }
             } else if (key == 'H') {
                 clearScreen();
-                printf("홈 화면으로 돌아갑니다.\n");
+                screenPrintf("홈 화면으로 돌아갑니다.\n");
                 return;
             }
         }
@@ -1100,11 +1129,11 @@ void handleDrinkRecommendation(Drink drinks[]) {
 
             // 1. 기분 상태 선택
             clearScreen();
-            printf("기분 상태를 선택하세요:\n");
-            printf("1. 상쾌한 기분\n");
-            printf("2. 평온한 기분\n");
-            printf("3. 피곤한 상태\n");
-            fflush(stdout);
+            screenPrintf("기분 상태를 선택하세요:\n");
+            screenPrintf("1. 상쾌한 기분\n");
+            screenPrintf("2. 평온한 기분\n");
+            screenPrintf("3. 피곤한 상태\n");
+            screenFlush();
 
             int mood = 0;
             while (1) {  // 기분 선택 루프
@@ -1113,18 +1142,18 @@ void handleDrinkRecommendation(Drink drinks[]) {
                     mood = moodKey - '0';
                     break;
                 } else if (moodKey != '\0') {
-                    printf("잘못된 입력입니다. 1, 2, 3 중에서 선택해주세요.\n");
-                    fflush(stdout);
+                    screenPrintf("잘못된 입력입니다. 1, 2, 3 중에서 선택해주세요.\n");
+                    screenFlush();
                 }
             }
 
             // 2. 맛 선호도 선택
             clearScreen();
-            printf("맛 선호도를 선택하세요:\n");
-            printf("1. 달콤한 맛\n");
-            printf("2. 쓴 맛\n");
-            printf("3. 상관없음\n");
-            fflush(stdout);
+            screenPrintf("맛 선호도를 선택하세요:\n");
+            screenPrintf("1. 달콤한 맛\n");
+            screenPrintf("2. 쓴 맛\n");
+            screenPrintf("3. 상관없음\n");
+            screenFlush();
 
             int taste = 0;
             while (1) {  // 맛 선택 루프
@@ -1133,8 +1162,8 @@ void handleDrinkRecommendation(Drink drinks[]) {
                     taste = tasteKey - '0';
                     break;
                 } else if (tasteKey != '\0') {
-                    printf("잘못된 입력입니다. 1, 2, 3 중에서 선택해주세요.\n");
-                    fflush(stdout);
+                    screenPrintf("잘못된 입력입니다. 1, 2, 3 중에서 선택해주세요.\n");
+                    screenFlush();
                 }
             }
 
@@ -1147,22 +1176,25 @@ void handleDrinkRecommendation(Drink drinks[]) {
             }
 
             // CDS 센서 값 읽기
+            uint32_t cdsStartUs = micros();
             wiringPiI2CWrite(fd, 0x00);  // AIN0 채널 선택
             wiringPiI2CRead(fd);         // 첫 번째 더미 읽기
             int cdsValue = wiringPiI2CRead(fd);  // 실제 데이터 읽기
+            vendMetricRecord(HIST_CDS_READ, micros() - cdsStartUs);
 
             // 낮/밤 판별 메시지 출력
             int caffeine = 0;  // 카페인 포함 여부
             clearScreen();
             if (cdsValue > 100) {  // 값이 높으면 빛이 약한 상태
-                printf("CDS 센서 값: %d\n", cdsValue);
-                printf("편안한 밤입니다. 카페인이 없는 음료를 추천합니다!\n");
+                screenPrintf("CDS 센서 값: %d\n", cdsValue);
+                screenPrintf("편안한 밤입니다. 카페인이 없는 음료를 추천합니다!\n");
                 caffeine = 0;  // 밤에는 카페인 없는 음료
             } else {
-                printf("CDS 센서 값: %d\n", cdsValue);
-                printf("활동량이 많은 낮이네요! 카페인이 들어있는 음료를 추천합니다!\n");
+                screenPrintf("CDS 센서 값: %d\n", cdsValue);
+                screenPrintf("활동량이 많은 낮이네요! 카페인이 들어있는 음료를 추천합니다!\n");
                 caffeine = 1;  // 낮에는 카페인 포함 음료
             }
+            screenFlush();
             delay(2000);  // 2초 대기
 
             // 4. 음료 추천 호출
@@ -1170,11 +1202,11 @@ void handleDrinkRecommendation(Drink drinks[]) {
             break;
         } else if (key == 'H') {  // 홈 버튼 입력
             clearScreen();
-            printf("홈 화면으로 돌아갑니다.\n");
+            screenPrintf("홈 화면으로 돌아갑니다.\n");
             return;
         } else if (key != '\0') {
-            printf("잘못된 입력입니다. 1 또는 2를 선택해주세요.\n");
-            fflush(stdout);
+            screenPrintf("잘못된 입력입니다. 1 또는 2를 선택해주세요.\n");
+            screenFlush();
         }
     }
 }
@@ -1189,6 +1221,7 @@ void read_dht11_dat(Drink drinks[]) {
     dht11_dat[0] = dht11_dat[1] = dht11_dat[2] = dht11_dat[3] = dht11_dat[4] = 0;
 
     // 센서에 시작 신호 보내기
+    uint32_t dhtStartUs = micros();
     pinMode(DHTPIN, OUTPUT);
     digitalWrite(DHTPIN, LOW);
     delay(18);
@@ -1216,27 +1249,31 @@ void read_dht11_dat(Drink drinks[]) {
         }
     }
 
+    vendMetricRecord(HIST_DHT_READ, micros() - dhtStartUs);
+
     // 데이터 유효성 검사 및 출력
     if ((j >= 40) && (dht11_dat[4] == ((dht11_dat[0] + dht11_dat[1] + dht11_dat[2] + dht11_dat[3]) & 0xff))) {
+        vendMetricCount(CNT_DHT_OK);
         int temp = dht11_dat[2];
-        printf("지금의 습도는 %d.%d%%, 온도는 %d.%d°C네요!\n", dht11_dat[0], dht11_dat[1], dht11_dat[2], dht11_dat[3]);
+        screenPrintf("지금의 습도는 %d.%d%%, 온도는 %d.%d°C네요!\n", dht11_dat[0], dht11_dat[1], dht11_dat[2], dht11_dat[3]);
         
 
         // 온도에 따른 안내 메시지 출력
         if (temp >= 25 && temp <= 35) {
-            printf("날씨가 더운데 시원한 음료를 드시려면 1번\n 뜨거운 음료를 드시려면 2번을 눌러주세요.\n1번 시원한 음료 / 2번 뜨거운 음료");
+            screenPrintf("날씨가 더운데 시원한 음료를 드시려면 1번\n 뜨거운 음료를 드시려면 2번을 눌러주세요.\n1번 시원한 음료 / 2번 뜨거운 음료");
         } else if (temp >= 10 && temp < 25) {
-            printf("선선한 가을 날씨네요! 차가운 음료는 1번\n 뜨거운 음료는 2번을 눌러주세요.\n1번 시원한 음료 / 2번 뜨거운 음료");
+            screenPrintf("선선한 가을 날씨네요! 차가운 음료는 1번\n 뜨거운 음료는 2번을 눌러주세요.\n1번 시원한 음료 / 2번 뜨거운 음료");
         } else if (temp >= 0 && temp < 10) {
-            printf("조금 쌀쌀한 날씨에요! 뜨거운 음료는 1번\n 차가운 음료는 2번을 눌러주세요.\n1번 시원한 음료 / 2번 뜨거운 음료");
+            screenPrintf("조금 쌀쌀한 날씨에요! 뜨거운 음료는 1번\n 차가운 음료는 2번을 눌러주세요.\n1번 시원한 음료 / 2번 뜨거운 음료");
         } else if (temp >= -20 && temp < 0) {
-            printf("날씨가 너무 춥네요! 뜨거운 음료는 1번\n 차가운 음료는 2번을 눌러주세요.\n1번 시원한 음료 / 2번 뜨거운 음료");
+            screenPrintf("날씨가 너무 춥네요! 뜨거운 음료는 1번\n 차가운 음료는 2번을 눌러주세요.\n1번 시원한 음료 / 2번 뜨거운 음료");
         }
 
-        fflush(stdout);
+        screenFlush();
         handleDrinkRecommendation(drinks);  // 사용자 선택 처리
     } else {
-        printf("온습도 데이터를 읽는 데 실패했습니다. 다시 시도해주세요.\n");
+        vendMetricCount(j >= 40 ? CNT_DHT_CHECKSUM : CNT_DHT_SHORT);
+        screenPrintf("온습도 데이터를 읽는 데 실패했습니다. 다시 시도해주세요.\n");
     }
 }
 
@@ -1246,7 +1283,7 @@ void read_dht11_dat(Drink drinks[]) {
 //7. 하드웨어 제어 관련
 
 void setupMotorPins() {
-    pinMode(MOTOR_PWM_PIN, OUTPUT);
+    pwmOutOpen(&motorPwm, "모터", MOTOR_PWM_PIN, MOTOR_PWM_HZ, MOTOR_PWM_MAX_HZ, MOTOR_SOFT_RANGE);
     pinMode(MOTOR_MT_P_PIN, OUTPUT);
     pinMode(MOTOR_MT_N_PIN, OUTPUT);
 
@@ -1256,8 +1293,7 @@ void setupMotorPins() {
 
 //모터 제어 함수(Stop, StopGradual, rotateMotor)
 void MotorStop() {
-    softPwmWrite(MOTOR_PWM_PIN, 0);  // PWM 신호 끄기
-    softPwmStop(MOTOR_PWM_PIN);
+    pwmOutWritePercent(&motorPwm, 0);  // PWM 신호 끄기 (채널은 그대로 둔다)
     digitalWrite(MOTOR_MT_N_PIN, LOW); // 음극 핀 LOW
     digitalWrite(MOTOR_MT_P_PIN, LOW); // 양극 핀 LOW
 }
@@ -1266,7 +1302,7 @@ void MotorStop() {
 // 점진적으로 모터를 멈추는 함수
 void MotorStopGradual() {
     for (int speed = 100; speed >= 0; speed -= 10) { // 속도를 점진적으로 줄임
-        softPwmWrite(MOTOR_PWM_PIN, speed);
+        pwmOutWritePercent(&motorPwm, (unsigned int)speed);
         delay(500); // 100ms 간격으로 감소
     }
     MotorStop(); // 완전히 멈춤
@@ -1274,7 +1310,7 @@ void MotorStopGradual() {
 
 
 void MotorControl(unsigned char speed, unsigned char rotate) {
-    softPwmWrite(MOTOR_PWM_PIN, speed);  // PWM 속도 설정
+    pwmOutWritePercent(&motorPwm, speed);  // PWM 속도 설정 (%)
 
     if (rotate == FORWARD) {
         digitalWrite(MOTOR_MT_P_PIN, HIGH);
@@ -1287,51 +1323,64 @@ void MotorControl(unsigned char speed, unsigned char rotate) {
     }
 }
 
+// 타임라인 단계 (actuator.h): arg 는 회전 방향, 끝나면 정지
+static void motorStepStart(int rotate) {
+    MotorControl(50, (unsigned char)rotate);
+}
 
-// 특정 주파수와 지속 시간으로 버저를 울리는 함수
-void playBuzzer(int frequency, int duration) {
-    int period = 1000000 / frequency; // 주파수의 주기 (마이크로초)
-    int halfPeriod = period / 2; // 반주기 (HIGH와 LOW의 길이)
+static void motorStepStop(int rotate) {
+    (void)rotate;
+    MotorStop();
+}
 
-    for (int i = 0; i < (duration * 1000) / period; i++) {
-        digitalWrite(BUZZER_PIN, HIGH);
-        delayMicroseconds(halfPeriod);
-        digitalWrite(BUZZER_PIN, LOW);
-        delayMicroseconds(halfPeriod);
-    }
+// 타임라인 t 에 after 단계 뒤에 모터를 ms 동안 돌리는 단계를 더한다 (모터 자원을 잡는다)
+int actMotor(ActTimeline* t, unsigned char rotate, unsigned int ms, int after) {
+    return actAdd(t, motorStepStart, motorStepStop, rotate, ms, ACT_LOCK_MOTOR, after);
 }
 
-// 입력 소리
+
+// 입력 소리 (재생 스레드에 넘기고 바로 돌아온다, voice.h / buzzer.h)
 void playInputSound() {
-    playBuzzer(1000, 100); // 1000Hz, 100ms
+    playPrompt(VOICE_INPUT); // 1000Hz, 100ms
 }
 
-// 성공 소리
+// 성공 안내 ("결제가 완료되었습니다", 음성 파일이 없으면 1500Hz, 200ms)
 void playSuccessSound() {
-    playBuzzer(1500, 200); // 1500Hz, 200ms
+    playPrompt(VOICE_PAID);
 }
 
-// 실패 소리
+// 실패 안내 ("결제에 실패했습니다", 음성 파일이 없으면 500Hz, 300ms)
 void playFailureSound() {
-    playBuzzer(500, 300); // 500Hz, 300ms
+    playPrompt(VOICE_FAILED);
+}
+
+// 음성 안내 (voiceBegin 을 하지 않았으면 같은 상황의 버저 소리)
+void playPrompt(int prompt) {
+    voiceSay(prompt);
 }
 
-//main 함수
+//main 함수 (벤치마크 등에서 이 파일을 포함할 때는 VENDING_NO_MAIN 정의)
+#ifndef VENDING_NO_MAIN
 int main() {
     if (wiringPiSetupGpio() == -1) {
-        printf("GPIO 초기화 실패\n");
+        screenPrintf("GPIO 초기화 실패\n");
         return 1;
     }
+    vendMetricsInit();  // SIGUSR1 로 통계 덤프
 
     // 키패드 핀 설정
     setupKeypadPins();
 
+    // 음성이 PWM 채널 0 을 37.5kHz 로 먼저 잡아야 모터(채널 1)가 같은 설정으로 하드웨어 PWM 을 받는다
+    if (voiceBegin(BUZZER_PIN, NULL) != 0) buzzerBegin(BUZZER_PIN);  // 음성 안내 스레드, 안 되면 버저 재생 스레드
     setupMotorPins();
 
 
     // 음료 초기화
     Drink drinks[40];
     initializeDrinks(drinks);
+    for (int i = 0; i < 40; i++) servoAttach(drinks[i].servoPin);  // 같은 핀은 채널 하나
+    servoBegin();
 
     // 자판기 잔고 초기화
     machineBalance = 100000;
@@ -1341,29 +1390,30 @@ int main() {
     while (1) {
         clearScreen();  // 화면 초기화
         displayMainMenu();  // 초기 메뉴 화면 표시
-        fflush(stdout);
+        screenFlush();
 
         // 관리자 모드 진입 체크
-        // printf("디버깅: 관리자 모드 진입 체크 중...\n");
+        // screenPrintf("디버깅: 관리자 모드 진입 체크 중...\n");
         if (isHomeAndEnterLongPressed()) {
             prevState = 0;  // 초기 상태로 설정
-            fflush(stdout);
+            screenFlush();
             enterAdminMode(drinks, &prevState);  // 관리자 모드로 진입
             continue;  // 관리자 모드 종료 후 메인 루프로 복귀
         }
 
         // 잔고 확인 및 경고 메시지 출력
         if (machineBalance < 10000) {
-            printf("현금결제X\n");
-            fflush(stdout);
+            screenPrintf("현금결제X\n");
+            screenFlush();
             delay(1000);  // 사용자에게 메시지 보여주기 위한 딜레이
         }
 
         // 사용자 입력 대기
         char key = '\0';
-        while (key == '\0') {
+        while (key == '\0' && !adminChordPending) {
             key = readKeypad();  // 키패드 입력 읽기
         }
+        if (key == '\0') continue;  // 관리자 모드 조합 (반복문 처음에서 진입)
 
         // 사용자 입력 처리
         if (key == '1') {
@@ -1375,11 +1425,12 @@ int main() {
         } 
         else {
             moveCursor(5, 1);
-            printf("잘못된 입력입니다. 1 또는 2를 선택해주세요.");
-            fflush(stdout);
+            screenPrintf("잘못된 입력입니다. 1 또는 2를 선택해주세요.");
+            screenFlush();
             delay(2000);
         }
     }
     return 0;
 }
+#endif
 
@@ -0,0 +1,258 @@
+// 구동기 타임라인 스케줄러 (Final.c 의 지폐 투입, 음료 배출, 잔돈 반환)
+//
+// 예전 현금 결제는 모두 차례로 했다: 투입 모터 1초 → 서보 2초 → 잔돈 모터 1초 → 2초 대기 (약 6초).
+// 타임라인은 단계 (시작 함수, 길이, 끝 함수) 를 모은 것이고, 단계마다
+//   after: 먼저 끝나야 하는 단계 (-1: 바로)
+//   locks: 단계 동안 잡는 자원 (ACT_LOCK_MOTOR, ACT_LOCK_SERVO(n)). 같은 자원을 잡는 단계는 겹치지 않는다.
+// 를 정한다. 소리는 자원을 잡지 않으므로 언제든 울린다 (voice.h, buzzer.h).
+// actStart 는 타임라인을 스케줄러 스레드(piThreadCreate, 프로그램에 하나)에 넘기고 바로 돌아온다.
+// 스케줄러 스레드는 조건이 맞는 단계를 모두 시작하고 가장 먼저 끝나는 단계의 시각까지 잔다.
+// 그래서 거래 시간은 구동기 시간의 합이 아니라 가장 긴 경로가 된다.
+// 다른 타임라인이 잡은 자원은 풀릴 때까지 기다리므로 (같은 서보의 배출 두 번) 넘긴 순서대로 이어서 한다.
+//
+// actBegin 전에 act.serial 을 1 로 두면 예전처럼 부른 쪽에서 단계를 차례로 (단계 순서대로, 하나씩 끝날 때까지)
+// 실행한다 (비교 측정용, bench_vending.c 의 ACT=serial).
+// 시뮬레이션 보드에서는 스케줄러 스레드가 delay 에서 다른 스레드와 번갈아 실행된다.
+#ifndef ACTUATOR_H
+#define ACTUATOR_H
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <wiringPi.h>
+#ifndef SIM_BOARD
+#include <errno.h>
+#include <semaphore.h>
+#include "deadline.h"
+#endif
+
+#define ACT_MAX_STEPS      8
+#define ACT_MAX_TIMELINES  8
+#define ACT_PRIORITY       10    // 버저 재생 스레드(buzzer.h) 보다 낮게
+#define ACT_IDLE_MS        5     // 시뮬레이션 보드에서 새 타임라인을 다시 확인하는 간격 (진행 중에는 1ms)
+
+#define ACT_LOCK_MOTOR     (1u << 0)
+#define ACT_LOCK_SERVO(n)  (1u << (1 + (n)))  // 서보 채널 n (servo.h)
+
+#define ACT_WAITING        0
+#define ACT_RUNNING        1
+#define ACT_DONE           2
+
+typedef void (*ActFn)(int arg);
+
+typedef struct {
+    ActFn start;          // 단계를 시작할 때 (NULL: 기다리기만)
+    ActFn finish;         // 단계가 끝날 때 (NULL: 없음)
+    int arg;              // start, finish 에 넘기는 값
+    unsigned int ms;
+    unsigned int locks;
+    int after;
+} ActStep;
+
+typedef struct {
+    ActStep steps[ACT_MAX_STEPS];
+    int count;
+    // 스케줄러 스레드만 쓴다
+    unsigned char state[ACT_MAX_STEPS];
+    unsigned int until[ACT_MAX_STEPS];
+    atomic_int done;      // 모든 단계가 끝났다 (actStart 전에는 1)
+    unsigned int startMs, endMs;
+} ActTimeline;
+
+typedef struct {
+    int started, serial;  // serial: 스케줄러 없이 부른 쪽에서 실행 (스레드를 만들지 못했을 때도)
+    _Atomic(ActTimeline*) slots[ACT_MAX_TIMELINES];
+    unsigned int held;    // 잡혀 있는 자원 (스케줄러 스레드만 쓴다)
+    atomic_ulong timelines, steps, lockWaits;  // 끝난 타임라인, 끝난 단계, 자원 때문에 늦게 시작한 단계
+} ActScheduler;
+
+static ActScheduler act;
+#ifndef SIM_BOARD
+static sem_t actSem;      // actStart -> 스케줄러 스레드
+static sem_t actDoneSem;  // 스케줄러 스레드 -> actWait
+#endif
+
+//1. 타임라인 만들기
+static inline void actInit(ActTimeline* t) {
+    t->count = 0;
+    atomic_store(&t->done, 1);
+}
+
+// 단계를 더하고 번호를 돌려준다 (자리가 없으면 -1, after 가 -1 인 단계를 만들면 그 뒤는 바로 시작한다)
+static inline int actAdd(ActTimeline* t, ActFn start, ActFn finish, int arg, unsigned int ms, unsigned int locks,
+                         int after) {
+    if (t->count == ACT_MAX_STEPS) {
+        fprintf(stderr, "타임라인 단계가 모자랍니다\n");
+        return -1;
+    }
+    ActStep* s = &t->steps[t->count];
+    s->start = start;
+    s->finish = finish;
+    s->arg = arg;
+    s->ms = ms;
+    s->locks = locks;
+    s->after = (after >= 0 && after < t->count) ? after : -1;  // 앞 단계만 (순환 없음)
+    return t->count++;
+}
+
+//2. 스케줄러 스레드
+// 타임라인 하나를 지금 시각까지 진행한다. 상태가 바뀌었으면 1
+static int actAdvance(ActTimeline* t, unsigned int now) {
+    int changed = 0;
+    for (int i = 0; i < t->count; i++) {
+        ActStep* s = &t->steps[i];
+        if (t->state[i] != ACT_RUNNING || (int)(t->until[i] - now) > 0) continue;
+        if (s->finish) s->finish(s->arg);
+        t->state[i] = ACT_DONE;
+        act.held &= ~s->locks;
+        atomic_fetch_add(&act.steps, 1);
+        changed = 1;
+    }
+    for (int i = 0; i < t->count; i++) {
+        ActStep* s = &t->steps[i];
+        if (t->state[i] != ACT_WAITING) continue;
+        if (s->after >= 0 && t->state[s->after] != ACT_DONE) continue;
+        if (act.held & s->locks) {
+            if (t->until[i] == 0) {  // 자원 때문에 늦은 단계는 한 번만 센다
+                atomic_fetch_add(&act.lockWaits, 1);
+                t->until[i] = 1;
+            }
+            continue;
+        }
+        act.held |= s->locks;
+        if (s->start) s->start(s->arg);
+        t->state[i] = ACT_RUNNING;
+        t->until[i] = now + s->ms;
+        changed = 1;
+    }
+    return changed;
+}
+
+// 끝난 타임라인을 내보내고 다음 단계까지 남은 ms (진행 중인 단계가 없으면 -1)
+static int actPoll(void) {
+    unsigned int now = millis();
+    int changed = 1;
+    while (changed) {  // 끝난 단계가 푼 자원으로 다른 단계를 바로 시작한다 (길이 0 인 단계 포함)
+        changed = 0;
+        for (int k = 0; k < ACT_MAX_TIMELINES; k++) {
+            ActTimeline* t = atomic_load(&act.slots[k]);
+            if (t != NULL) changed |= actAdvance(t, now);
+        }
+    }
+    int wait = -1;
+    for (int k = 0; k < ACT_MAX_TIMELINES; k++) {
+        ActTimeline* t = atomic_load(&act.slots[k]);
+        if (t == NULL) continue;
+        int running = 0;
+        for (int i = 0; i < t->count; i++) {
+            if (t->state[i] == ACT_DONE) continue;
+            running = 1;
+            if (t->state[i] == ACT_RUNNING) {
+                int l = (int)(t->until[i] - now);
+                if (wait < 0 || l < wait) wait = l < 0 ? 0 : l;
+            }
+        }
+        if (!running) {
+            t->endMs = now;
+            atomic_store(&act.slots[k], NULL);
+            atomic_store(&t->done, 1);
+            atomic_fetch_add(&act.timelines, 1);
+#ifndef SIM_BOARD
+            sem_post(&actDoneSem);
+#endif
+        }
+    }
+    return wait;
+}
+
+static PI_THREAD(actScheduler) {
+    piHiPri(ACT_PRIORITY);
+    while (1) {
+        int wait = actPoll();
+#ifdef SIM_BOARD
+        delay(wait < 0 ? ACT_IDLE_MS : 1);
+#else
+        if (wait < 0) {
+            sem_wait(&actSem);
+        } else if (wait > 0) {
+            struct timespec ts;
+            deadlineAfterMs(&ts, (unsigned int)wait);
+            while (sem_timedwait(&actSem, &ts) == -1 && errno == EINTR) {
+            }
+        }
+#endif
+    }
+    return NULL;
+}
+
+// 스케줄러 스레드를 시작한다. act.serial 이면 시작하지 않는다 (actStart 가 부른 쪽에서 실행)
+static inline int actBegin(void) {
+    if (act.started || act.serial) return 0;
+#ifndef SIM_BOARD
+    sem_init(&actSem, 0, 0);
+    sem_init(&actDoneSem, 0, 0);
+#endif
+    if (piThreadCreate(actScheduler) != 0) {
+        fprintf(stderr, "구동기 스케줄러 스레드 생성 실패, 단계를 차례로 실행합니다\n");
+        act.serial = 1;
+        return -1;
+    }
+    act.started = 1;
+    return 0;
+}
+
+//3. 실행
+// 부른 쪽에서 단계를 순서대로 하나씩 (act.serial)
+static void actRunSerial(ActTimeline* t) {
+    t->startMs = millis();
+    for (int i = 0; i < t->count; i++) {
+        ActStep* s = &t->steps[i];
+        if (s->start) s->start(s->arg);
+        if (s->ms) delay(s->ms);
+        if (s->finish) s->finish(s->arg);
+        atomic_fetch_add(&act.steps, 1);
+    }
+    t->endMs = millis();
+    atomic_fetch_add(&act.timelines, 1);
+}
+
+// 타임라인을 넘기고 바로 돌아온다 (act.serial 이면 끝날 때까지 실행한다).
+// t 는 끝날 때까지 (actWait, actDone) 그대로 있어야 한다
+static inline void actStart(ActTimeline* t) {
+    memset(t->state, ACT_WAITING, sizeof(t->state));
+    memset(t->until, 0, sizeof(t->until));
+    t->startMs = millis();
+    if (act.started) {
+        atomic_store(&t->done, 0);
+        for (int k = 0; k < ACT_MAX_TIMELINES; k++) {
+            ActTimeline* empty = NULL;
+            if (atomic_compare_exchange_strong(&act.slots[k], &empty, t)) {
+#ifndef SIM_BOARD
+                sem_post(&actSem);
+#endif
+                return;
+            }
+        }
+        fprintf(stderr, "타임라인 자리가 모자랍니다, 차례로 실행합니다\n");
+    }
+    actRunSerial(t);
+    atomic_store(&t->done, 1);
+}
+
+// 타임라인이 끝났으면 1
+static inline int actDone(ActTimeline* t) {
+    return atomic_load(&t->done);
+}
+
+// 타임라인이 끝날 때까지 기다린다
+static inline void actWait(ActTimeline* t) {
+    while (!actDone(t)) {
+#ifdef SIM_BOARD
+        delay(1);
+#else
+        sem_wait(&actDoneSem);  // 다른 타임라인이 끝나도 깨므로 다시 확인한다
+#endif
+    }
+}
+
+#endif
@@ -0,0 +1,276 @@
+// 자판기 거래 벤치마크
+// 시뮬레이션 보드에서 정해진 키 입력 세션을 반복 실행하고
+// 초당 거래 수와 단계별 지연(p50/p99)을 출력한다.
+//
+// 빌드 및 실행 (저장소 최상위에서):
+//   gcc -O2 -Isim/include "recommendation vending machine/bench_vending.c" sim/sim_board.c -lm -o bench_vending
+//   ./bench_vending [세션별 반복 횟수]
+//
+// 가상 시간(ms): 손님이 실제로 기다리는 시간 (delay 포함)
+// 실제 시간(us): 이 PC에서 코드 경로를 실행하는 데 든 CPU 비용
+// SIM_CLOCK=real 로 실행하면 실제 시계로 측정한다 (매우 느림).
+// TERM_SCREEN=1 로 실행하면 화면 출력을 셀 비교 렌더러로 보내고 출력량을 비교할 수 있다 (기본: 그대로 출력).
+// BUZZER=block 으로 실행하면 예전처럼 소리가 끝날 때까지 기다린다 (기본: 재생 스레드, buzzer.h).
+// 소리는 Final.c 와 같이 음성 안내(voice.h)로 울린다. VOICE=off 로 실행하면 buzzer.h 로 울린다.
+// PWM=soft 로 실행하면 모터와 서보를 softPwm 으로 돌린다 (기본: 남은 하드웨어 PWM 채널, pwm_alloc.h).
+// ACT=serial 로 실행하면 예전처럼 투입 모터, 배출, 잔돈 모터를 차례로 돌린다 (기본: 타임라인 스케줄러, actuator.h).
+#define VENDING_NO_MAIN
+#define VEND_STAGE_HOOK
+#include "Final.c"
+
+#include <time.h>
+#include <unistd.h>
+
+typedef struct {
+    uint64_t simNs;   // 가상 시간
+    uint64_t wallNs;  // 실제 시간
+} Sample;
+
+typedef struct {
+    Sample* items;
+    int count, cap;
+} SampleList;
+
+static const char* stageNames[STAGE_COUNT] = {
+    "키 스캔", "화면 출력", "결제 판단", "음료 배출", "재고 갱신"
+};
+
+static SampleList stageSamples[STAGE_COUNT];
+static Sample stageStart[STAGE_COUNT];
+static int stageOpen[STAGE_COUNT];
+static int benchDone = 0;
+
+static uint64_t wallNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void addSample(SampleList* list, Sample s) {
+    if (list->count == list->cap) {
+        list->cap = list->cap ? list->cap * 2 : 1024;
+        list->items = realloc(list->items, (size_t)list->cap * sizeof(Sample));
+        if (list->items == NULL) {
+            fprintf(stderr, "메모리 부족\n");
+            exit(1);
+        }
+    }
+    list->items[list->count++] = s;
+}
+
+void vendStageBegin(int stage) {
+    stageStart[stage].simNs = simNowNs();
+    stageStart[stage].wallNs = wallNow();
+    stageOpen[stage] = 1;
+}
+
+void vendStageEnd(int stage) {
+    if (!stageOpen[stage]) return;
+    Sample s = { simNowNs() - stageStart[stage].simNs, wallNow() - stageStart[stage].wallNs };
+    addSample(&stageSamples[stage], s);
+    stageOpen[stage] = 0;
+}
+
+void vendStageDrop(int stage) {
+    stageOpen[stage] = 0;
+}
+
+// 벤치마크 세션: 키 입력 스크립트와 시작 화면
+typedef struct {
+    const char* name;
+    const char* keys;
+    void (*run)(Drink drinks[]);
+} BenchSession;
+
+static void runSelect(Drink drinks[]) {
+    selectDrink(drinks);
+}
+
+static void runRecommend(Drink drinks[]) {
+    read_dht11_dat(drinks);
+}
+
+static const BenchSession sessions[] = {
+    { "현금 결제 (7번, 2000원)",     "D7E 1 2000E",      runSelect },
+    { "현금 부족 후 재입력",         "D7E 1 500E 2000E", runSelect },
+    { "추천 경로 (온습도→CDS→카드)", "113 1E 2",         runRecommend },
+};
+
+#define SESSION_COUNT ((int)(sizeof(sessions) / sizeof(sessions[0])))
+
+static int compareSim(const void* a, const void* b) {
+    uint64_t x = ((const Sample*)a)->simNs, y = ((const Sample*)b)->simNs;
+    return (x > y) - (x < y);
+}
+
+static int compareWall(const void* a, const void* b) {
+    uint64_t x = ((const Sample*)a)->wallNs, y = ((const Sample*)b)->wallNs;
+    return (x > y) - (x < y);
+}
+
+// p: 0~100 백분위 (nearest-rank)
+static Sample percentile(SampleList* list, double p) {
+    Sample result = { 0, 0 };
+    if (list->count == 0) return result;
+    int rank = (int)(p / 100.0 * list->count + 0.999999) - 1;
+    if (rank < 0) rank = 0;
+    if (rank >= list->count) rank = list->count - 1;
+    qsort(list->items, (size_t)list->count, sizeof(Sample), compareSim);
+    result.simNs = list->items[rank].simNs;
+    qsort(list->items, (size_t)list->count, sizeof(Sample), compareWall);
+    result.wallNs = list->items[rank].wallNs;
+    return result;
+}
+
+// 한글은 화면에서 두 칸을 차지하므로 표시 폭 기준으로 왼쪽 정렬
+static void printName(FILE* out, const char* name, int width) {
+    int cols = 0;
+    for (const unsigned char* p = (const unsigned char*)name; *p; p++) {
+        if ((*p & 0xC0) == 0x80) continue;  // UTF-8 연속 바이트
+        cols += (*p >= 0xEA && *p <= 0xED) ? 2 : 1;  // 한글 음절(U+AC00~)만 두 칸
+    }
+    fprintf(out, "  %s%*s", name, cols < width ? width - cols : 0, "");
+}
+
+static void printHeader(FILE* out, const char* title) {
+    printName(out, title, 30);
+    fprintf(out, " %7s  %10s %10s  %10s %10s\n", "count",
+            "sim p50ms", "sim p99ms", "wall p50us", "wall p99us");
+}
+
+static void printRow(FILE* out, const char* name, SampleList* list) {
+    Sample p50 = percentile(list, 50);
+    Sample p99 = percentile(list, 99);
+    printName(out, name, 30);
+    fprintf(out, " %7d  %10.1f %10.1f  %10.2f %10.2f\n", list->count,
+            p50.simNs / 1e6, p99.simNs / 1e6, p50.wallNs / 1e3, p99.wallNs / 1e3);
+}
+
+// 세션이 끝나지 않고 시뮬레이션 보드가 종료한 경우
+static void checkDone(void) {
+    if (!benchDone) {
+        fprintf(stderr, "오류: 세션이 끝나지 않았습니다. 키 스크립트와 화면 흐름이 맞지 않습니다.\n");
+        _exit(1);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int iterations = (argc > 1) ? atoi(argv[1]) : 1000;
+    if (iterations <= 0) iterations = 1000;
+
+    const char* clockEnv = getenv("SIM_CLOCK");
+    if (clockEnv == NULL || strcmp(clockEnv, "real") != 0) simClockMode(SIM_CLOCK_VIRTUAL);
+    const char* pwmEnv = getenv("PWM");
+    pwmAlloc.soft = (pwmEnv && strcmp(pwmEnv, "soft") == 0);
+    const char* actEnv = getenv("ACT");
+    act.serial = (actEnv && strcmp(actEnv, "serial") == 0);
+    const char* screenEnv = getenv("TERM_SCREEN");
+    if (screenEnv && *screenEnv) screenForce = (atoi(screenEnv) != 0);
+    const char* buzzerEnv = getenv("BUZZER");
+    if (buzzerEnv && strcmp(buzzerEnv, "thread") == 0) buzzer.mode = BUZZER_THREAD;
+    if (buzzerEnv && strcmp(buzzerEnv, "block") == 0) buzzer.mode = BUZZER_BLOCK;
+    if (wiringPiSetupGpio() == -1) {
+        printf("GPIO 초기화 실패\n");
+        return 1;
+    }
+    simKeypadAttach(rowPins, colPins, keys);
+    simDht11Set(40, 0, 28, 0);
+    simPcf8591Set(0, 50);
+    simCardScript("1");
+    simSetIdleExit(60000);  // 스크립트가 끝났는데 60초(가상) 동안 세션이 안 끝나면 중단
+    atexit(checkDone);
+
+    setupKeypadPins();
+    const char* voiceEnv = getenv("VOICE");
+    int voiceOff = (voiceEnv && strcmp(voiceEnv, "off") == 0);
+    if (voiceOff || voiceBegin(BUZZER_PIN, NULL) != 0) buzzerBegin(BUZZER_PIN);
+    setupMotorPins();
+
+    Drink drinks[40];
+    initializeDrinks(drinks);
+    for (int i = 0; i < 40; i++) servoAttach(drinks[i].servoPin);
+    servoBegin();
+    fprintf(stderr, "PWM 출력\n");
+    pwmAllocReport(stderr, "  ");
+
+    // 자판기 화면 출력은 버리고 결과만 원래 표준 출력으로 보낸다
+    FILE* out = fdopen(dup(STDOUT_FILENO), "w");
+    if (out == NULL || freopen("/dev/null", "w", stdout) == NULL) {
+        fprintf(stderr, "표준 출력 전환 실패\n");
+        return 1;
+    }
+
+    fprintf(out, "자판기 거래 벤치마크 (%s 시계, 세션별 %d회)\n\n",
+            simClockIsVirtual() ? "가상" : "실제", iterations);
+    printHeader(out, "세션");
+
+    for (int s = 0; s < SESSION_COUNT; s++) {
+        SampleList total = { NULL, 0, 0 };
+        uint64_t wallStart = wallNow();
+        unsigned long bytesStart = screenBytes, writesStart = screenWrites;
+        unsigned long soundsStart = buzzer.played, preemptedStart = buzzer.preempted;
+        unsigned long saidStart = voice.said, cutStart = voice.cut, underrunStart = voice.underruns;
+        unsigned long strokesStart = 0, overlapStart = servo.overlapped;
+        unsigned long timelinesStart = act.timelines, lockWaitsStart = act.lockWaits;
+        for (int c = 0; c < servo.count; c++) strokesStart += servo.channels[c].strokes;
+
+        for (int i = 0; i < iterations; i++) {
+            initializeDrinks(drinks);
+            machineBalance = 100000;
+            keypadFlush();
+            simKeypadScript(sessions[s].keys);
+
+            Sample start = { simNowNs(), wallNow() };
+            sessions[s].run(drinks);
+            Sample t = { simNowNs() - start.simNs, wallNow() - start.wallNs };
+            addSample(&total, t);
+
+            if (simKeypadPending() != 0) {
+                fprintf(stderr, "오류: '%s' 세션이 키 스크립트를 다 쓰지 않고 끝났습니다.\n", sessions[s].name);
+                benchDone = 1;
+                return 1;
+            }
+        }
+
+        double wallSec = (wallNow() - wallStart) / 1e9;
+        while (servoBusy(0)) delay(10);  // 마지막 배출 동작까지 센다
+        unsigned long strokes = 0;
+        for (int c = 0; c < servo.count; c++) strokes += servo.channels[c].strokes;
+        printRow(out, sessions[s].name, &total);
+        printName(out, "", 30);
+        fprintf(out, " %.1f 거래/초 (실제 시간 기준)\n", iterations / wallSec);
+        printName(out, "", 30);
+        fprintf(out, " 화면 출력 %.0f 바이트/거래", (double)(screenBytes - bytesStart) / iterations);
+        if (screenMode == 1) fprintf(out, ", write %.1f회/거래", (double)(screenWrites - writesStart) / iterations);
+        fprintf(out, "\n");
+        printName(out, "", 30);
+        if (voice.started) {
+            fprintf(out, " 음성 안내 %.1f회/거래, 끝나기 전에 끊김 %.1f회/거래, 버퍼 부족 %lu회\n",
+                    (double)(voice.said - saidStart) / iterations, (double)(voice.cut - cutStart) / iterations,
+                    voice.underruns - underrunStart);
+        } else {
+            fprintf(out, " 소리 %.1f회/거래 (%s), 끝나기 전에 끊김 %.1f회/거래\n",
+                    (double)(buzzer.played - soundsStart) / iterations,
+                    buzzer.mode == BUZZER_PWM ? "PWM" : buzzer.mode == BUZZER_THREAD ? "스레드" : "기다림",
+                    (double)(buzzer.preempted - preemptedStart) / iterations);
+        }
+        printName(out, "", 30);
+        fprintf(out, " 배출 %.1f회/거래 (%s), 앞 배출 중에 넘김 %lu회, PWM 출력 열기 누적 %lu회\n",
+                (double)(strokes - strokesStart) / iterations, act.started ? "타임라인" : "차례로",
+                servo.overlapped - overlapStart, servo.creates);
+        printName(out, "", 30);
+        fprintf(out, " 구동기 타임라인 %.1f개/거래, 자원을 기다린 단계 %lu개\n\n",
+                (double)(act.timelines - timelinesStart) / iterations, act.lockWaits - lockWaitsStart);
+        free(total.items);
+    }
+
+    fprintf(out, "단계별 지연 (sim: 가상 시간, wall: 실제 시간)\n");
+    printHeader(out, "단계");
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        printRow(out, stageNames[i], &stageSamples[i]);
+    }
+    fflush(out);
+
+    benchDone = 1;
+    return 0;
+}
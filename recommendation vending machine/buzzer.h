@@ -0,0 +1,218 @@
+// 버저 재생 스레드 (Final.c 의 입력/성공/실패/카드 소리)
+//
+// 예전 playBuzzer 는 부른 쪽에서 delayMicroseconds 로 반주기마다 핀을 토글했기 때문에
+// 숫자 하나를 누를 때마다 100ms, 실패 소리는 300ms 동안 키 입력과 화면이 멈췄다.
+// buzzerPlay 는 소리를 재생 스레드(piThreadCreate)에 넘기고 바로 돌아온다.
+// 재생 중에 새 소리를 넘기면 지금 소리를 끊고 새 소리를 처음부터 울린다 (가장 최근 소리 하나만 둔다).
+//
+// 소리는 음 몇 개 (주파수, 길이) 로 정의한다. 주파수 0 은 쉼.
+// 기본으로 GPIO 18 의 하드웨어 PWM (채널 0) 으로 울리므로 음이 울리는 동안 CPU 를 쓰지 않는다.
+//   분주 BUZZER_PWM_CLOCK (19.2MHz / 32 = 600kHz) 에서 범위 = 600000 / 주파수, 값 = 범위 / 2 (듀티 50%)
+//   분주와 범위는 PWM 두 채널(GPIO 12/18, 13/19)이 함께 쓰므로 두 채널이 모두 비어 있을 때만 쓴다 (pwm_alloc.h).
+//
+// buzzerBegin 전에 buzzer.mode 로 방식을 고를 수 있다 (비교 측정용, bench_vending.c 의 BUZZER=).
+//   BUZZER_PWM   : 하드웨어 PWM (기본. PWM 을 쓸 수 없는 핀이면 BUZZER_THREAD)
+//   BUZZER_THREAD: 재생 스레드가 반주기마다 핀을 직접 토글
+//   BUZZER_BLOCK : 예전처럼 부른 쪽에서 소리가 끝날 때까지 토글하고 돌아온다
+// 시뮬레이션 보드에서는 재생 스레드가 delay 에서 다른 스레드와 번갈아 실행된다.
+#ifndef BUZZER_H
+#define BUZZER_H
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wiringPi.h>
+#include "pwm_alloc.h"
+#ifndef SIM_BOARD
+#include <errno.h>
+#include <semaphore.h>
+#include "deadline.h"
+#endif
+
+#define BUZZER_PWM         0
+#define BUZZER_THREAD      1
+#define BUZZER_BLOCK       2
+
+#define BUZZER_PWM_CLOCK   32
+#define BUZZER_PWM_BASE_HZ (19200000 / BUZZER_PWM_CLOCK)
+#define BUZZER_MAX_NOTES   4
+#define BUZZER_PRIORITY    20  // 키패드 스캐너(keypad.h) 보다 낮게
+#define BUZZER_IDLE_MS     5   // 시뮬레이션 보드에서 새 소리를 다시 확인하는 간격 (울리는 중에는 1ms)
+
+typedef struct {
+    unsigned short hz;  // 0: 쉼
+    unsigned short ms;
+} BuzzerNote;
+
+typedef struct {
+    int count;
+    BuzzerNote notes[BUZZER_MAX_NOTES];
+} BuzzerSound;
+
+static const BuzzerSound buzzerInputSound   = { 1, { { 1000, 100 } } };
+static const BuzzerSound buzzerSuccessSound = { 1, { { 1500, 200 } } };
+static const BuzzerSound buzzerFailureSound = { 1, { { 500, 300 } } };
+static const BuzzerSound buzzerCardSound    = { 3, { { 1000, 100 }, { 0, 50 }, { 1000, 100 } } };  // 삐빅
+
+typedef struct {
+    int pin, mode, started;
+    PwmOut out;                            // 하드웨어 PWM 채널 (BUZZER_PWM)
+    _Atomic(const BuzzerSound*) request;   // 재생 스레드가 아직 가져가지 않은 소리
+    atomic_int playing;
+    atomic_ulong played, preempted;        // 요청한 소리, 끝나기 전에 새 소리에 끊긴 소리
+} Buzzer;
+
+static Buzzer buzzer;
+#ifndef SIM_BOARD
+static sem_t buzzerSem;  // buzzerPlay -> 재생 스레드
+#endif
+
+//1. 음 하나 울리기
+static int buzzerPending(void) {
+    return atomic_load_explicit(&buzzer.request, memory_order_acquire) != NULL;
+}
+
+// 하드웨어 PWM 주파수 바꾸기 (0: 끄기)
+static void buzzerPwmTone(int hz) {
+    if (hz <= 0) {
+        pwmWrite(buzzer.pin, 0);
+        return;
+    }
+    unsigned int range = BUZZER_PWM_BASE_HZ / (unsigned int)hz;
+    pwmSetRange(range);
+    pwmWrite(buzzer.pin, (int)(range / 2));
+}
+
+// ms 동안 기다린다. 그 사이에 새 소리가 들어오면 1 (끊김)
+static int buzzerSleep(unsigned int ms) {
+#ifdef SIM_BOARD
+    for (unsigned int i = 0; i < ms; i++) {
+        if (buzzerPending()) return 1;
+        delay(1);
+    }
+#else
+    struct timespec ts;
+    deadlineAfterMs(&ts, ms);
+    while (!buzzerPending()) {
+        if (sem_timedwait(&buzzerSem, &ts) == -1 && errno == ETIMEDOUT) break;
+    }
+#endif
+    return buzzerPending();
+}
+
+// 반주기마다 핀을 토글한다. canStop 이면 새 소리가 들어올 때 1 (끊김)
+static int buzzerToggle(int hz, unsigned int ms, int canStop) {
+    unsigned int half = 500000 / (unsigned int)hz;
+    unsigned int start = micros(), next = start;
+    while (micros() - start < ms * 1000u) {
+        if (canStop && buzzerPending()) {
+            digitalWrite(buzzer.pin, LOW);
+            return 1;
+        }
+        digitalWrite(buzzer.pin, HIGH);
+        next += half;
+        int left = (int)(next - micros());
+        if (left > 0) delayMicroseconds((unsigned int)left);
+        digitalWrite(buzzer.pin, LOW);
+        next += half;
+        left = (int)(next - micros());
+        if (left > 0) delayMicroseconds((unsigned int)left);
+    }
+    return 0;
+}
+
+// 소리 하나를 끝까지 (또는 새 소리가 들어올 때까지) 울린다. 끊기면 1
+static int buzzerSound(const BuzzerSound* sound, int canStop) {
+    for (int i = 0; i < sound->count; i++) {
+        const BuzzerNote* note = &sound->notes[i];
+        int stopped;
+        if (note->hz == 0) {
+            if (buzzer.mode == BUZZER_PWM) buzzerPwmTone(0);
+            if (canStop) {
+                stopped = buzzerSleep(note->ms);
+            } else {
+                delay(note->ms);
+                stopped = 0;
+            }
+        } else if (buzzer.mode == BUZZER_PWM) {
+            buzzerPwmTone(note->hz);
+            stopped = buzzerSleep(note->ms);
+        } else {
+            stopped = buzzerToggle(note->hz, note->ms, canStop);
+        }
+        if (stopped) return 1;
+    }
+    if (buzzer.mode == BUZZER_PWM) buzzerPwmTone(0);
+    return 0;
+}
+
+//2. 재생 스레드
+static PI_THREAD(buzzerPlayer) {
+    piHiPri(BUZZER_PRIORITY);
+    while (1) {
+#ifdef SIM_BOARD
+        while (!buzzerPending()) delay(BUZZER_IDLE_MS);
+#else
+        while (!buzzerPending()) sem_wait(&buzzerSem);
+#endif
+        const BuzzerSound* sound = atomic_exchange_explicit(&buzzer.request, NULL, memory_order_acq_rel);
+        if (sound == NULL) continue;
+        atomic_store(&buzzer.playing, 1);
+        if (buzzerSound(sound, 1)) atomic_fetch_add(&buzzer.preempted, 1);
+        // 끊긴 소리는 핀을 끄지 않고 바로 다음 소리의 첫 음으로 넘어간다
+        if (!buzzerPending()) atomic_store(&buzzer.playing, 0);
+    }
+    return NULL;
+}
+
+// 핀을 설정하고 재생 스레드를 시작한다. 하드웨어 PWM 은 GPIO 12/13/18/19 이고 두 채널이 비어 있을 때만.
+static inline int buzzerBegin(int pin) {
+    buzzer.pin = pin;
+    if (buzzer.mode == BUZZER_PWM && !buzzer.out.hardware && pwmOutOpen(&buzzer.out, "버저", pin, 0, 0, 0) != 0) {
+        buzzer.mode = BUZZER_THREAD;
+    }
+    int hardware = (buzzer.mode == BUZZER_PWM);
+
+    if (hardware) {
+        pwmSetClock(BUZZER_PWM_CLOCK);  // 분주와 범위는 이 출력 전용
+    } else {
+        pinMode(pin, OUTPUT);
+        digitalWrite(pin, LOW);
+    }
+    if (buzzer.mode == BUZZER_BLOCK || buzzer.started) return 0;
+
+#ifndef SIM_BOARD
+    sem_init(&buzzerSem, 0, 0);
+#endif
+    if (piThreadCreate(buzzerPlayer) != 0) {
+        fprintf(stderr, "버저 재생 스레드 생성 실패, 소리가 끝날 때까지 기다리는 방식으로 울립니다\n");
+        buzzer.mode = BUZZER_BLOCK;
+        if (hardware) pwmOutClose(&buzzer.out);
+        return -1;
+    }
+    buzzer.started = 1;
+    return 0;
+}
+
+//3. 소리 넘기기
+static inline void buzzerPlay(const BuzzerSound* sound) {
+    atomic_fetch_add(&buzzer.played, 1);
+    if (buzzer.mode == BUZZER_BLOCK) {
+        buzzerSound(sound, 0);
+        return;
+    }
+    if (!buzzer.started) return;  // buzzerBegin 전
+    const BuzzerSound* old = atomic_exchange_explicit(&buzzer.request, sound, memory_order_acq_rel);
+    if (old != NULL) atomic_fetch_add(&buzzer.preempted, 1);  // 재생 스레드가 시작하기 전에 바뀐 소리
+#ifndef SIM_BOARD
+    sem_post(&buzzerSem);
+#endif
+}
+
+// 울리고 있거나 넘긴 소리가 있으면 1
+static inline int buzzerBusy(void) {
+    return buzzerPending() || atomic_load(&buzzer.playing);
+}
+
+#endif
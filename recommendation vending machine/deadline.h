@@ -0,0 +1,21 @@
+// sem_timedwait 마감 시각 (키패드 스캐너, 부저, 구동기 스레드가 같이 쓴다)
+//
+// sem_timedwait 은 CLOCK_REALTIME 절대 시각을 받으므로 지금 시각에 ms 를 더해 만든다.
+// 시뮬레이션 보드에서는 세마포어 대신 delay 로 기다리므로 쓰지 않는다.
+#ifndef DEADLINE_H
+#define DEADLINE_H
+
+#include <time.h>
+
+// 지금부터 ms 뒤
+static inline void deadlineAfterMs(struct timespec* ts, unsigned int ms) {
+    clock_gettime(CLOCK_REALTIME, ts);
+    ts->tv_sec += ms / 1000;
+    ts->tv_nsec += (long)(ms % 1000) * 1000000L;
+    if (ts->tv_nsec >= 1000000000L) {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
+#endif
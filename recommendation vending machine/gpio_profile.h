@@ -0,0 +1,227 @@
+// GPIO 접근 프로파일러 (선택 사용)
+// -DGPIO_PROFILE 로 빌드하면 digitalRead/digitalWrite/pinMode/delay/delayMicroseconds 호출을
+// 핀별, 호출한 함수별로 세고 걸린 시간을 더한다. 정의하지 않으면 아무 코드도 생성되지 않는다.
+//
+//   gcc -DGPIO_PROFILE Final.c -lwiringPi -lwiringPiDev -o vending_prof
+//   gcc -DGPIO_PROFILE -Isim/include "recommendation vending machine/Final.c" sim/sim_board.c -lm -o vending_prof
+//
+// 보고서 (시간 순으로 정렬):
+//   - 프로그램 종료 시, Ctrl+C 시 (출력 후 종료)
+//   - kill -USR2 <pid> 요청 시 (출력, 계속 실행)
+// 시그널 처리기는 요청만 표시한다. 요청은 프로파일을 시작한 스레드 (처음 GPIO 를 부른 main) 가
+// 다음 GPIO 호출이나 gpioProfPoll 에서 처리하므로 PWM, 음성 스레드가 단계 중간에 exit 하지 않는다.
+// 키 이벤트를 기다리며 막혀 있는 동안에는 GPIO 호출이 없으므로 대기 루프에서 gpioProfPoll() 을 부른다.
+// 기본 출력은 stderr, GPIO_PROFILE_FILE 로 파일에 덧붙일 수 있다.
+//
+// 걸린 시간은 실제 시계(CLOCK_MONOTONIC)로 잰다.
+// 호출 횟수 비율(ops/min)은 millis() 기준이므로 시뮬레이션 가상 시계에서는 가상 시간 기준이다.
+// 가상 시계로 대기 중 폴링 비용을 재려면 SIM_IDLE_SKIP=0 으로 실행한다.
+//
+// 키패드, 부저, 음성, 구동기 스레드가 동시에 불러도 된다.
+// 횟수와 시간은 원자적으로 더하고, 호출 함수 칸은 compare-exchange 로 한 스레드만 차지한다.
+//
+// 함수 이름을 매크로로 바꾸므로 wiringPi 헤더들보다 뒤에 포함한다.
+// GPIO 를 쓰는 헤더(keypad.h 등)는 이 헤더 뒤에 포함해야 프로파일에 잡힌다.
+#ifndef GPIO_PROFILE_H
+#define GPIO_PROFILE_H
+
+#ifdef GPIO_PROFILE
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <wiringPi.h>
+
+enum GpioProfOp {
+    GP_READ,
+    GP_WRITE,
+    GP_MODE,
+    GP_DELAY,    // delay, delayMicroseconds
+    GP_OPS
+};
+
+#define GPIO_PROF_CALLERS 128  // 2의 거듭제곱
+#define GPIO_PROF_PINS    64
+
+typedef struct {
+    const char* _Atomic func;  // __func__ (함수마다 고유한 문자열 주소)
+    atomic_ullong count[GP_OPS];
+    atomic_ullong ns[GP_OPS];
+} GpioProfEntry;
+
+static GpioProfEntry gpioProfCallers[GPIO_PROF_CALLERS];
+static GpioProfEntry gpioProfPins[GPIO_PROF_PINS];
+static unsigned int gpioProfStartMs;
+static atomic_flag gpioProfStarting = ATOMIC_FLAG_INIT;
+static atomic_int gpioProfStarted;
+static pthread_t gpioProfOwner;        // 시그널 요청을 처리하는 스레드
+static atomic_int gpioProfReportRequested;
+static atomic_int gpioProfExitRequested;
+
+static const char* const gpioProfOpNames[GP_OPS] = { "reads", "writes", "modes", "delays" };
+
+static uint64_t gpioProfNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t gpioProfTotalNs(const GpioProfEntry* e) {
+    return e->ns[GP_READ] + e->ns[GP_WRITE] + e->ns[GP_MODE] + e->ns[GP_DELAY];
+}
+
+static int gpioProfCompare(const void* a, const void* b) {
+    uint64_t x = gpioProfTotalNs(*(const GpioProfEntry* const*)a);
+    uint64_t y = gpioProfTotalNs(*(const GpioProfEntry* const*)b);
+    return (x < y) - (x > y);  // 시간이 긴 것부터
+}
+
+static void gpioProfPrintTable(FILE* out, GpioProfEntry* entries, int n, const char* title, int byPin) {
+    GpioProfEntry* sorted[GPIO_PROF_CALLERS];
+    int count = 0;
+    uint64_t allNs = 0;
+    for (int i = 0; i < n; i++) {
+        if (entries[i].func == NULL) continue;
+        sorted[count++] = &entries[i];
+        allNs += gpioProfTotalNs(&entries[i]);
+    }
+    qsort(sorted, (size_t)count, sizeof(sorted[0]), gpioProfCompare);
+
+    fprintf(out, "%-28s", title);
+    for (int op = 0; op < GP_OPS; op++) fprintf(out, " %12s", gpioProfOpNames[op]);
+    fprintf(out, " %12s %6s\n", "time ms", "time%");
+    for (int i = 0; i < count; i++) {
+        GpioProfEntry* e = sorted[i];
+        if (byPin) fprintf(out, "GPIO %-23d", (int)(e - entries));
+        else fprintf(out, "%-28s", e->func);
+        for (int op = 0; op < GP_OPS; op++) fprintf(out, " %12llu", (unsigned long long)e->count[op]);
+        fprintf(out, " %12.3f %5.1f%%\n", gpioProfTotalNs(e) / 1e6,
+                allNs ? 100.0 * gpioProfTotalNs(e) / allNs : 0.0);
+    }
+}
+
+static void gpioProfReport(void) {
+    const char* path = getenv("GPIO_PROFILE_FILE");
+    FILE* out = (path && *path) ? fopen(path, "a") : stderr;
+    if (out == NULL) out = stderr;
+
+    uint64_t total[GP_OPS] = { 0 };
+    for (int i = 0; i < GPIO_PROF_CALLERS; i++)
+        for (int op = 0; op < GP_OPS; op++) total[op] += gpioProfCallers[i].count[op];
+    uint64_t gpioOps = total[GP_READ] + total[GP_WRITE] + total[GP_MODE];
+    double minutes = ((millis)() - gpioProfStartMs) / 60000.0;
+
+    fprintf(out, "\n# GPIO profile: %.1fs, reads %llu, writes %llu, modes %llu, delays %llu\n",
+            minutes * 60.0, (unsigned long long)total[GP_READ], (unsigned long long)total[GP_WRITE],
+            (unsigned long long)total[GP_MODE], (unsigned long long)total[GP_DELAY]);
+    fprintf(out, "# %.3f M GPIO ops/min\n", minutes > 0 ? gpioOps / minutes / 1e6 : 0.0);
+    gpioProfPrintTable(out, gpioProfCallers, GPIO_PROF_CALLERS, "caller", 0);
+    fprintf(out, "\n");
+    gpioProfPrintTable(out, gpioProfPins, GPIO_PROF_PINS, "pin", 1);
+    fflush(out);
+    if (out != stderr) fclose(out);
+}
+
+// 표시만 한다 (lock-free atomic 쓰기는 시그널 처리기에서 써도 된다)
+static void gpioProfSignal(int sig) {
+    if (sig == SIGINT) atomic_store(&gpioProfExitRequested, 1);
+    else atomic_store(&gpioProfReportRequested, 1);
+}
+
+// 처음 GPIO 를 부른 스레드만 준비한다 (동시에 불러도 atexit 와 처리기는 한 번)
+static void gpioProfStart(void) {
+    if (atomic_flag_test_and_set(&gpioProfStarting)) return;
+    gpioProfOwner = pthread_self();
+    gpioProfStartMs = (millis)();
+    atexit(gpioProfReport);
+    signal(SIGUSR2, gpioProfSignal);
+    signal(SIGINT, gpioProfSignal);
+    atomic_store(&gpioProfStarted, 1);
+}
+
+// 시그널로 받은 요청 처리 (보고서 출력, 종료). 프로파일을 시작한 스레드에서만
+static void gpioProfPoll(void) {
+    if (!atomic_load(&gpioProfStarted) || !pthread_equal(pthread_self(), gpioProfOwner)) return;
+    if (atomic_exchange(&gpioProfReportRequested, 0)) gpioProfReport();
+    if (atomic_load(&gpioProfExitRequested)) exit(130);  // atexit 에서 보고서 출력
+}
+
+// 함수 이름 주소로 찾는 열린 주소법 해시
+static GpioProfEntry* gpioProfCaller(const char* func) {
+    unsigned int h = (unsigned int)(((uintptr_t)func >> 3) * 2654435761u) & (GPIO_PROF_CALLERS - 1);
+    for (int probe = 0; probe < GPIO_PROF_CALLERS; probe++) {
+        GpioProfEntry* e = &gpioProfCallers[(h + probe) & (GPIO_PROF_CALLERS - 1)];
+        const char* seen = atomic_load(&e->func);
+        if (seen == NULL && atomic_compare_exchange_strong(&e->func, &seen, func)) return e;
+        if (seen == func) return e;  // 이미 있거나 다른 스레드가 같은 함수로 먼저 차지했다
+    }
+    return &gpioProfCallers[h];  // 가득 찬 경우 (함수가 128개 이상)
+}
+
+static void gpioProfAdd(int op, int pin, const char* func, uint64_t ns) {
+    GpioProfEntry* e = gpioProfCaller(func);
+    atomic_fetch_add_explicit(&e->count[op], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&e->ns[op], ns, memory_order_relaxed);
+    if (pin >= 0 && pin < GPIO_PROF_PINS) {
+        atomic_store(&gpioProfPins[pin].func, "pin");
+        atomic_fetch_add_explicit(&gpioProfPins[pin].count[op], 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&gpioProfPins[pin].ns[op], ns, memory_order_relaxed);
+    }
+    gpioProfPoll();
+}
+
+// 괄호로 감싼 이름은 아래 매크로를 거치지 않고 원래 함수를 호출한다
+static int gpioProfDigitalRead(int pin, const char* func) {
+    if (!atomic_load(&gpioProfStarted)) gpioProfStart();
+    uint64_t t = gpioProfNow();
+    int value = (digitalRead)(pin);
+    gpioProfAdd(GP_READ, pin, func, gpioProfNow() - t);
+    return value;
+}
+
+static void gpioProfDigitalWrite(int pin, int value, const char* func) {
+    if (!atomic_load(&gpioProfStarted)) gpioProfStart();
+    uint64_t t = gpioProfNow();
+    (digitalWrite)(pin, value);
+    gpioProfAdd(GP_WRITE, pin, func, gpioProfNow() - t);
+}
+
+static void gpioProfPinMode(int pin, int mode, const char* func) {
+    if (!atomic_load(&gpioProfStarted)) gpioProfStart();
+    uint64_t t = gpioProfNow();
+    (pinMode)(pin, mode);
+    gpioProfAdd(GP_MODE, pin, func, gpioProfNow() - t);
+}
+
+static void gpioProfDelay(unsigned int ms, const char* func) {
+    if (!atomic_load(&gpioProfStarted)) gpioProfStart();
+    uint64_t t = gpioProfNow();
+    (delay)(ms);
+    gpioProfAdd(GP_DELAY, -1, func, gpioProfNow() - t);
+}
+
+static void gpioProfDelayMicroseconds(unsigned int us, const char* func) {
+    if (!atomic_load(&gpioProfStarted)) gpioProfStart();
+    uint64_t t = gpioProfNow();
+    (delayMicroseconds)(us);
+    gpioProfAdd(GP_DELAY, -1, func, gpioProfNow() - t);
+}
+
+#define digitalRead(pin)           gpioProfDigitalRead((pin), __func__)
+#define digitalWrite(pin, value)   gpioProfDigitalWrite((pin), (value), __func__)
+#define pinMode(pin, mode)         gpioProfPinMode((pin), (mode), __func__)
+#define delay(ms)                  gpioProfDelay((ms), __func__)
+#define delayMicroseconds(us)      gpioProfDelayMicroseconds((us), __func__)
+
+#else
+
+#define gpioProfPoll() ((void)0)
+
+#endif  // GPIO_PROFILE
+
+#endif
@@ -0,0 +1,378 @@
+// 인터럽트 방식 4x4 키패드 스캐너
+// 전용 스캐너 스레드(piThreadCreate)가 모든 행을 HIGH 로 두고 열 핀의 변화(wiringPiISR)를 기다린다.
+// 키가 눌리면 열이 HIGH 가 되어 인터럽트가 들어오고, 그때만 행을 하나씩 켜는 짧은 스캔을 한다.
+// 키가 하나라도 눌려 있는 동안은 KEYPAD_SCAN_MS 마다 스캔해서 떼는 순간을 확인한다.
+// 아무 키도 눌려 있지 않으면 스캔하지 않고 잠들어 있으므로 대기 중 CPU 사용이 거의 없다.
+//
+// 스캐너 스레드는 화면 흐름과 따로 돌기 때문에 화면이 delay(2000) 등으로 멈춰 있는 동안 누른 키도
+// 이벤트 링에 쌓이고, 화면 흐름은 keypadNextEvent 로 자기 속도에 맞춰 꺼내 간다 (먼저 입력한 키 보존).
+// 이벤트 링은 생산자(스캐너) 하나, 소비자(화면 흐름) 하나인 잠금 없는 링 버퍼다.
+//
+// 디바운스는 키마다 따로 하는 시간 기준 상태 기계이고 스캔할 때마다 갱신된다 (막히지 않음).
+// 한 키의 스캔 결과가 KEYPAD_DEBOUNCE_MS 동안 확정 상태와 계속 다르면 바뀐 것으로 확정하고
+// KEY_PRESS / KEY_RELEASE 이벤트를 링에 넣는다. 16개 키를 동시에 추적한다 (n-key rollover).
+// 이벤트 시각은 처음 변화를 본 스캔 시각이므로 키 입력 지연은 디바운스 시간 + 스캔 주기 이내로 일정하다.
+//
+// 그 밖의 이벤트
+//   KEY_LONG : 키를 KEYPAD_LONG_MS 이상 누르고 있을 때 한 번
+//   KEY_CHORD: keypadAddChord 로 등록한 키 조합을 모두 정해진 시간 이상 누르고 있을 때 한 번 (key = 조합 id)
+//
+// 다이오드가 없는 매트릭스에서는 직사각형의 세 꼭짓점 키를 누르면 네 번째 키도 눌린 것처럼 보인다(ghosting).
+// 두 행이 두 개 이상의 열을 함께 쓰면 그 꼭짓점 키들은 구별할 수 없으므로 새 변화로 인정하지 않고
+// 이전 확정 상태를 유지한다. 그런 스캔의 횟수는 keypadTakeGhosts 로 알 수 있다.
+//
+// 인터럽트 핸들러는 플래그만 세우고(실제 보드에서는 세마포어도 올림) 스캔과 디바운스는 모두 스캐너 스레드에서 한다.
+// 디바운스 상태는 스캐너 스레드만 바꾸고, 다른 스레드는 링, keypadHeld, 카운터만 읽는다.
+// 조합 등록(keypadAddChord)은 keypadBegin 전에 한다.
+// 시뮬레이션 보드에서는 스레드가 delay 에서 번갈아 실행되고 핸들러는 delay 도중에 호출된다.
+//
+// Final.c 를 한 파일로 빌드할 수 있도록 구현도 이 헤더에 둔다. 한 번역 단위에서만 포함한다.
+#ifndef KEYPAD_H
+#define KEYPAD_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <wiringPi.h>
+#ifndef SIM_BOARD
+#include <errno.h>
+#include <semaphore.h>
+#include "deadline.h"
+#endif
+
+#define KEYPAD_SCAN_MS      5     // 키가 눌려 있는 동안의 스캔 주기
+#define KEYPAD_DEBOUNCE_MS  20    // 같은 스캔 결과가 이 시간 동안 유지되면 확정
+#define KEYPAD_LONG_MS      1000
+#define KEYPAD_IDLE_MS      1000  // 아무 키도 없을 때 인터럽트를 기다리는 최대 시간
+#define KEYPAD_SETTLE_US    10    // 행을 바꾼 뒤 열이 안정될 때까지
+#define KEYPAD_RING         64    // 이벤트 링 크기, 2의 거듭제곱
+#define KEYPAD_MAX_CHORDS   4
+#define KEYPAD_PRIORITY     50    // 스캐너 스레드 우선순위 (piHiPri)
+
+enum KeyEventType {
+    KEY_PRESS,
+    KEY_RELEASE,
+    KEY_LONG,
+    KEY_CHORD
+};
+
+typedef struct {
+    char key;         // KEY_CHORD 이면 조합 id
+    uint8_t type;     // KeyEventType
+    uint16_t held;    // 이 이벤트를 반영한 뒤 눌려 있는 키 (keypadKeyMask 비트)
+    uint32_t timeUs;  // micros(), 변화를 처음 본 스캔 시각
+} KeyEvent;
+
+typedef struct {
+    const int* rows;
+    const int* cols;
+    const char (*keys)[4];
+
+    // 디바운스 상태 (스캐너 스레드 전용, stable 만 다른 스레드에서 읽음)
+    _Atomic uint16_t stable;  // 확정된 키 상태, 비트 = row * 4 + col
+    uint16_t pending;         // 스캔 결과가 확정 상태와 다른 키 (디바운스 중)
+    uint16_t longSent;        // 이번 누름에서 KEY_LONG 을 보낸 키
+    uint32_t changeUs[16];    // 디바운스 중인 변화를 처음 본 시각
+    uint32_t pressUs[16];     // 마지막으로 확정된 누름/뗌 시각
+    uint32_t releaseUs[16];
+    uint32_t lastScanMs;
+
+    struct {
+        char id;
+        const char* keys;
+        uint16_t mask;        // keypadBegin 에서 keys 로 채움
+        unsigned int holdMs;
+        int fired;            // 이번에 모두 누른 동안 이미 보냄
+    } chords[KEYPAD_MAX_CHORDS];
+    int chordCount;
+
+    // 이벤트 링: head 는 스캐너만, tail 은 소비자만 쓴다
+    KeyEvent ring[KEYPAD_RING];
+    _Atomic unsigned int head, tail;
+    _Atomic uint32_t rejects;  // 확정 전에 원래 상태로 돌아간 변화 (접점 떨림, 잡음)
+    _Atomic uint32_t ghosts;   // ghosting 때문에 일부 키를 판정하지 못한 스캔
+    _Atomic uint32_t dropped;  // 링이 가득 차서 버린 이벤트
+} Keypad;
+
+static Keypad keypad;
+static atomic_int keypadEdge;
+#ifndef SIM_BOARD
+static sem_t keypadSem;       // 인터럽트 -> 스캐너
+static sem_t keypadEventSem;  // 스캐너 -> 소비자 (링에 이벤트 추가)
+#endif
+
+// 열 핀 인터럽트: 스캔이 필요하다는 표시만 한다
+static void keypadIsr(void) {
+    atomic_store(&keypadEdge, 1);
+#ifndef SIM_BOARD
+    sem_post(&keypadSem);
+#endif
+}
+
+static uint16_t keypadKeyMask(char key) {
+    for (int row = 0; row < 4; row++)
+        for (int col = 0; col < 4; col++)
+            if (keypad.keys[row][col] == key) return (uint16_t)(1u << (row * 4 + col));
+    return 0;
+}
+
+// keys 의 키들을 모두 holdMs 이상 누르고 있으면 KEY_CHORD 이벤트(key = id)를 보낸다
+static int keypadAddChord(char id, const char* keys, unsigned int holdMs) {
+    if (keypad.chordCount == KEYPAD_MAX_CHORDS) return -1;
+    keypad.chords[keypad.chordCount].id = id;
+    keypad.chords[keypad.chordCount].keys = keys;
+    keypad.chords[keypad.chordCount].holdMs = holdMs;
+    keypad.chords[keypad.chordCount].fired = 0;
+    keypad.chordCount++;
+    return 0;
+}
+
+static void keypadParkRows(int level) {
+    for (int row = 0; row < 4; row++) digitalWrite(keypad.rows[row], level);
+}
+
+// 행을 하나씩 켜서 눌린 키를 읽고 다시 모든 행을 HIGH 로 되돌린다
+static uint16_t keypadScan(void) {
+    uint16_t mask = 0;
+    keypadParkRows(LOW);
+    for (int row = 0; row < 4; row++) {
+        digitalWrite(keypad.rows[row], HIGH);
+        delayMicroseconds(KEYPAD_SETTLE_US);
+        for (int col = 0; col < 4; col++) {
+            if (digitalRead(keypad.cols[col]) == HIGH) mask |= (uint16_t)(1u << (row * 4 + col));
+        }
+        digitalWrite(keypad.rows[row], LOW);
+    }
+    keypadParkRows(HIGH);
+    return mask;
+}
+
+// 생산자: 스캐너 스레드에서만 호출
+static void keypadPush(char key, int type, uint32_t timeUs) {
+    unsigned int head = atomic_load_explicit(&keypad.head, memory_order_relaxed);
+    unsigned int tail = atomic_load_explicit(&keypad.tail, memory_order_acquire);
+    if (head - tail == KEYPAD_RING) {
+        atomic_fetch_add_explicit(&keypad.dropped, 1, memory_order_relaxed);
+        return;
+    }
+    KeyEvent* ev = &keypad.ring[head & (KEYPAD_RING - 1)];
+    ev->key = key;
+    ev->type = (uint8_t)type;
+    ev->held = atomic_load_explicit(&keypad.stable, memory_order_relaxed);
+    ev->timeUs = timeUs;
+    atomic_store_explicit(&keypad.head, head + 1, memory_order_release);
+#ifndef SIM_BOARD
+    sem_post(&keypadEventSem);
+#endif
+}
+
+// 두 행이 두 개 이상의 열을 함께 쓰면 그 교차점의 키들은 진짜로 눌렸는지 알 수 없다
+static uint16_t keypadGhostMask(uint16_t raw) {
+    uint16_t ghost = 0;
+    for (int r1 = 0; r1 < 4; r1++) {
+        for (int r2 = r1 + 1; r2 < 4; r2++) {
+            unsigned int common = (raw >> (r1 * 4)) & (raw >> (r2 * 4)) & 0xF;
+            if (common & (common - 1)) ghost |= (uint16_t)((common << (r1 * 4)) | (common << (r2 * 4)));
+        }
+    }
+    return ghost;
+}
+
+static int keypadBusy(void) {
+    return keypad.stable != 0 || keypad.pending != 0;
+}
+
+// 키마다 디바운스 상태를 갱신하고 확정된 변화를 이벤트로 넣는다
+static void keypadUpdate(uint16_t raw, uint32_t nowUs) {
+    uint16_t stable = keypad.stable;
+    uint16_t ghost = keypadGhostMask(raw);
+    if (ghost) {
+        atomic_fetch_add_explicit(&keypad.ghosts, 1, memory_order_relaxed);
+        raw = (uint16_t)((raw & ~ghost) | (stable & ghost));  // 판정할 수 없는 키는 그대로 둔다
+    }
+
+    uint16_t diff = raw ^ stable;
+    uint32_t reverted = (uint32_t)__builtin_popcount(keypad.pending & ~diff);  // 확정 전에 돌아감
+    if (reverted) atomic_fetch_add_explicit(&keypad.rejects, reverted, memory_order_relaxed);
+    keypad.pending &= diff;
+
+    for (int bit = 0; bit < 16; bit++) {
+        uint16_t m = (uint16_t)(1u << bit);
+        if (!(diff & m)) continue;
+        if (!(keypad.pending & m)) {
+            keypad.pending |= m;
+            keypad.changeUs[bit] = nowUs;
+            continue;
+        }
+        if (nowUs - keypad.changeUs[bit] < KEYPAD_DEBOUNCE_MS * 1000u) continue;
+
+        keypad.pending &= (uint16_t)~m;
+        stable ^= m;
+        atomic_store_explicit(&keypad.stable, stable, memory_order_relaxed);
+        if (raw & m) {
+            keypad.pressUs[bit] = keypad.changeUs[bit];
+            keypad.longSent &= (uint16_t)~m;
+        } else {
+            keypad.releaseUs[bit] = keypad.changeUs[bit];
+        }
+        keypadPush(keypad.keys[bit / 4][bit % 4], (raw & m) ? KEY_PRESS : KEY_RELEASE, keypad.changeUs[bit]);
+    }
+
+    // 길게 누름
+    for (int bit = 0; bit < 16; bit++) {
+        uint16_t m = (uint16_t)(1u << bit);
+        if (!(stable & m) || (keypad.longSent & m)) continue;
+        if (nowUs - keypad.pressUs[bit] < KEYPAD_LONG_MS * 1000u) continue;
+        keypad.longSent |= m;
+        keypadPush(keypad.keys[bit / 4][bit % 4], KEY_LONG, nowUs);
+    }
+
+    // 조합: 마지막으로 눌린 키부터 holdMs
+    for (int c = 0; c < keypad.chordCount; c++) {
+        uint16_t mask = keypad.chords[c].mask;
+        if ((stable & mask) != mask) {
+            keypad.chords[c].fired = 0;
+            continue;
+        }
+        if (keypad.chords[c].fired) continue;
+        uint32_t heldUs = UINT32_MAX;
+        for (int bit = 0; bit < 16; bit++) {
+            if (!(mask & (1u << bit))) continue;
+            uint32_t t = nowUs - keypad.pressUs[bit];
+            if (t < heldUs) heldUs = t;
+        }
+        if (heldUs < keypad.chords[c].holdMs * 1000u) continue;
+        keypad.chords[c].fired = 1;
+        keypadPush(keypad.chords[c].id, KEY_CHORD, nowUs);
+    }
+}
+
+// 스캔이 필요한지 확인하고 스캔 결과를 디바운스 상태 기계에 넣는다
+static void keypadPoll(void) {
+    if (!atomic_load(&keypadEdge) && !(keypadBusy() && millis() - keypad.lastScanMs >= KEYPAD_SCAN_MS)) return;
+
+    uint16_t raw = keypadScan();
+    uint32_t nowUs = micros();
+    keypad.lastScanMs = millis();
+
+    // 스캔이 만든 열 변화는 무시한다. 스캔 도중에 눌린 키는 모든 행이 HIGH 인 지금 열에 보인다.
+    // 플래그를 먼저 지우고 나서 열을 읽어야 그 사이에 들어온 인터럽트를 잃지 않는다
+    atomic_store(&keypadEdge, 0);
+    if (raw == 0) {
+        for (int col = 0; col < 4; col++) {
+            if (digitalRead(keypad.cols[col]) == HIGH) atomic_store(&keypadEdge, 1);
+        }
+    }
+#ifndef SIM_BOARD
+    while (sem_trywait(&keypadSem) == 0);
+#endif
+
+    keypadUpdate(raw, nowUs);
+}
+
+// 인터럽트나 다음 스캔 시각까지 잠든다
+static void keypadScannerSleep(void) {
+    unsigned int ms = keypadBusy() ? KEYPAD_SCAN_MS : KEYPAD_IDLE_MS;
+#ifdef SIM_BOARD
+    // 시뮬레이션 보드는 delay 도중에 인터럽트를 호출한다
+    for (unsigned int i = 0; i < ms && !atomic_load(&keypadEdge); i++) delay(1);
+#else
+    struct timespec ts;
+    deadlineAfterMs(&ts, ms);
+    while (!atomic_load(&keypadEdge) && sem_timedwait(&keypadSem, &ts) == -1 && errno == EINTR);
+#endif
+}
+
+static PI_THREAD(keypadScanner) {
+    piHiPri(KEYPAD_PRIORITY);
+    while (1) {
+        keypadPoll();
+        keypadScannerSleep();
+    }
+    return NULL;
+}
+
+// 핀을 설정하고 스캐너 스레드를 시작한다. 실패하면 -1
+static int keypadBegin(const int rows[4], const int cols[4], const char keys[4][4]) {
+    keypad.rows = rows;
+    keypad.cols = cols;
+    keypad.keys = keys;
+    for (int c = 0; c < keypad.chordCount; c++) {
+        keypad.chords[c].mask = 0;
+        for (const char* k = keypad.chords[c].keys; *k; k++) keypad.chords[c].mask |= keypadKeyMask(*k);
+    }
+#ifndef SIM_BOARD
+    sem_init(&keypadSem, 0, 0);
+    sem_init(&keypadEventSem, 0, 0);
+#endif
+
+    // 행: 출력, 모두 HIGH 로 대기
+    for (int i = 0; i < 4; i++) {
+        pinMode(rows[i], OUTPUT);
+        digitalWrite(rows[i], HIGH);
+    }
+    // 열: 풀다운 입력, 양쪽 변화에 인터럽트
+    for (int i = 0; i < 4; i++) {
+        pinMode(cols[i], INPUT);
+        pullUpDnControl(cols[i], PUD_DOWN);
+        if (wiringPiISR(cols[i], INT_EDGE_BOTH, keypadIsr) < 0) {
+            fprintf(stderr, "키패드 인터럽트 설정 실패 (GPIO %d)\n", cols[i]);
+        }
+    }
+    atomic_store(&keypadEdge, 1);  // 시작할 때 이미 눌려 있는 키 확인
+
+    if (piThreadCreate(keypadScanner) != 0) {
+        fprintf(stderr, "키패드 스캐너 스레드 생성 실패\n");
+        return -1;
+    }
+    return 0;
+}
+
+// 소비자: 이벤트를 하나 꺼낸다. timeoutMs 안에 이벤트가 없으면 0
+static int keypadNextEvent(KeyEvent* ev, unsigned int timeoutMs) {
+#ifndef SIM_BOARD
+    struct timespec ts;
+    deadlineAfterMs(&ts, timeoutMs);
+#else
+    unsigned int start = millis();
+#endif
+    while (1) {
+        unsigned int tail = atomic_load_explicit(&keypad.tail, memory_order_relaxed);
+        if (tail != atomic_load_explicit(&keypad.head, memory_order_acquire)) {
+            *ev = keypad.ring[tail & (KEYPAD_RING - 1)];
+            atomic_store_explicit(&keypad.tail, tail + 1, memory_order_release);
+            return 1;
+        }
+#ifdef SIM_BOARD
+        if (millis() - start >= timeoutMs) return 0;
+        delay(1);  // 스캐너 스레드 차례
+#else
+        if (sem_timedwait(&keypadEventSem, &ts) == -1 && errno == ETIMEDOUT) {
+            if (atomic_load_explicit(&keypad.head, memory_order_acquire) == tail) return 0;
+        }
+#endif
+    }
+}
+
+// 지금 눌려 있는 키 (디바운스 확정 기준)
+static inline uint16_t keypadHeld(void) {
+    return atomic_load(&keypad.stable);
+}
+
+// 소비자: 링에 남은 이벤트를 버린다
+static inline void keypadFlush(void) {
+    atomic_store_explicit(&keypad.tail, atomic_load_explicit(&keypad.head, memory_order_acquire),
+                          memory_order_release);
+}
+
+// 마지막 호출 이후 늘어난 디바운스 거부 횟수
+static uint32_t keypadTakeRejects(void) {
+    return atomic_exchange(&keypad.rejects, 0);
+}
+
+// 마지막 호출 이후 ghosting 으로 일부 키를 판정하지 못한 스캔 횟수
+static uint32_t keypadTakeGhosts(void) {
+    return atomic_exchange(&keypad.ghosts, 0);
+}
+
+#endif
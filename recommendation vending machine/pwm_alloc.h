@@ -0,0 +1,171 @@
+// 하드웨어 PWM 채널 할당 (음성/버저, 동전 모터, 서보)
+//
+// 라즈베리파이의 하드웨어 PWM 은 채널 두 개다: 채널 0 (GPIO 12/18), 채널 1 (GPIO 13/19).
+// 파형은 PWM 클럭이 만들므로 CPU 를 쓰지 않는다. softPwm 은 핀마다 스레드가 100us 단위로 잠들었다 깨며
+// 토글하므로 서보 펄스 분해능이 100us, 모터 PWM 이 100Hz (들리는 소리) 이고 늦게 깨는 만큼 흔들린다.
+//
+// pwmOutOpen 은 핀이 하드웨어 채널에 연결되어 있고 그 채널이 비어 있으면 하드웨어로,
+// 아니면 softPwm 으로 출력을 연다 (softRange 가 0 이면 하드웨어만, 안 되면 -1).
+// 분주와 범위(한 주기의 클럭 수)는 wiringPi 에서 두 채널이 함께 쓴다 (pwmSetClock, pwmSetRange).
+//   분주는 PWM_ALLOC_DIVISOR (2, 9.6MHz) 로 고정하고 주파수는 범위로 정한다 (50Hz 서보 192000, 20kHz 모터 480).
+//   먼저 연 쪽이 범위를 정하고, 다른 채널은 그 주파수가 [hz, maxHz] 안이면 같이 쓴다.
+//   서보는 50Hz 만, 모터는 20kHz 이상 (들리지 않는) 이면 되므로 음성 반송파 37.5kHz 도 같이 쓸 수 있다.
+// hz 가 0 이면 분주와 범위를 혼자 바꾸는 출력 (buzzer.h 의 음 높이) 이므로 다른 채널까지 비어 있어야 한다.
+// 자판기 배선: 음성 GPIO 18 (채널 0), 모터 GPIO 19 (채널 1), 서보 GPIO 12 (채널 0) / 21 (하드웨어 없음).
+//
+// pwmAlloc.soft 를 1 로 두면 softRange 가 있는 출력은 모두 softPwm 으로 연다 (비교 측정용, bench_vending.c 의 PWM=soft).
+#ifndef PWM_ALLOC_H
+#define PWM_ALLOC_H
+
+#include <stdio.h>
+#include <string.h>
+#include <wiringPi.h>
+#include <softPwm.h>
+
+#define PWM_ALLOC_OSC_HZ   19200000
+#define PWM_ALLOC_DIVISOR  2
+#define PWM_ALLOC_CLOCK_HZ (PWM_ALLOC_OSC_HZ / PWM_ALLOC_DIVISOR)
+#define PWM_ALLOC_SOFT_US  100  // softPwm 한 칸
+#define PWM_ALLOC_MAX      8
+
+typedef struct {
+    const char* name;
+    int pin, hardware, channel;  // channel: 하드웨어 채널 (softPwm 이면 -1)
+    unsigned int range;          // 한 주기 값 (하드웨어: 클럭 수, softPwm: 칸 수)
+    unsigned int periodNs;
+} PwmOut;
+
+typedef struct {
+    PwmOut* owners[2];       // 채널별 출력
+    int exclusive;           // 분주와 범위를 혼자 쓰는 출력이 있다
+    unsigned int range;      // 두 채널이 함께 쓰는 범위 (0: 정하지 않음)
+    int soft;                // 1: softRange 가 있으면 softPwm 으로 (첫 pwmOutOpen 전에 정한다)
+    PwmOut* outs[PWM_ALLOC_MAX];
+    int count;
+} PwmAlloc;
+
+static PwmAlloc pwmAlloc;
+
+//1. 할당
+// 핀의 하드웨어 채널 (없으면 -1)
+static inline int pwmChannelOf(int pin) {
+    if (pin == 12 || pin == 18) return 0;
+    if (pin == 13 || pin == 19) return 1;
+    return -1;
+}
+
+// 하드웨어 채널을 줄 수 있으면 1 (범위도 정한다)
+static int pwmAllocHardware(int ch, unsigned int hz, unsigned int maxHz, unsigned int* range) {
+    if (ch < 0 || pwmAlloc.owners[ch] != NULL || pwmAlloc.exclusive) return 0;
+    int otherBusy = pwmAlloc.owners[ch ^ 1] != NULL;
+    if (hz == 0) {
+        if (otherBusy) return 0;
+        *range = 0;
+        return 1;
+    }
+    if (!otherBusy) {
+        *range = (PWM_ALLOC_CLOCK_HZ + hz / 2) / hz;
+        return 1;
+    }
+    unsigned int shared = PWM_ALLOC_CLOCK_HZ / pwmAlloc.range;
+    if (shared < hz || shared > maxHz) return 0;
+    *range = pwmAlloc.range;
+    return 1;
+}
+
+// 출력을 연다. hz: 원하는 주파수, maxHz: 다른 채널과 같이 쓸 때 받아들이는 가장 높은 주파수,
+// softRange: 하드웨어를 못 받았을 때 softPwm 범위 (0 이면 -1 을 돌려준다)
+static inline int pwmOutOpen(PwmOut* out, const char* name, int pin, unsigned int hz, unsigned int maxHz, int softRange) {
+    memset(out, 0, sizeof(*out));
+    out->name = name;
+    out->pin = pin;
+    out->channel = -1;
+
+    int ch = pwmChannelOf(pin);
+    unsigned int range = 0;
+    if (!(pwmAlloc.soft && softRange > 0) && pwmAllocHardware(ch, hz, maxHz, &range)) {
+        out->hardware = 1;
+        out->channel = ch;
+        out->range = range;
+        out->periodNs = range ? (unsigned int)(1000000000ULL * range / PWM_ALLOC_CLOCK_HZ) : 0;
+        // pinMode(PWM_OUTPUT) 는 두 채널이 함께 쓰는 모드, 범위, 분주를 기본값으로 되돌리므로
+        // 다른 채널이 쓰고 있어도 다시 설정한다
+        pinMode(pin, PWM_OUTPUT);
+        pwmSetMode(PWM_MODE_MS);  // balanced 모드는 값에 따라 펄스를 흩어 놓아 주기가 바뀐다
+        if (hz == 0) {
+            pwmAlloc.exclusive = 1;  // 분주와 범위는 출력이 정한다
+        } else {
+            pwmSetClock(PWM_ALLOC_DIVISOR);
+            pwmSetRange(range);
+            pwmAlloc.range = range;
+        }
+        pwmWrite(pin, 0);
+        pwmAlloc.owners[ch] = out;
+    } else if (softRange > 0) {
+        out->range = (unsigned int)softRange;
+        out->periodNs = (unsigned int)softRange * PWM_ALLOC_SOFT_US * 1000u;
+        pinMode(pin, OUTPUT);
+        softPwmCreate(pin, 0, softRange);
+    } else {
+        return -1;
+    }
+    if (pwmAlloc.count < PWM_ALLOC_MAX) pwmAlloc.outs[pwmAlloc.count++] = out;
+    return 0;
+}
+
+// 출력을 끄고 하드웨어 채널을 돌려준다
+static inline void pwmOutClose(PwmOut* out) {
+    if (out->hardware) {
+        pwmWrite(out->pin, 0);
+        pinMode(out->pin, OUTPUT);
+        digitalWrite(out->pin, LOW);
+        pwmAlloc.owners[out->channel] = NULL;
+        if (out->range == 0) pwmAlloc.exclusive = 0;
+        if (pwmAlloc.owners[out->channel ^ 1] == NULL) pwmAlloc.range = 0;
+    } else if (out->range > 0) {
+        softPwmWrite(out->pin, 0);
+        softPwmStop(out->pin);
+    }
+    for (int i = 0; i < pwmAlloc.count; i++) {
+        if (pwmAlloc.outs[i] == out) pwmAlloc.outs[i] = pwmAlloc.outs[--pwmAlloc.count];
+    }
+    out->hardware = 0;
+    out->range = 0;
+}
+
+//2. 쓰기
+// 한 주기 중 value (0 ~ range)
+static inline void pwmOutWrite(const PwmOut* out, unsigned int value) {
+    if (value > out->range) value = out->range;
+    if (out->hardware) pwmWrite(out->pin, (int)value);
+    else softPwmWrite(out->pin, (int)value);
+}
+
+// 펄스 폭 (서보). softPwm 은 100us 단위로 반올림된다
+static inline void pwmOutWriteUs(const PwmOut* out, unsigned int us) {
+    if (out->periodNs == 0) return;
+    pwmOutWrite(out, (unsigned int)(((unsigned long long)us * 1000u * out->range + out->periodNs / 2) / out->periodNs));
+}
+
+// 듀티 (%, 모터 속도)
+static inline void pwmOutWritePercent(const PwmOut* out, unsigned int percent) {
+    pwmOutWrite(out, (unsigned int)((unsigned long long)out->range * percent / 100));
+}
+
+// 출력마다 방식, 주파수, 분해능
+static inline void pwmAllocReport(FILE* f, const char* indent) {
+    for (int i = 0; i < pwmAlloc.count; i++) {
+        const PwmOut* o = pwmAlloc.outs[i];
+        fprintf(f, "%sGPIO %-2d %-6s ", indent, o->pin, o->name);
+        if (o->hardware && o->range == 0) {
+            fprintf(f, "하드웨어 채널 %d (분주/범위 전용)\n", o->channel);
+        } else if (o->hardware) {
+            fprintf(f, "하드웨어 채널 %d, %.1fHz, 분해능 %.3fus (%u칸)\n", o->channel, 1e9 / o->periodNs,
+                    (double)o->periodNs / o->range / 1000.0, o->range);
+        } else {
+            fprintf(f, "softPwm, %.1fHz, 분해능 %uus (%u칸)\n", 1e9 / o->periodNs, PWM_ALLOC_SOFT_US, o->range);
+        }
+    }
+}
+
+#endif
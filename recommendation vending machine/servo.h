@@ -0,0 +1,125 @@
+// 서보 채널 풀과 배출 동작 (Final.c 의 음료 배출)
+//
+// 예전 cashPaymentSystem / cardPaymentSystem 은 거래마다 pinMode 와 softPwmCreate(servoPin, 0, 200) 를 불렀다.
+// softPwmCreate 는 부를 때마다 그 핀의 PWM 스레드를 새로 만들고 (음료 40개가 핀 12/21 두 개를 같이 쓴다)
+// 만든 스레드는 멈추지 않으므로 하루 판매량만큼 스레드와 지터가 늘었다.
+// 배출 동작(5 → 2초 유지 → 15)도 결제 함수 안에서 delay(2000) 로 기다렸다.
+//
+// servoAttach 로 음료의 핀을 등록하면 핀마다 채널 하나만 만든다 (같은 핀은 같은 채널).
+// servoBegin 이 채널마다 PWM 출력을 한 번 열고 (pwm_alloc.h: 하드웨어 채널이 남아 있으면 50Hz 하드웨어 PWM,
+// 아니면 softPwm) 구동기 스케줄러(actuator.h)를 시작한다. 위치는 펄스 폭(us)으로 쓴다.
+// 배출 동작은 타임라인 단계 두 개로, 둘 다 채널의 자원(ACT_LOCK_SERVO)을 잡는다.
+//   밀기(SERVO_PUSH_US) → SERVO_HOLD_MS 유지 → 제자리(SERVO_HOME_US) → SERVO_RETURN_MS 동안 돌아오기를 기다림
+// servoStroke 는 거래의 타임라인에 배출 동작을 더한다 (잔돈 모터와 같이 진행).
+// 한 채널의 동작 중에 같은 채널에 배출을 넘기면 자원이 풀린 뒤 이어서 한다.
+// act.serial 이면 actStart 가 배출 동작이 끝날 때까지 기다린다 (채널은 그대로 한 번만 만든다).
+#ifndef SERVO_H
+#define SERVO_H
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wiringPi.h>
+#include "pwm_alloc.h"
+#include "actuator.h"
+
+#define SERVO_MAX_CHANNELS 8
+#define SERVO_HZ           50
+#define SERVO_SOFT_RANGE   200   // softPwm 한 칸 100us, 200칸 = 20ms (50Hz)
+#define SERVO_PUSH_US      500   // 음료를 미는 위치 (예전 softPwm 값 5)
+#define SERVO_HOME_US      1500  // 제자리 (예전 softPwm 값 15)
+#define SERVO_HOLD_MS      2000
+#define SERVO_RETURN_MS    500   // 제자리로 돌아오는 시간 (다음 배출은 그 뒤에)
+
+typedef struct {
+    int pin, created;
+    PwmOut out;
+    atomic_int busy;        // 타임라인에 넣었지만 끝나지 않은 배출
+    atomic_ulong strokes;   // 끝난 배출
+} ServoChannel;
+
+typedef struct {
+    ServoChannel channels[SERVO_MAX_CHANNELS];
+    int count, began;
+    unsigned long creates;  // PWM 출력을 연 횟수 (채널 수와 같아야 한다)
+    atomic_ulong overlapped; // 같은 채널이 동작 중일 때 넘긴 배출
+} ServoPool;
+
+static ServoPool servo;
+
+//1. 채널
+static ServoChannel* servoFind(int pin) {
+    for (int i = 0; i < servo.count; i++) {
+        if (servo.channels[i].pin == pin) return &servo.channels[i];
+    }
+    return NULL;
+}
+
+// 채널의 PWM 출력을 연다 (채널마다 한 번). 첫 배출 전에는 펄스 없음 (예전과 같이)
+static void servoCreate(ServoChannel* ch) {
+    if (ch->created) return;
+    pwmOutOpen(&ch->out, "서보", ch->pin, SERVO_HZ, SERVO_HZ, SERVO_SOFT_RANGE);
+    ch->created = 1;
+    servo.creates++;
+}
+
+// 음료의 서보 핀을 등록한다 (0 이하는 서보 없음). 이미 있는 핀이면 그 채널을 쓴다
+static inline int servoAttach(int pin) {
+    if (pin <= 0 || servoFind(pin) != NULL) return 0;
+    if (servo.count == SERVO_MAX_CHANNELS) {
+        fprintf(stderr, "서보 채널이 모자랍니다 (핀 %d)\n", pin);
+        return -1;
+    }
+    ServoChannel* ch = &servo.channels[servo.count++];
+    ch->pin = pin;
+    if (servo.began) servoCreate(ch);  // servoBegin 뒤에 등록한 핀
+    return 0;
+}
+
+// 등록한 채널마다 PWM 을 한 번 만들고 구동기 스케줄러를 시작한다
+static inline int servoBegin(void) {
+    servo.began = 1;
+    for (int i = 0; i < servo.count; i++) servoCreate(&servo.channels[i]);
+    return actBegin();
+}
+
+//2. 배출 동작 (타임라인 단계, arg 는 채널 번호)
+static void servoPushStep(int n) {
+    pwmOutWriteUs(&servo.channels[n].out, SERVO_PUSH_US);  // 서보모터 동작
+}
+
+static void servoHomeStep(int n) {
+    pwmOutWriteUs(&servo.channels[n].out, SERVO_HOME_US);  // 원래 위치로 복귀
+}
+
+static void servoStrokeDone(int n) {
+    atomic_fetch_add(&servo.channels[n].strokes, 1);
+    atomic_fetch_sub(&servo.channels[n].busy, 1);
+}
+
+// 타임라인 t 에 after 단계 뒤의 배출 동작을 더하고 마지막 단계 번호를 돌려준다 (서보가 없는 음료면 after)
+static inline int servoStroke(ActTimeline* t, int pin, int after) {
+    if (servoAttach(pin) != 0) return after;
+    ServoChannel* ch = servoFind(pin);
+    if (ch == NULL) return after;  // 서보 없는 음료
+    servoCreate(ch);
+    int n = (int)(ch - servo.channels);
+    int push = actAdd(t, servoPushStep, NULL, n, SERVO_HOLD_MS, ACT_LOCK_SERVO(n), after);
+    if (push < 0) return after;
+    int home = actAdd(t, servoHomeStep, servoStrokeDone, n, SERVO_RETURN_MS, ACT_LOCK_SERVO(n), push);
+    if (home < 0) return push;
+    if (atomic_fetch_add(&ch->busy, 1) > 0) atomic_fetch_add(&servo.overlapped, 1);
+    return home;
+}
+
+//3. 상태
+// 넘긴 배출이 남아 있거나 동작 중이면 1 (pin 이 0 이면 모든 채널)
+static inline int servoBusy(int pin) {
+    for (int i = 0; i < servo.count; i++) {
+        if ((pin == 0 || servo.channels[i].pin == pin) && atomic_load(&servo.channels[i].busy) > 0) return 1;
+    }
+    return 0;
+}
+
+#endif
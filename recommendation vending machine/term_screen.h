@@ -0,0 +1,434 @@
+// 터미널 화면 렌더러 (이중 버퍼 + 셀 단위 비교)
+// 화면 출력(문자열 + ANSI 제어 문자열)을 바로 터미널로 보내지 않고 메모리 화면(back)에 그린다.
+// screenFlush 에서 터미널에 실제로 보이는 화면(front)과 칸 단위로 비교하고,
+// 바뀐 칸만 커서 이동 + 문자 쓰기로 묶어 write() 한 번으로 보낸다.
+// 화면 전체를 지우고 다시 그려도 바뀐 글자만 나가므로 시리얼 콘솔에서 깜빡이지 않는다.
+//
+// 해석하는 제어 문자열: \033[2J \033[J \033[K \033[행;열H \033[A~D, \n \r \b \t
+// 한글 등 전각 문자는 두 칸을 차지한다 (출력은 UTF-8 로 가정).
+//
+// 표준 출력이 터미널이 아니면(파이프, 파일) 비교하지 않고 stdio 로 그대로 출력한다.
+// 첫 출력 전에 screenForce 를 1 (항상 비교 출력) 이나 0 (항상 그대로 출력) 으로 둘 수 있다
+// (비교 측정용, bench_vending.c 의 TERM_SCREEN=).
+// 비교 출력에서는 screenFlush 전까지 화면에 나타나지 않으므로 키 입력이나 delay 로 기다리기 전에 호출한다.
+#ifndef TERM_SCREEN_H
+#define TERM_SCREEN_H
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+#define SCREEN_MAX_ROWS 60
+#define SCREEN_MAX_COLS 200
+#define SCREEN_OUT_SIZE 65536
+#define SCREEN_SKIP_CELLS 4   // 바뀌지 않은 칸이 이보다 적으면 커서를 옮기지 않고 다시 쓴다
+
+typedef struct {
+    char bytes[4];   // UTF-8 문자
+    uint8_t len;     // 0: 전각 문자의 오른쪽 칸
+    uint8_t wide;    // 1: 전각 문자의 왼쪽 칸
+} ScreenCell;
+
+static ScreenCell screenBack[SCREEN_MAX_ROWS][SCREEN_MAX_COLS];   // 그리는 중인 화면
+static ScreenCell screenFront[SCREEN_MAX_ROWS][SCREEN_MAX_COLS];  // 터미널에 보이는 화면
+static int screenRows = 24, screenCols = 80;
+static int screenRow, screenCol;       // back 커서 (screenCol == screenCols: 줄 끝, 다음 글자에서 줄바꿈)
+static int screenScrolls;              // 마지막 flush 이후 back 이 위로 밀린 줄 수
+static int screenDirty;                // 마지막 flush 이후 back 에 쓴 적이 있음
+static uint8_t screenRowDirty[SCREEN_MAX_ROWS];  // flush 에서 비교할 행
+static int screenMode = -1;            // -1: 아직 정하지 않음, 0: 그대로 출력, 1: 비교 출력
+static int screenForce = -1;           // -1: 터미널이면 비교 출력, 0/1: screenMode 로 그대로
+static int screenFrontValid;           // 0: 터미널 내용을 모름 (처음, 크기 변경)
+static volatile sig_atomic_t screenResized;
+
+// 해석 중인 UTF-8 문자와 제어 문자열
+static unsigned char screenUtf8[4];
+static int screenUtf8Len, screenUtf8Need;
+static int screenEscState;             // 0: 일반, 1: ESC 받음, 2: ESC [ 뒤 인자
+static int screenEscArgs[2], screenEscArgc;
+
+// 출력 버퍼 (flush 한 번에 write 한 번)
+static char screenOut[SCREEN_OUT_SIZE];
+static int screenOutLen;
+static int screenOutRow = -1, screenOutCol = -1;  // 터미널 커서 (모르면 -1)
+
+// 통계 (그대로 출력할 때도 바이트 수는 센다)
+static unsigned long screenBytes, screenWrites, screenFrames;
+
+static const ScreenCell screenBlank = { { ' ' }, 1, 0 };
+
+//1. 메모리 화면
+static int screenCellEqual(const ScreenCell* a, const ScreenCell* b) {
+    return a->len == b->len && a->wide == b->wide && memcmp(a->bytes, b->bytes, a->len) == 0;
+}
+
+static int screenCellBlank(const ScreenCell* c) {
+    return c->len == 1 && c->bytes[0] == ' ';
+}
+
+static void screenClearCells(ScreenCell rows[][SCREEN_MAX_COLS], int row, int from, int to) {
+    for (int c = from; c < to; c++) rows[row][c] = screenBlank;
+    if (rows == screenBack) screenRowDirty[row] = 1;
+}
+
+// 전각 문자의 한쪽만 지워지는 경우 남은 반쪽도 지운다
+static void screenSplitWide(int row, int col) {
+    ScreenCell* line = screenBack[row];
+    if (col < 0 || col >= screenCols) return;
+    if (line[col].len == 0 && col > 0) line[col - 1] = screenBlank;
+    if (line[col].wide && col + 1 < screenCols) line[col + 1] = screenBlank;
+}
+
+static void screenScrollUp(ScreenCell rows[][SCREEN_MAX_COLS]) {
+    memmove(rows[0], rows[1], sizeof(rows[0]) * (size_t)(screenRows - 1));
+    screenClearCells(rows, screenRows - 1, 0, screenCols);
+    memset(screenRowDirty, 1, sizeof(screenRowDirty));
+}
+
+static void screenNewline(void) {
+    screenCol = 0;
+    if (++screenRow >= screenRows) {
+        screenRow = screenRows - 1;
+        screenScrollUp(screenBack);
+        if (screenScrolls < screenRows) screenScrolls++;
+    }
+}
+
+// 한글 등 두 칸짜리 문자
+static int screenCharWidth(uint32_t cp) {
+    if ((cp >= 0x1100 && cp <= 0x115F) || (cp >= 0x2E80 && cp <= 0xA4CF) ||
+        (cp >= 0xAC00 && cp <= 0xD7A3) || (cp >= 0xF900 && cp <= 0xFAFF) ||
+        (cp >= 0xFE30 && cp <= 0xFE4F) || (cp >= 0xFF00 && cp <= 0xFF60) ||
+        (cp >= 0xFFE0 && cp <= 0xFFE6) || (cp >= 0x1F300 && cp <= 0x1FAFF)) return 2;
+    return 1;
+}
+
+static void screenPutGlyph(const unsigned char* bytes, int len, int width) {
+    if (screenCol + width > screenCols) screenNewline();  // 줄 끝: 다음 줄로 (터미널 자동 줄바꿈)
+    ScreenCell* line = screenBack[screenRow];
+    screenRowDirty[screenRow] = 1;
+    screenSplitWide(screenRow, screenCol);
+    if (width == 2) screenSplitWide(screenRow, screenCol + 1);
+
+    ScreenCell* cell = &line[screenCol];
+    memcpy(cell->bytes, bytes, (size_t)len);
+    cell->len = (uint8_t)len;
+    cell->wide = (width == 2);
+    if (width == 2) {
+        line[screenCol + 1].len = 0;
+        line[screenCol + 1].wide = 0;
+    }
+    screenCol += width;
+}
+
+//2. 제어 문자열 해석
+static void screenEraseLine(int mode) {
+    int col = screenCol < screenCols ? screenCol : screenCols - 1;
+    int from = (mode == 0) ? col : 0;
+    int to = (mode == 1) ? col + 1 : screenCols;
+    screenSplitWide(screenRow, from);
+    screenSplitWide(screenRow, to - 1);
+    screenClearCells(screenBack, screenRow, from, to);
+}
+
+static void screenCsi(char final) {
+    int a = screenEscArgs[0], b = screenEscArgs[1];
+    switch (final) {
+    case 'H': case 'f':  // 커서 이동 (1부터 시작)
+        screenRow = (a > 0 ? a - 1 : 0);
+        screenCol = (b > 0 ? b - 1 : 0);
+        if (screenRow >= screenRows) screenRow = screenRows - 1;
+        if (screenCol >= screenCols) screenCol = screenCols - 1;
+        break;
+    case 'J':
+        if (a == 2) {  // 화면 전체 (커서는 그대로)
+            for (int r = 0; r < screenRows; r++) screenClearCells(screenBack, r, 0, screenCols);
+            screenScrolls = 0;
+        } else if (a == 0) {  // 커서부터 화면 끝까지
+            screenEraseLine(0);
+            for (int r = screenRow + 1; r < screenRows; r++) screenClearCells(screenBack, r, 0, screenCols);
+        }
+        break;
+    case 'K':
+        screenEraseLine(a);
+        break;
+    case 'A': screenRow -= (a > 0 ? a : 1); if (screenRow < 0) screenRow = 0; break;
+    case 'B': screenRow += (a > 0 ? a : 1); if (screenRow >= screenRows) screenRow = screenRows - 1; break;
+    case 'C': screenCol += (a > 0 ? a : 1); if (screenCol >= screenCols) screenCol = screenCols - 1; break;
+    case 'D': screenCol -= (a > 0 ? a : 1); if (screenCol < 0) screenCol = 0; break;
+    default: break;  // 색상 등은 무시
+    }
+}
+
+// 문자열을 back 에 그린다 (UTF-8 문자와 제어 문자열이 여러 호출에 걸쳐 나뉘어도 된다)
+static void screenPut(const char* s, int n) {
+    screenDirty = 1;
+    for (int i = 0; i < n; i++) {
+        unsigned char ch = (unsigned char)s[i];
+
+        if (screenEscState == 1) {
+            if (ch == '[') {
+                screenEscState = 2;
+                screenEscArgs[0] = screenEscArgs[1] = 0;
+                screenEscArgc = 0;
+            } else {
+                screenEscState = 0;  // 지원하지 않는 ESC 문자열
+            }
+            continue;
+        }
+        if (screenEscState == 2) {
+            if (ch >= '0' && ch <= '9') {
+                if (screenEscArgc < 2) screenEscArgs[screenEscArgc] = screenEscArgs[screenEscArgc] * 10 + (ch - '0');
+            } else if (ch == ';') {
+                screenEscArgc++;
+            } else if (ch >= 0x40 && ch <= 0x7E) {
+                screenCsi((char)ch);
+                screenEscState = 0;
+            }
+            continue;
+        }
+
+        if (screenUtf8Need > 0) {
+            if ((ch & 0xC0) == 0x80) {
+                screenUtf8[screenUtf8Len++] = ch;
+                if (screenUtf8Len < screenUtf8Need) continue;
+                uint32_t cp = screenUtf8[0] & (0x7F >> screenUtf8Need);
+                for (int k = 1; k < screenUtf8Len; k++) cp = (cp << 6) | (screenUtf8[k] & 0x3F);
+                screenPutGlyph(screenUtf8, screenUtf8Len, screenCharWidth(cp));
+                screenUtf8Need = 0;
+                continue;
+            }
+            screenPutGlyph((const unsigned char*)"?", 1, 1);  // 잘린 UTF-8 문자
+            screenUtf8Need = 0;
+        }
+
+        if (ch == 0x1B) {
+            screenEscState = 1;
+        } else if (ch == '\n') {
+            screenNewline();
+        } else if (ch == '\r') {
+            screenCol = 0;
+        } else if (ch == '\b') {
+            if (screenCol > 0) screenCol--;
+        } else if (ch == '\t') {
+            screenCol = (screenCol / 8 + 1) * 8;
+            if (screenCol >= screenCols) screenCol = screenCols - 1;
+        } else if (ch >= 0x20 && ch < 0x7F) {
+            screenPutGlyph(&ch, 1, 1);
+        } else if (ch >= 0xC0 && ch < 0xF8) {
+            screenUtf8[0] = ch;
+            screenUtf8Len = 1;
+            screenUtf8Need = (ch >= 0xF0) ? 4 : (ch >= 0xE0) ? 3 : 2;
+        }
+    }
+}
+
+//3. 터미널로 출력
+static void screenWriteOut(void) {
+    for (int off = 0; off < screenOutLen; ) {
+        ssize_t w = write(STDOUT_FILENO, screenOut + off, (size_t)(screenOutLen - off));
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) break;
+        off += (int)w;
+    }
+    screenBytes += (unsigned long)screenOutLen;
+    screenWrites++;
+    screenOutLen = 0;
+}
+
+static void screenEmit(const char* s, int n) {
+    if (screenOutLen + n > SCREEN_OUT_SIZE) screenWriteOut();  // 버퍼가 가득 찬 경우에만 나눠서 쓴다
+    memcpy(screenOut + screenOutLen, s, (size_t)n);
+    screenOutLen += n;
+}
+
+static void screenEmitMove(int row, int col) {
+    if (screenOutRow == row && screenOutCol == col) return;
+    char seq[16];
+    int n;
+    // 가장 짧은 이동 문자열: 줄 처음(\r), 다음 줄 처음(\r\n), 같은 줄 오른쪽(\033[nC), 그 외 절대 위치
+    if (screenOutRow == row && col == 0) n = snprintf(seq, sizeof(seq), "\r");
+    else if (screenOutRow >= 0 && screenOutRow + 1 == row && col == 0) n = snprintf(seq, sizeof(seq), "\r\n");
+    else if (screenOutRow == row && screenOutCol >= 0 && col > screenOutCol) n = snprintf(seq, sizeof(seq), "\033[%dC", col - screenOutCol);
+    else n = snprintf(seq, sizeof(seq), "\033[%d;%dH", row + 1, col + 1);
+    screenEmit(seq, n);
+    screenOutRow = row;
+    screenOutCol = col;
+}
+
+static void screenOnResize(int sig) {
+    (void)sig;
+    screenResized = 1;
+}
+
+static void screenQuerySize(void) {
+    struct winsize ws;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_row > 0 && ws.ws_col > 0) {
+        screenRows = ws.ws_row < SCREEN_MAX_ROWS ? ws.ws_row : SCREEN_MAX_ROWS;
+        screenCols = ws.ws_col < SCREEN_MAX_COLS ? ws.ws_col : SCREEN_MAX_COLS;
+    }
+    if (screenRow >= screenRows) screenRow = screenRows - 1;
+    if (screenCol > screenCols) screenCol = screenCols;
+}
+
+static void screenFlush(void);
+
+static void screenInit(void) {
+    screenMode = screenForce >= 0 ? screenForce : isatty(STDOUT_FILENO);
+    if (screenMode != 1) return;
+
+    screenQuerySize();
+    for (int r = 0; r < SCREEN_MAX_ROWS; r++) screenClearCells(screenBack, r, 0, SCREEN_MAX_COLS);
+    signal(SIGWINCH, screenOnResize);
+    atexit(screenFlush);
+}
+
+// 한 행에서 front 와 다른 칸만 보낸다
+static void screenDiffRow(int r) {
+    ScreenCell* back = screenBack[r];
+    ScreenCell* front = screenFront[r];
+    int lastText = -1;  // back 에서 공백이 아닌 마지막 칸
+    for (int c = screenCols - 1; c >= 0; c--) {
+        if (!screenCellBlank(&back[c])) {
+            lastText = c;
+            break;
+        }
+    }
+
+    int c = 0;
+    while (c < screenCols) {
+        if (screenCellEqual(&back[c], &front[c])) {
+            c++;
+            continue;
+        }
+        if (c > 0 && (back[c].len == 0 || front[c].len == 0)) {
+            // 전각 문자의 반쪽: 왼쪽 칸부터 다시 쓴다 (터미널은 반쪽만 덮인 전각 문자를 지운다)
+            c--;
+            front[c].len = 0xFF;
+        }
+
+        // 남은 칸이 모두 공백이면 줄 끝까지 지우기 한 번으로
+        if (c > lastText) {
+            screenEmitMove(r, c);
+            screenEmit("\033[K", 3);
+            screenClearCells(screenFront, r, c, screenCols);
+            return;
+        }
+
+        screenEmitMove(r, c);
+        while (c <= lastText) {
+            if (screenCellEqual(&back[c], &front[c])) {
+                // 가까이에 바뀐 칸이 또 있으면 같은 칸도 이어서 쓰는 편이 커서 이동보다 짧다
+                int next = c;
+                while (next < screenCols && next - c < SCREEN_SKIP_CELLS && screenCellEqual(&back[next], &front[next])) next++;
+                if (next >= screenCols || next - c >= SCREEN_SKIP_CELLS || next > lastText) break;
+            }
+            int width = back[c].wide ? 2 : 1;
+            if (back[c].len > 0) screenEmit(back[c].bytes, back[c].len);
+            else screenEmit(" ", 1);  // 짝이 없는 오른쪽 칸 (일어나지 않아야 함)
+            // 터미널은 반쪽만 덮인 전각 문자의 나머지 반쪽을 지운다
+            int end = c + width;
+            if (end < screenCols && front[end - 1].wide) front[end] = screenBlank;
+            for (int k = 0; k < width && c + k < screenCols; k++) front[c + k] = back[c + k];
+            c = end;
+        }
+        screenOutCol = (c < screenCols) ? c : -1;  // 줄 끝에 닿으면 터미널마다 커서 위치가 다르다
+        if (screenOutCol < 0) screenOutRow = -1;
+    }
+}
+
+// back 을 터미널에 반영 (바뀐 칸만, write 한 번)
+static void screenFlush(void) {
+    if (screenMode < 0) screenInit();
+    if (screenMode != 1) {
+        fflush(stdout);
+        return;
+    }
+    if (!screenDirty && !screenResized) return;
+    fflush(stdout);  // 이 렌더러를 거치지 않은 출력이 먼저 나가도록
+
+    if (screenResized) {
+        screenResized = 0;
+        screenQuerySize();
+        screenFrontValid = 0;
+    }
+    if (!screenFrontValid) {
+        screenEmit("\033[H\033[2J", 7);
+        for (int r = 0; r < SCREEN_MAX_ROWS; r++) screenClearCells(screenFront, r, 0, SCREEN_MAX_COLS);
+        screenOutRow = screenOutCol = 0;
+        screenScrolls = 0;
+        screenFrontValid = 1;
+        memset(screenRowDirty, 1, sizeof(screenRowDirty));
+    }
+
+    // back 이 위로 밀렸으면 터미널도 같은 만큼 밀어서 다시 그릴 칸을 줄인다
+    if (screenScrolls > 0 && screenScrolls < screenRows) {
+        screenEmitMove(screenRows - 1, 0);
+        for (int i = 0; i < screenScrolls; i++) {
+            screenEmit("\n", 1);
+            screenScrollUp(screenFront);
+        }
+    }
+    screenScrolls = 0;
+
+    for (int r = 0; r < screenRows; r++) {
+        if (!screenRowDirty[r]) continue;
+        screenRowDirty[r] = 0;
+        screenDiffRow(r);
+    }
+    screenEmitMove(screenRow, screenCol < screenCols ? screenCol : screenCols - 1);
+
+    if (screenOutLen > 0) screenWriteOut();
+    screenFrames++;
+    screenDirty = 0;
+}
+
+// 이미 만들어 둔 글자를 그대로 그린다 (형식 문자열을 해석하지 않는다, ui_text.h)
+static void screenWrite(const char* s, int len) {
+    if (screenMode < 0) screenInit();
+    if (screenMode != 1) {
+        fwrite(s, 1, (size_t)len, stdout);
+        screenBytes += (unsigned long)len;
+    } else {
+        screenPut(s, len);
+    }
+}
+
+// printf 대신 사용
+__attribute__((format(printf, 1, 2)))
+static int screenPrintf(const char* format, ...) {
+    if (screenMode < 0) screenInit();
+    va_list args;
+    va_start(args, format);
+    int n;
+    if (screenMode != 1) {
+        n = vprintf(format, args);
+        if (n > 0) screenBytes += (unsigned long)n;
+    } else {
+        char buf[512];
+        va_list copy;
+        va_copy(copy, args);
+        n = vsnprintf(buf, sizeof(buf), format, args);
+        if (n >= (int)sizeof(buf)) {
+            char* big = malloc((size_t)n + 1);
+            if (big) {
+                vsnprintf(big, (size_t)n + 1, format, copy);
+                screenPut(big, n);
+                free(big);
+            }
+        } else if (n > 0) {
+            screenPut(buf, n);
+        }
+        va_end(copy);
+    }
+    va_end(args);
+    return n;
+}
+
+#endif
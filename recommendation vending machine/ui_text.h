@@ -0,0 +1,86 @@
+// 화면 글자 (결제 화면의 고정 안내문과 숫자 줄)
+//
+// 예전 printMessageStruct(Message) 는 108바이트 구조체를 값으로 받았고, 키를 누를 때마다
+// "받은 금액: %d원" 같은 줄 전체를 snprintf 로 다시 만들어 구조체에 넣고 또 복사했다.
+//
+//   UiText: 고정 안내문. 커서 이동과 줄 지우기 제어 문자열까지 컴파일할 때 한 문자열로 붙여 둔다 (UI_TEXT).
+//   UiLine: 숫자 하나가 들어가는 줄. 제어 문자열 + 앞 글자 + 숫자 + 뒤 글자를 버퍼에 만들어 두고
+//           숫자가 바뀌었을 때만 숫자 자리부터 다시 쓴다. 같은 값이면 아무것도 하지 않는다.
+// 둘 다 (글자, 길이) 로 screenWrite 에 그대로 넘긴다 (형식 문자열 해석도, 복사도 없다).
+#ifndef UI_TEXT_H
+#define UI_TEXT_H
+
+#include <string.h>
+#include "term_screen.h"
+
+#define UI_LINE_SIZE 160
+
+// row행 col열로 옮기고 줄 끝까지 지우는 제어 문자열 (row, col 은 숫자 상수)
+#define UI_AT(row, col) "\033[" #row ";" #col "H\033[K"
+
+typedef struct {
+    const char* text;  // 제어 문자열 포함
+    int len;
+} UiText;
+
+#define UI_TEXT(row, col, s) { UI_AT(row, col) s, (int)sizeof(UI_AT(row, col) s) - 1 }
+
+typedef struct {
+    char buf[UI_LINE_SIZE];
+    int len;
+    int head;             // 숫자(또는 글자)가 들어가는 위치
+    const char* tail;     // 숫자 뒤에 붙는 글자 ("원")
+    int tailLen;
+    int value, valid;     // 버퍼에 들어 있는 숫자
+} UiLine;
+
+// 앞 글자와 뒤 글자는 문자열 상수 (UI_LINE 참고)
+static inline void uiLineInit(UiLine* line, const char* head, int headLen, const char* tail, int tailLen) {
+    memcpy(line->buf, head, (size_t)headLen);
+    line->head = headLen;
+    line->len = headLen;
+    line->tail = tail;
+    line->tailLen = tailLen;
+    line->valid = 0;
+}
+
+#define UI_LINE(line, row, col, head, tail) \
+    uiLineInit((line), UI_AT(row, col) head, (int)sizeof(UI_AT(row, col) head) - 1, (tail), (int)sizeof(tail) - 1)
+
+// 10진수로 쓰고 길이를 돌려준다
+static inline int uiFormatInt(char* out, int value) {
+    char digits[12];
+    unsigned int v = value < 0 ? 0u - (unsigned int)value : (unsigned int)value;
+    int n = 0, len = 0;
+    do {
+        digits[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    if (value < 0) out[len++] = '-';
+    while (n > 0) out[len++] = digits[--n];
+    return len;
+}
+
+// 숫자가 바뀌었으면 버퍼를 고치고 1, 같으면 0
+static inline int uiLineSetNumber(UiLine* line, int value) {
+    if (line->valid && line->value == value) return 0;
+    int n = uiFormatInt(line->buf + line->head, value);
+    memcpy(line->buf + line->head + n, line->tail, (size_t)line->tailLen);
+    line->len = line->head + n + line->tailLen;
+    line->value = value;
+    line->valid = 1;
+    return 1;
+}
+
+// 숫자 대신 글자 (음료 이름, 입력 중인 숫자)
+static inline void uiLineSetText(UiLine* line, const char* text) {
+    int room = UI_LINE_SIZE - line->head - line->tailLen;
+    int n = (int)strlen(text);
+    if (n > room) n = room;
+    memcpy(line->buf + line->head, text, (size_t)n);
+    memcpy(line->buf + line->head + n, line->tail, (size_t)line->tailLen);
+    line->len = line->head + n + line->tailLen;
+    line->valid = 0;
+}
+
+#endif
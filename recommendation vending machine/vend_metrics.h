@@ -0,0 +1,166 @@
+// 자판기 운영 통계: 지연 히스토그램과 카운터
+// 판매 중에도 항상 켜져 있으며, 기록 한 번은 몇 개의 정수 연산이다.
+//
+// 통계 덤프 (판매를 멈추지 않음):
+//   kill -USR1 <자판기 pid>
+// 다음 키패드 폴링 때 vending_metrics.txt (VEND_METRICS_FILE 로 변경 가능) 끝에 덧붙인다.
+//
+// 히스토그램은 HDR 방식의 로그-선형 버킷을 쓴다.
+// 0~31us 는 1us 단위, 그 위로는 2의 거듭제곱 구간마다 16개 버킷 (상대 오차 약 6% 이하).
+//
+// Final.c 를 한 파일로 빌드할 수 있도록 구현도 이 헤더에 둔다. 한 번역 단위에서만 포함한다.
+#ifndef VEND_METRICS_H
+#define VEND_METRICS_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <wiringPi.h>
+
+enum VendHist {
+    HIST_KEY_ECHO,      // 키를 누른 순간부터 화면에 반응이 나타날 때까지
+    HIST_PAY_DISPENSE,  // 결제 요청(현금 E 키, 카드 읽기 시작)부터 음료 배출이 끝날 때까지
+    HIST_DHT_READ,      // DHT11 한 번 읽기
+    HIST_CDS_READ,      // PCF8591 CDS 값 읽기
+    HIST_COUNT
+};
+
+enum VendCounter {
+    CNT_DEBOUNCE_REJECT,  // 디바운스 시간 안에 원래 상태로 돌아간 키 변화
+    CNT_KEY_GHOST,        // 키패드 ghosting 으로 일부 키를 판정하지 못한 스캔
+    CNT_DHT_OK,
+    CNT_DHT_CHECKSUM,     // 40비트를 받았지만 체크섬 불일치
+    CNT_DHT_SHORT,        // 40비트를 다 받지 못함 (응답 없음, 타이밍 초과)
+    CNT_CASH_OK,
+    CNT_CASH_SHORT,       // 투입 금액 부족
+    CNT_CASH_NO_CHANGE,   // 거스름돈 부족
+    CNT_CARD_OK,
+    CNT_CARD_FAIL,
+    CNT_COUNT
+};
+
+#define HIST_SUB_BITS 4
+#define HIST_SUB      (1 << HIST_SUB_BITS)
+#define HIST_BUCKETS  ((32 - HIST_SUB_BITS) * HIST_SUB + HIST_SUB)
+
+typedef struct {
+    uint32_t buckets[HIST_BUCKETS];
+    uint32_t count;
+    uint32_t min, max;
+    uint64_t sum;
+} VendHistogram;
+
+static VendHistogram vendHists[HIST_COUNT];
+static uint32_t vendCounters[CNT_COUNT];
+static volatile sig_atomic_t vendDumpRequested = 0;
+static uint32_t vendKeyPressUs;   // 마지막 키를 처음 감지한 시각
+static int vendKeyUnechoed = 0;   // 반환했지만 아직 화면에 반영되지 않은 키
+
+static const char* const vendHistNames[HIST_COUNT] = {
+    "key_to_echo", "payment_to_dispense", "dht11_read", "cds_read"
+};
+static const char* const vendCounterNames[CNT_COUNT] = {
+    "debounce_reject", "keypad_ghosting", "dht11_ok", "dht11_checksum_fail", "dht11_short_frame",
+    "cash_ok", "cash_insufficient", "cash_no_change", "card_ok", "card_fail"
+};
+
+static int vendHistBucket(uint32_t us) {
+    if (us < 2 * HIST_SUB) return (int)us;
+    int shift = 31 - __builtin_clz(us) - HIST_SUB_BITS;
+    return shift * HIST_SUB + (int)(us >> shift);
+}
+
+// 버킷에 들어가는 가장 큰 값
+static uint32_t vendHistUpper(int bucket) {
+    if (bucket < 2 * HIST_SUB) return (uint32_t)bucket;
+    int shift = bucket / HIST_SUB - 1;
+    uint64_t upper = ((uint64_t)(bucket % HIST_SUB + HIST_SUB + 1) << shift) - 1;
+    return upper > UINT32_MAX ? UINT32_MAX : (uint32_t)upper;
+}
+
+static void vendMetricRecord(int hist, uint32_t us) {
+    VendHistogram* h = &vendHists[hist];
+    h->buckets[vendHistBucket(us)]++;
+    if (h->count == 0 || us < h->min) h->min = us;
+    if (us > h->max) h->max = us;
+    h->count++;
+    h->sum += us;
+}
+
+static void vendMetricCount(int counter) {
+    vendCounters[counter]++;
+}
+
+static void vendMetricCountAdd(int counter, uint32_t n) {
+    vendCounters[counter] += n;
+}
+
+// 키패드에서 키를 처음 감지했을 때 (atUs: micros() 시각) / 키를 반환할 때 / 화면을 갱신할 때
+static void vendMetricKeyPress(uint32_t atUs) {
+    vendKeyPressUs = atUs;
+}
+
+static void vendMetricKeyReturned(void) {
+    vendKeyUnechoed = 1;
+}
+
+static void vendMetricKeyEcho(void) {
+    if (!vendKeyUnechoed) return;
+    vendKeyUnechoed = 0;
+    vendMetricRecord(HIST_KEY_ECHO, micros() - vendKeyPressUs);
+}
+
+// p: 0~100
+static uint32_t vendHistPercentile(const VendHistogram* h, double p) {
+    if (h->count == 0) return 0;
+    uint64_t rank = (uint64_t)(p / 100.0 * h->count + 0.999999);
+    if (rank == 0) rank = 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+        seen += h->buckets[i];
+        if (seen >= rank) return vendHistUpper(i) < h->max ? vendHistUpper(i) : h->max;
+    }
+    return h->max;
+}
+
+static void vendMetricsDump(FILE* out) {
+    fprintf(out, "# vending metrics, uptime %.1fs\n", millis() / 1000.0);
+    fprintf(out, "%-22s %8s %10s %10s %10s %10s %10s %10s\n",
+            "histogram(ms)", "count", "min", "p50", "p90", "p99", "max", "mean");
+    for (int i = 0; i < HIST_COUNT; i++) {
+        const VendHistogram* h = &vendHists[i];
+        fprintf(out, "%-22s %8u %10.3f %10.3f %10.3f %10.3f %10.3f %10.3f\n",
+                vendHistNames[i], h->count, h->min / 1000.0,
+                vendHistPercentile(h, 50) / 1000.0, vendHistPercentile(h, 90) / 1000.0,
+                vendHistPercentile(h, 99) / 1000.0, h->max / 1000.0,
+                h->count ? (double)h->sum / h->count / 1000.0 : 0.0);
+    }
+    for (int i = 0; i < CNT_COUNT; i++) {
+        fprintf(out, "%-22s %8u\n", vendCounterNames[i], vendCounters[i]);
+    }
+    fprintf(out, "\n");
+    fflush(out);
+}
+
+static void vendMetricsSignal(int sig) {
+    (void)sig;
+    vendDumpRequested = 1;
+}
+
+static inline void vendMetricsInit(void) {
+    signal(SIGUSR1, vendMetricsSignal);
+}
+
+// 덤프 요청이 있으면 파일에 기록 (키패드 폴링마다 호출)
+static void vendMetricsPoll(void) {
+    if (!vendDumpRequested) return;
+    vendDumpRequested = 0;
+    const char* path = getenv("VEND_METRICS_FILE");
+    FILE* out = fopen(path && *path ? path : "vending_metrics.txt", "a");
+    if (out == NULL) return;
+    vendMetricsDump(out);
+    fclose(out);
+}
+
+#endif
@@ -0,0 +1,29 @@
+// 거래 단계 표시 (벤치마크용)
+// VEND_STAGE_HOOK 을 정의하고 빌드하면 각 단계의 시작/끝에서 vendStage* 함수가 호출된다.
+// 정의하지 않으면 아무 코드도 생성되지 않는다.
+#ifndef VEND_STAGE_H
+#define VEND_STAGE_H
+
+enum VendStage {
+    STAGE_KEY_SCAN,   // 키 스캔: readKeypad 가 키 이벤트를 기다려서 돌려줄 때까지 (디바운스 포함)
+    STAGE_RENDER,     // 화면 출력
+    STAGE_PAYMENT,    // 결제 판단: 결제 요청부터 성공/실패 결정까지
+    STAGE_DISPENSE,   // 음료 배출: 서보 동작, 잔돈 반환
+    STAGE_STOCK,      // 재고/잔고 갱신
+    STAGE_COUNT
+};
+
+#ifdef VEND_STAGE_HOOK
+void vendStageBegin(int stage);
+void vendStageEnd(int stage);
+void vendStageDrop(int stage);  // 시작한 단계를 기록하지 않고 취소
+#define STAGE_BEGIN(s) vendStageBegin(s)
+#define STAGE_END(s)   vendStageEnd(s)
+#define STAGE_DROP(s)  vendStageDrop(s)
+#else
+#define STAGE_BEGIN(s) ((void)0)
+#define STAGE_END(s)   ((void)0)
+#define STAGE_DROP(s)  ((void)0)
+#endif
+
+#endif
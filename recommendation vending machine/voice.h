@@ -0,0 +1,421 @@
+// 음성 안내 재생 (Final.c 의 "결제가 완료되었습니다", "품절입니다" 등)
+//
+// GPIO 18 의 하드웨어 PWM 을 8kHz PCM 출력으로 쓴다.
+//   분주 2 (19.2MHz / 2, pwm_alloc.h) 에서 범위 256 -> 반송파 37.5kHz (들리지 않는다)
+//   채널은 pwm_alloc.h 에서 받는다. 다른 채널(모터 GPIO 19)은 같은 37.5kHz 반송파로 같이 쓸 수 있다.
+//   샘플마다 값(0~255)을 pwmWrite 하면 스피커/버저와 RC 필터가 반송파를 걸러 샘플 값을 소리로 낸다.
+//
+// 안내 음성은 voice 디렉터리(VOICE_DIR)의 WAV 파일로, 미리 8000Hz 8비트 unsigned 모노 PCM 으로 바꿔 둔다.
+//   sox 원본.wav -r 8000 -c 1 -b 8 -e unsigned-integer paid.wav
+// 샘플 값이 곧 PWM 값이므로 출력 스레드는 변환 없이 그대로 쓴다.
+// 파일이 없거나 형식이 다르면 buzzer.h 의 소리를 같은 형식의 사각파로 만들어 울린다.
+//
+// 스레드 두 개 (piThreadCreate)
+//   공급 스레드: 파일을 VOICE_BLOCK 샘플씩 읽어 비어 있는 버퍼를 채운다.
+//   출력 스레드: 샘플 시각(125us)마다 깨어나 pwmWrite 한다. 정해진 시각은 시작 시각 기준이라 밀리지 않는다.
+// 버퍼 두 개를 번갈아 쓰므로 출력 스레드가 한 버퍼를 내보내는 동안 공급 스레드가 다음 버퍼를 채운다 (32ms 여유).
+// 다음 버퍼가 아직 차지 않았으면 버퍼 부족(underruns)으로 세고 찰 때까지 마지막 샘플을 유지한다.
+// voiceSay 는 바로 돌아오고, 재생 중에 새 안내를 넘기면 지금 안내를 끊는다.
+//
+// WAV 파일 디렉터리는 voiceBegin 의 dir, 없으면 VOICE_DIR 환경 변수, 그것도 없으면 voice 이다.
+// voice.buffers 를 1 로 두면 버퍼 하나로 재생한다 (비교 측정용, sim/bench_voice.c).
+//   출력 스레드가 버퍼를 비우면 공급 스레드가 채울 때까지 기다린다.
+// 시뮬레이션 보드에서는 SIM_WAV="18:voice.wav" 로 핀의 출력을 WAV 로 녹음할 수 있다.
+#ifndef VOICE_H
+#define VOICE_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wiringPi.h>
+#include "buzzer.h"
+#ifndef SIM_BOARD
+#include <semaphore.h>
+#include <time.h>
+#endif
+
+#define VOICE_RATE        8000
+#define VOICE_PERIOD_NS   (1000000000ULL / VOICE_RATE)
+#define VOICE_PWM_RANGE   256
+#define VOICE_CARRIER_HZ  (PWM_ALLOC_CLOCK_HZ / VOICE_PWM_RANGE)  // 37.5kHz
+#define VOICE_SILENCE     128                  // PCM 0 점 (쉬는 동안에도 이 값에 둔다)
+#define VOICE_GEN_MASK    0x7FFFFF             // 요청 번호는 요청 칸에 안내 번호와 같이 넣는다 (번호 << 8 | 안내)
+#define VOICE_BLOCK       256                  // 버퍼 하나의 샘플 수 (32ms)
+#define VOICE_OUT_PRIORITY  60                 // 키패드 스캐너보다 높게 (샘플 시각을 놓치면 소리가 찌그러진다)
+#define VOICE_FEED_PRIORITY 10
+#define VOICE_IDLE_MS     5                    // 시뮬레이션 보드에서 새 안내를 다시 확인하는 간격
+
+// 안내 종류
+#define VOICE_INPUT     0  // 키 입력 (소리만)
+#define VOICE_PAID      1  // 결제가 완료되었습니다
+#define VOICE_SOLD_OUT  2  // 품절입니다
+#define VOICE_SHORT     3  // 금액이 부족합니다
+#define VOICE_FAILED    4  // 결제에 실패했습니다
+#define VOICE_CARD      5  // 카드 인식 대기 (소리만)
+#define VOICE_COUNT     6
+
+typedef struct {
+    const char* file;          // VOICE_DIR 안의 파일 (NULL: 소리만)
+    const BuzzerSound* beep;   // 파일이 없을 때 (또는 voiceBegin 을 부르지 않았을 때)
+} VoicePromptDef;
+
+static const VoicePromptDef voicePromptDefs[VOICE_COUNT] = {
+    [VOICE_INPUT]    = { NULL, &buzzerInputSound },
+    [VOICE_PAID]     = { "paid.wav", &buzzerSuccessSound },
+    [VOICE_SOLD_OUT] = { "soldout.wav", &buzzerFailureSound },
+    [VOICE_SHORT]    = { "short.wav", &buzzerFailureSound },
+    [VOICE_FAILED]   = { "failed.wav", &buzzerFailureSound },
+    [VOICE_CARD]     = { NULL, &buzzerCardSound },
+};
+
+typedef struct {
+    char path[256];            // 파일 안내 ("" 이면 samples)
+    long offset;               // 파일에서 PCM 이 시작하는 위치
+    unsigned char* samples;    // 합성한 소리
+    int length;                // 샘플 수
+} VoicePrompt;
+
+typedef struct {
+    unsigned char samples[VOICE_BLOCK];
+    int count;
+    int last;                  // 안내의 마지막 블록
+    unsigned int gen;          // 채울 때의 요청 번호 (voiceSay 마다 바뀐다)
+    atomic_int full;
+} VoiceBuffer;
+
+typedef struct {
+    int pin, started, buffers;  // buffers: 1 또는 2 (그 밖의 값은 voiceBegin 이 2 로)
+    PwmOut out;
+    VoicePrompt prompts[VOICE_COUNT];
+    VoiceBuffer buf[2];
+    atomic_int request;        // 공급 스레드가 아직 가져가지 않은 요청 번호 << 8 | 안내 (-1: 없음)
+    atomic_uint gen;           // 마지막 요청 번호 (VOICE_GEN_MASK 안에서 돈다)
+    atomic_int feeding;        // 공급 스레드가 안내를 읽는 중
+    atomic_int playing;
+    // 통계
+    atomic_ulong said, cut;    // 넘긴 안내, 끝나기 전에 끊긴 안내
+    atomic_ulong blocks, underruns;
+    atomic_ulong samples, late;  // 내보낸 샘플, 한 샘플 넘게 늦어서 시각을 다시 맞춘 횟수
+    atomic_ulong maxLateNs;    // 정해진 시각보다 가장 늦게 쓴 샘플
+    atomic_ullong cpuNs;       // 출력 스레드가 쓴 CPU 시간
+} Voice;
+
+static Voice voice = { .request = -1 };
+#ifndef SIM_BOARD
+static sem_t voiceFeedSem;  // 빈 버퍼, 새 안내 -> 공급 스레드
+static sem_t voiceOutSem;   // 찬 버퍼 -> 출력 스레드
+#endif
+
+//1. 시각과 대기
+static inline unsigned int voiceGen(void) {
+    return atomic_load(&voice.gen) & VOICE_GEN_MASK;
+}
+
+static uint64_t voiceNowNs(void) {
+#ifdef SIM_BOARD
+    return simNowNs();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+// 출력 스레드: 샘플 시각까지 잔다
+static void voiceSleepUntil(uint64_t deadline) {
+#ifdef SIM_BOARD
+    uint64_t now = simNowNs();
+    if (deadline > now) delayMicroseconds((unsigned int)((deadline - now + 999) / 1000));
+#else
+    struct timespec ts = { (time_t)(deadline / 1000000000ULL), (long)(deadline % 1000000000ULL) };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0);
+#endif
+}
+
+// 출력 스레드: 찬 버퍼를 기다린다 (재생 중이면 한 샘플 간격으로 다시 확인)
+static void voiceWaitFull(int playing) {
+#ifdef SIM_BOARD
+    if (playing) delayMicroseconds((unsigned int)(VOICE_PERIOD_NS / 1000));
+    else delay(VOICE_IDLE_MS);
+#else
+    (void)playing;
+    sem_wait(&voiceOutSem);
+#endif
+}
+
+// 공급 스레드: 빈 버퍼나 새 안내를 기다린다
+static void voiceWaitFeed(int streaming) {
+#ifdef SIM_BOARD
+    delay(streaming ? 1 : VOICE_IDLE_MS);
+#else
+    (void)streaming;
+    sem_wait(&voiceFeedSem);
+#endif
+}
+
+static void voicePostFeed(void) {
+#ifndef SIM_BOARD
+    sem_post(&voiceFeedSem);
+#endif
+}
+
+static void voicePostOut(void) {
+#ifndef SIM_BOARD
+    sem_post(&voiceOutSem);
+#endif
+}
+
+//2. 안내 준비
+static uint32_t voiceLe(const unsigned char* p, int bytes) {
+    uint32_t v = 0;
+    for (int i = bytes - 1; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+
+// 8000Hz 8비트 모노 PCM WAV 이면 PCM 위치와 샘플 수를 채우고 0
+static int voiceOpenWav(VoicePrompt* prompt, const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) return -1;
+    unsigned char head[12], chunk[8], fmt[16];
+    int ok = 0, hasFmt = 0;
+    if (fread(head, 1, 12, f) == 12 && memcmp(head, "RIFF", 4) == 0 && memcmp(head + 8, "WAVE", 4) == 0) {
+        while (fread(chunk, 1, 8, f) == 8) {
+            uint32_t size = voiceLe(chunk + 4, 4);
+            if (memcmp(chunk, "fmt ", 4) == 0 && size >= 16) {
+                if (fread(fmt, 1, 16, f) != 16) break;
+                hasFmt = voiceLe(fmt, 2) == 1 && voiceLe(fmt + 2, 2) == 1 &&
+                         voiceLe(fmt + 4, 4) == VOICE_RATE && voiceLe(fmt + 14, 2) == 8;
+                if (fseek(f, (long)(size - 16 + (size & 1)), SEEK_CUR) != 0) break;
+            } else if (memcmp(chunk, "data", 4) == 0) {
+                if (hasFmt && size > 0) {
+                    snprintf(prompt->path, sizeof(prompt->path), "%s", path);
+                    prompt->offset = ftell(f);
+                    prompt->length = (int)size;
+                    ok = 1;
+                }
+                break;
+            } else if (fseek(f, (long)(size + (size & 1)), SEEK_CUR) != 0) {
+                break;
+            }
+        }
+    }
+    fclose(f);
+    if (!ok) fprintf(stderr, "voice: %s 는 8000Hz 8비트 모노 PCM WAV 가 아닙니다, 소리로 울립니다\n", path);
+    return ok ? 0 : -1;
+}
+
+// buzzer.h 의 소리를 PCM 사각파로 만든다
+static int voiceSynth(VoicePrompt* prompt, const BuzzerSound* sound) {
+    int length = 0;
+    for (int i = 0; i < sound->count; i++) length += sound->notes[i].ms * (VOICE_RATE / 1000);
+    prompt->samples = malloc((size_t)length);
+    if (prompt->samples == NULL) return -1;
+    int pos = 0;
+    for (int i = 0; i < sound->count; i++) {
+        const BuzzerNote* note = &sound->notes[i];
+        unsigned int phase = 0;
+        for (int n = 0; n < note->ms * (VOICE_RATE / 1000); n++) {
+            if (note->hz == 0) {
+                prompt->samples[pos++] = VOICE_SILENCE;
+                continue;
+            }
+            prompt->samples[pos++] = phase < VOICE_RATE / 2 ? 255 : 1;
+            phase = (phase + note->hz) % VOICE_RATE;
+        }
+    }
+    prompt->path[0] = '\0';
+    prompt->length = length;
+    return 0;
+}
+
+//3. 공급 스레드
+static PI_THREAD(voiceFeeder) {
+    piHiPri(VOICE_FEED_PRIORITY);
+    FILE* f = NULL;
+    const VoicePrompt* prompt = NULL;
+    int pos = 0, fill = 0;
+    unsigned int gen = 0;
+    while (1) {
+        int req = -1;
+        if (atomic_load(&voice.request) >= 0) {
+            atomic_store(&voice.feeding, 1);  // 요청을 가져가는 사이에도 바쁜 것으로 보이도록 먼저
+            req = atomic_exchange(&voice.request, -1);
+        }
+        if (req >= 0) {
+            if (f) fclose(f);
+            f = NULL;
+            prompt = &voice.prompts[req & 0xFF];
+            gen = (unsigned int)req >> 8;  // 안내와 같이 가져오므로 그 사이의 voiceSay 와 섞이지 않는다
+            pos = 0;
+            if (prompt->path[0] && ((f = fopen(prompt->path, "rb")) == NULL || fseek(f, prompt->offset, SEEK_SET) != 0)) {
+                prompt = NULL;  // 시작할 때는 있던 파일이 없어졌다
+            }
+            if (prompt == NULL) atomic_store(&voice.feeding, 0);
+        }
+        VoiceBuffer* b = &voice.buf[fill];
+        if (prompt == NULL || atomic_load(&b->full)) {
+            voiceWaitFeed(prompt != NULL);
+            continue;
+        }
+
+        int count = prompt->length - pos < VOICE_BLOCK ? prompt->length - pos : VOICE_BLOCK;
+        if (f) count = (int)fread(b->samples, 1, (size_t)count, f);
+        else memcpy(b->samples, prompt->samples + pos, (size_t)count);
+        pos += count;
+        b->count = count;
+        b->last = (pos >= prompt->length || count == 0);
+        b->gen = gen;
+        atomic_store(&b->full, 1);
+        voicePostOut();
+        fill = (fill + 1) % voice.buffers;
+        if (b->last) {
+            if (f) fclose(f);
+            f = NULL;
+            prompt = NULL;
+            atomic_store(&voice.feeding, 0);
+        }
+    }
+    return NULL;
+}
+
+//4. 출력 스레드
+static PI_THREAD(voiceOutput) {
+    piHiPri(VOICE_OUT_PRIORITY);
+    int cur = 0, playing = 0, starved = 0;
+    uint64_t deadline = 0;
+    while (1) {
+        VoiceBuffer* b = &voice.buf[cur];
+        if (!atomic_load(&b->full)) {
+            if (playing && !starved) {
+                atomic_fetch_add(&voice.underruns, 1);  // 마지막 샘플을 유지한 채 기다린다
+                starved = 1;
+            }
+            voiceWaitFull(playing);
+            continue;
+        }
+        if (b->gen != voiceGen()) {  // 끊긴 안내의 버퍼는 버린다
+            if (playing) atomic_fetch_add(&voice.cut, 1);
+            playing = 0;
+        } else {
+            if (!playing || starved) deadline = voiceNowNs();  // 첫 샘플, 또는 버퍼 부족 뒤에는 지금부터
+            playing = 1;
+            starved = 0;
+            atomic_store(&voice.playing, 1);
+            for (int i = 0; i < b->count; i++) {
+                if (b->gen != voiceGen()) break;
+                voiceSleepUntil(deadline);
+                uint64_t wake = voiceNowNs();
+                uint64_t lateNs = wake - deadline;
+                if (lateNs > atomic_load(&voice.maxLateNs)) atomic_store(&voice.maxLateNs, lateNs);
+                pwmWrite(voice.pin, b->samples[i]);
+                if (lateNs > VOICE_PERIOD_NS) {
+                    deadline = wake;  // 한 샘플 넘게 늦었으면 밀린 샘플을 몰아 쓰지 않고 지금부터 다시
+                    atomic_fetch_add(&voice.late, 1);
+                }
+                deadline += VOICE_PERIOD_NS;
+                atomic_fetch_add(&voice.samples, 1);
+#ifdef SIM_BOARD
+                atomic_fetch_add(&voice.cpuNs, voiceNowNs() - wake);
+#endif
+            }
+            atomic_fetch_add(&voice.blocks, 1);
+            if (b->gen != voiceGen()) {  // 블록 중간에 끊겼다
+                atomic_fetch_add(&voice.cut, 1);
+                playing = 0;
+            }
+        }
+#ifndef SIM_BOARD
+        struct timespec cpu;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu);
+        atomic_store(&voice.cpuNs, (uint64_t)cpu.tv_sec * 1000000000ULL + (uint64_t)cpu.tv_nsec);
+#endif
+        int last = b->last && playing;
+        atomic_store(&b->full, 0);
+        voicePostFeed();
+        cur = (cur + 1) % voice.buffers;
+        if (last) {
+            voiceSleepUntil(deadline);  // 마지막 샘플 길이만큼 울린 뒤 0 점으로 (0 으로 내리면 딸깍 소리가 난다)
+            pwmWrite(voice.pin, VOICE_SILENCE);
+            playing = 0;
+        }
+        if (!playing && atomic_load(&voice.request) < 0 && !atomic_load(&voice.feeding) &&
+            !atomic_load(&voice.buf[cur].full)) {
+            atomic_store(&voice.playing, 0);
+        }
+    }
+    return NULL;
+}
+
+// 안내 파일을 확인하고 PWM 과 스레드를 준비한다. 음성을 쓰지 않으면 -1 (buzzerBegin 으로 울린다)
+// dir 이 NULL 이면 VOICE_DIR 환경 변수, 그것도 없으면 "voice"
+static inline int voiceBegin(int pin, const char* dir) {
+    if (voice.started) return 0;
+    if (pwmChannelOf(pin) < 0) return -1;  // 하드웨어 PWM 핀만
+    if (dir == NULL) dir = getenv("VOICE_DIR");
+    if (dir == NULL) dir = "voice";
+    if (voice.buffers != 1) voice.buffers = 2;
+
+    int files = 0, wanted = 0;
+    for (int i = 0; i < VOICE_COUNT; i++) {
+        const VoicePromptDef* def = &voicePromptDefs[i];
+        VoicePrompt* prompt = &voice.prompts[i];
+        if (prompt->length > 0) continue;  // 스레드를 만들지 못한 뒤 다시 부를 때
+        if (def->file) {
+            wanted++;
+            char path[256];
+            snprintf(path, sizeof(path), "%s/%s", dir, def->file);
+            if (voiceOpenWav(prompt, path) == 0) {
+                files++;
+                continue;
+            }
+        }
+        if (voiceSynth(prompt, def->beep) != 0) return -1;
+    }
+
+    if (pwmOutOpen(&voice.out, "음성", pin, VOICE_CARRIER_HZ, VOICE_CARRIER_HZ, 0) != 0) {
+        fprintf(stderr, "음성: GPIO %d 의 PWM 채널을 쓸 수 없습니다, 버저로 울립니다\n", pin);
+        return -1;
+    }
+    voice.pin = pin;
+    pwmWrite(pin, VOICE_SILENCE);  // 첫 안내가 0 에서 튀어 오르지 않도록
+
+#ifndef SIM_BOARD
+    sem_init(&voiceFeedSem, 0, 0);
+    sem_init(&voiceOutSem, 0, 0);
+#endif
+    if (piThreadCreate(voiceFeeder) != 0 || piThreadCreate(voiceOutput) != 0) {
+        fprintf(stderr, "음성 스레드 생성 실패, 버저로 울립니다\n");
+        pwmOutClose(&voice.out);
+        return -1;  // 공급 스레드만 떠 있으면 요청이 없으니 잠들어 있다
+    }
+    voice.started = 1;
+    if (files < wanted) fprintf(stderr, "voice: %s 에서 안내 음성 %d개를 찾았습니다 (없는 안내는 소리로 울립니다)\n", dir, files);
+    return 0;
+}
+
+//5. 안내 넘기기
+// 바로 돌아온다. voiceBegin 을 하지 않았거나 실패했으면 buzzer.h 로 울린다
+static inline void voiceSay(int id) {
+    if (id < 0 || id >= VOICE_COUNT) return;
+    if (!voice.started) {
+        buzzerPlay(voicePromptDefs[id].beep);
+        return;
+    }
+    atomic_fetch_add(&voice.said, 1);
+    unsigned int gen = (atomic_fetch_add(&voice.gen, 1) + 1) & VOICE_GEN_MASK;
+    atomic_store(&voice.playing, 1);
+    int req = (int)(gen << 8) | id;
+    if (atomic_exchange(&voice.request, req) >= 0) atomic_fetch_add(&voice.cut, 1);  // 시작하기 전에 바뀐 안내
+    voicePostFeed();
+    voicePostOut();  // 출력 스레드가 끊긴 버퍼를 버리도록
+}
+
+// 울리고 있거나 넘긴 안내가 있으면 1
+static inline int voiceBusy(void) {
+    if (!voice.started) return buzzerBusy();
+    return atomic_load(&voice.playing);
+}
+
+#endif
@@ -0,0 +1,330 @@
+// 센서 디코더 벤치마크
+// 잡음이 있는 가상 주변장치 신호(sim_board, sim_signal)를 실제 디코더 코드에 넣고
+// 조건별 디코딩 성공률과 한 번 읽는 데 드는 비용을 출력한다.
+//
+// 빌드 및 실행 (저장소 최상위에서):
+//   gcc -O2 -Isim/include sim/bench_decoders.c sim/lab_decoders.c sim/sim_board.c sim/sim_signal.c -lm -o bench_decoders
+//   ./bench_decoders [조건별 반복 횟수]
+//
+// 대상 디코더
+//   키패드   readKeypad      recommendation vending machine/Final.c
+//   DHT11    read_dht11_dat  Lab/Week9(Sensor Control 1)/dht11.c
+//   HC-SR04  getDistance     Lab/Week10(Sensor Control 2)/hc-sr04.c, ex4.c
+//   MCP3208  ReadMcp3208ADC  Lab/Week9(Sensor Control 1)/ilum.c
+//
+// 항상 가상 시계로 실행한다. 잡음은 SIM_SEED 로 고정할 수 있다.
+// ok%    : 디코딩 성공률 (기준은 디코더별 제목 참고)
+// hang   : 끝나지 않는 대기 루프에 빠진 횟수 (1초 가상 시간으로 판정)
+// sim us : 한 번 읽는 데 걸린 가상 시간 (delay, 대기 루프 포함)
+// wall us: 이 PC에서 디코더 코드를 실행하는 데 든 실제 시간
+#define VENDING_NO_MAIN
+#include "../recommendation vending machine/Final.c"
+#include "sim_signal.h"
+
+#include <math.h>
+#include <setjmp.h>
+#include <time.h>
+
+// lab_decoders.c
+void labReadDht11(void);
+extern int labDht11Dat[5];
+float hcsr04GetDistance(void);
+float ex4GetDistance(void);
+int ReadMcp3208ADC(unsigned char adcChannel);
+
+typedef struct {
+    int trials;
+    int ok;
+    int hang;            // 끝나지 않는 대기 루프
+    int fail[2];         // 디코더별 실패 종류 (printResult 의 note 참고)
+    uint64_t simNs, wallNs;
+    double errSum, errMax;
+} Result;
+
+static FILE* out;
+static jmp_buf stallJump;
+
+static uint64_t wallNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void onStall(int pin) {
+    (void)pin;
+    longjmp(stallJump, 1);
+}
+
+// 한글은 화면에서 두 칸을 차지하므로 표시 폭 기준으로 왼쪽 정렬
+static void printName(const char* name, int width) {
+    int cols = 0;
+    for (const unsigned char* p = (const unsigned char*)name; *p; p++) {
+        if ((*p & 0xC0) == 0x80) continue;  // UTF-8 연속 바이트
+        cols += (*p >= 0xEA && *p <= 0xED) ? 2 : 1;  // 한글 음절(U+AC00~)만 두 칸
+    }
+    fprintf(out, "  %s%*s", name, cols < width ? width - cols : 0, "");
+}
+
+static void printHeader(const char* title) {
+    fprintf(out, "%s\n", title);
+    printName("조건", 28);
+    fprintf(out, " %6s %7s %5s %10s %8s  %s\n", "count", "ok%", "hang", "sim us", "wall us", "실패 내역");
+}
+
+static void printResult(const char* name, const Result* r, const char* note) {
+    int n = r->trials ? r->trials : 1;
+    printName(name, 28);
+    fprintf(out, " %6d %6.1f%% %5d %10.1f %8.2f  %s\n", r->trials, 100.0 * r->ok / n, r->hang,
+            r->simNs / 1e3 / n, r->wallNs / 1e3 / n, note);
+}
+
+
+//1. 키패드: 접점 떨림
+static void benchKeypad(int trials) {
+    static const int bounceMs[] = { 0, 1, 5, 20, 50, 80, 120 };
+    static const char keyOrder[] = "123A456B789CH0ED";
+
+    simKeypadAttach(rowPins, colPins, keys);
+    simKeypadTiming(150, 150);
+    setupKeypadPins();
+    printHeader("키패드 readKeypad (Final.c), 150ms 누름");
+
+    for (size_t b = 0; b < sizeof(bounceMs) / sizeof(bounceMs[0]); b++) {
+        Result r = { 0 };
+        simKeypadBounce(bounceMs[b] * 1000);
+        for (int i = 0; i < trials; i++) {
+            char expect = keyOrder[simRandom() % 16];
+            char script[2] = { expect, '\0' };
+            simKeypadScript(script);
+
+            uint64_t simStart = simNowNs(), wallStart = wallNow();
+            uint64_t simEnd = 0, wallEnd = 0, doneAt = 0;
+            char first = '\0';
+            int got = 0;
+            // 키를 뗀 뒤에도 떨림으로 인한 중복 입력이 있는지 300ms 더 읽는다
+            while (doneAt == 0 || simNowNs() - doneAt < 300000000ULL) {
+                char c = readKeypad();
+                if (c != '\0' && got++ == 0) {
+                    first = c;
+                    simEnd = simNowNs();
+                    wallEnd = wallNow();
+                }
+                if (doneAt == 0 && simKeypadPending() == 0) doneAt = simNowNs();
+            }
+            if (got == 0) {
+                simEnd = simNowNs();
+                wallEnd = wallNow();
+            }
+
+            r.trials++;
+            r.simNs += simEnd - simStart;
+            r.wallNs += wallEnd - wallStart;
+            if (got == 1 && first == expect) r.ok++;
+            else if (got == 0) r.fail[0]++;
+            else r.fail[1]++;
+        }
+
+        char name[64], note[64];
+        snprintf(name, sizeof(name), "떨림 %dms", bounceMs[b]);
+        snprintf(note, sizeof(note), "놓침 %d, 중복/오인 %d", r.fail[0], r.fail[1]);
+        printResult(name, &r, note);
+    }
+    simKeypadBounce(0);
+    fprintf(out, "\n");
+}
+
+
+//2. DHT11: 파형 흔들림과 선점
+typedef struct {
+    const char* name;
+    int jitterUs;
+    unsigned int preemptPerSec, preemptUs;
+} DhtCondition;
+
+static void benchDht11(int trials) {
+    static const DhtCondition conds[] = {
+        { "깨끗한 파형",             0,  0,    0 },
+        { "흔들림 +-5us",            5,  0,    0 },
+        { "흔들림 +-10us",          10,  0,    0 },
+        { "흔들림 +-20us",          20,  0,    0 },
+        { "선점 10/s x 50us",        0, 10,   50 },
+        { "선점 10/s x 2ms",         0, 10, 2000 },
+        { "흔들림 5us + 선점 50us",  5, 10,   50 },
+    };
+
+    printHeader("DHT11 read_dht11_dat (dht11.c)");
+    for (size_t c = 0; c < sizeof(conds) / sizeof(conds[0]); c++) {
+        Result r = { 0 };
+        simDht11Jitter(conds[c].jitterUs);
+        simSetPreemption(conds[c].preemptPerSec, conds[c].preemptUs);
+        for (int i = 0; i < trials; i++) {
+            int humi = 20 + (int)(simRandom() % 70);
+            int temp = (int)(simRandom() % 50);
+            simDht11Set(humi, 0, temp, 0);
+
+            uint64_t simStart = simNowNs(), wallStart = wallNow();
+            labReadDht11();
+            r.simNs += simNowNs() - simStart;
+            r.wallNs += wallNow() - wallStart;
+            r.trials++;
+
+            int* d = labDht11Dat;
+            int valid = d[4] == ((d[0] + d[1] + d[2] + d[3]) & 0xff);
+            if (valid && d[0] == humi && d[1] == 0 && d[2] == temp && d[3] == 0) r.ok++;
+            else if (!valid) r.fail[0]++;
+            else r.fail[1]++;
+            delay(1000);  // 센서 최소 측정 간격
+        }
+
+        char note[64];
+        snprintf(note, sizeof(note), "체크섬 실패 %d, 잘못된 값 통과 %d", r.fail[0], r.fail[1]);
+        printResult(conds[c].name, &r, note);
+    }
+    simDht11Jitter(0);
+    simSetPreemption(0, 0);
+    fprintf(out, "\n");
+}
+
+
+//3. HC-SR04: 에코 흔들림, 유실, 선점
+typedef struct {
+    const char* name;
+    int jitterUs;
+    int lossPerMillion, lossMode;
+    unsigned int preemptPerSec, preemptUs;
+} EchoCondition;
+
+// 끝나지 않는 대기 루프에 빠지면 0
+static int measureDistance(float (*decode)(void), float* distance) {
+    if (setjmp(stallJump) != 0) return 0;
+    *distance = decode();
+    return 1;
+}
+
+static void benchHcsr04(const char* title, float (*decode)(void), int trigPin, int echoPin, int trials) {
+    static const EchoCondition conds[] = {
+        { "깨끗한 에코",             0,     0, SIM_ECHO_TIMEOUT,  0,    0 },
+        { "흔들림 +-30us",          30,     0, SIM_ECHO_TIMEOUT,  0,    0 },
+        { "선점 10/s x 200us",       0,     0, SIM_ECHO_TIMEOUT, 10,  200 },
+        { "유실 1% (38ms 펄스)",     0, 10000, SIM_ECHO_TIMEOUT,  0,    0 },
+        { "유실 1% (에코 없음)",     0, 10000, SIM_ECHO_STUCK,    0,    0 },
+    };
+    SimHcsr04 sensor = { 0 };
+
+    pinMode(trigPin, OUTPUT);
+    pinMode(echoPin, INPUT);
+    simHcsr04Attach(&sensor, trigPin, echoPin);
+    printHeader(title);
+
+    for (size_t c = 0; c < sizeof(conds) / sizeof(conds[0]); c++) {
+        Result r = { 0 };
+        simSetPreemption(conds[c].preemptPerSec, conds[c].preemptUs);
+        for (int i = 0; i < trials; i++) {
+            double truth = 2.0 + (double)(simRandom() % 3980) / 10.0;  // 2cm ~ 400cm
+            simHcsr04Set(&sensor, truth, conds[c].jitterUs, conds[c].lossPerMillion, conds[c].lossMode);
+
+            float distance = 0;
+            uint64_t simStart = simNowNs(), wallStart = wallNow();
+            int done = measureDistance(decode, &distance);
+            r.simNs += simNowNs() - simStart;
+            r.wallNs += wallNow() - wallStart;
+            r.trials++;
+
+            if (!done) {
+                r.hang++;
+            } else {
+                double err = fabs(distance - truth);
+                r.errSum += err;
+                if (err > r.errMax) r.errMax = err;
+                // 모델의 음속은 343m/s(20도), 실습 코드는 340m/s 로 계산하므로 1% 까지는 허용
+                if (err <= 1.0 + truth * 0.01) r.ok++;
+                else r.fail[0]++;
+            }
+            delay(60);  // 센서 권장 측정 간격
+        }
+
+        char note[80];
+        snprintf(note, sizeof(note), "오차 초과 %d, 최대 오차 %.1fcm", r.fail[0], r.errMax);
+        printResult(conds[c].name, &r, note);
+    }
+    simSetPreemption(0, 0);
+    fprintf(out, "\n");
+}
+
+
+//4. MCP3208: 잡음이 있는 ADC 값
+typedef struct {
+    const char* name;
+    double sigma;
+    unsigned int spikePerMillion;
+} AdcCondition;
+
+static void benchMcp3208(int trials) {
+    static const AdcCondition conds[] = {
+        { "잡음 없음",               0,    0 },
+        { "가우스 sigma 2LSB",       2,    0 },
+        { "가우스 sigma 8LSB",       8,    0 },
+        { "가우스 sigma 32LSB",     32,    0 },
+        { "sigma 2LSB + 튐 0.1%",    2, 1000 },
+    };
+    const int tolerance = 8;  // 성공: 참값 +-8 LSB (0.2%) 이내
+
+    wiringPiSPISetup(SPI_CHANNEL, SPI_SPEED);
+    pinMode(CS_MCP3208, OUTPUT);
+    printHeader("MCP3208 ReadMcp3208ADC (ilum.c), 성공: +-8 LSB");
+
+    for (size_t c = 0; c < sizeof(conds) / sizeof(conds[0]); c++) {
+        Result r = { 0 };
+        simMcp3208Noise(0, conds[c].sigma, conds[c].spikePerMillion);
+        for (int i = 0; i < trials; i++) {
+            int truth = 100 + (int)(simRandom() % 3896);
+            simMcp3208Set(0, truth);
+
+            uint64_t simStart = simNowNs(), wallStart = wallNow();
+            int value = ReadMcp3208ADC(0);
+            r.simNs += simNowNs() - simStart;
+            r.wallNs += wallNow() - wallStart;
+            r.trials++;
+
+            double err = fabs((double)(value - truth));
+            r.errSum += err;
+            if (err > r.errMax) r.errMax = err;
+            if (err <= tolerance) r.ok++;
+        }
+
+        char note[80];
+        snprintf(note, sizeof(note), "평균 오차 %.2f LSB, 최대 %.0f LSB", r.errSum / r.trials, r.errMax);
+        printResult(conds[c].name, &r, note);
+    }
+    simMcp3208Noise(0, 0, 0);
+    fprintf(out, "\n");
+}
+
+
+int main(int argc, char* argv[]) {
+    int trials = (argc > 1) ? atoi(argv[1]) : 1000;
+    if (trials <= 0) trials = 1000;
+
+    simClockMode(SIM_CLOCK_VIRTUAL);
+    if (wiringPiSetupGpio() == -1) {
+        printf("GPIO 초기화 실패\n");
+        return 1;
+    }
+    simSetStallHandler(1000, onStall);  // 1초(가상) 동안 끝나지 않는 대기 루프는 멈춤으로 센다
+
+    // 디코더가 출력하는 측정값은 버리고 결과만 원래 표준 출력으로 보낸다
+    out = fdopen(dup(STDOUT_FILENO), "w");
+    if (out == NULL || freopen("/dev/null", "w", stdout) == NULL) {
+        fprintf(stderr, "표준 출력 전환 실패\n");
+        return 1;
+    }
+
+    fprintf(out, "센서 디코더 벤치마크 (가상 시계, 조건별 %d회)\n\n", trials);
+    benchKeypad(trials);
+    benchDht11(trials);
+    benchHcsr04("HC-SR04 getDistance (hc-sr04.c), 성공: +-(1cm + 1%)", hcsr04GetDistance, 12, 16, trials);
+    benchHcsr04("HC-SR04 getDistance (ex4.c), 성공: +-(1cm + 1%)", ex4GetDistance, 27, 22, trials);
+    benchMcp3208(trials);
+    fflush(out);
+    return 0;
+}
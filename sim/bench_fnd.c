@@ -0,0 +1,153 @@
+// FND 갱신 벤치마크
+//   Week7 fnd.c, fnd2.c 의 main 을 그대로 실행하고, FND 모델(SimFnd)로 자리마다 켜지는 주기와 잔상을 잰다.
+//   같은 프로그램을 갱신 스레드가 GPSET0/GPCLR0 로 쓸 때와 digitalWrite 로 핀마다 쓸 때로 나눠 비교한다.
+//
+// 빌드 및 실행 (저장소 최상위에서):
+//   gcc -O2 -Isim/include sim/bench_fnd.c sim/sim_board.c sim/sim_signal.c -lm -o bench_fnd
+//   ./bench_fnd [조건별 가상 시간 초]
+//
+// 항상 가상 시계로 실행한다 (보드 함수 호출 한 번에 100ns).
+// 갱신 Hz: 자리마다 1초에 켜진 횟수 (가장 적은 자리, 60 이상이면 깜박임이 보이지 않는다)
+// 최대 간격: 한 자리가 다시 켜지기까지 가장 오래 걸린 시간 (ms)
+// 켜짐 %  : 자리마다 켜져 있던 시간 비율 (가장 짧은 자리 / 가장 긴 자리, 1/6 = 16.7% 가 최대)
+// 쓰기/자리: 한 자리를 바꿀 때 핀 또는 레지스터에 쓴 횟수
+// 잔상    : 한 자리가 켜진 동안 패턴이 바뀌었거나 두 자리가 함께 켜진 구간
+// 늦음    : 갱신 스레드가 한 자리 넘게 늦게 깨어나 기준 시각을 다시 맞춘 횟수
+// 화면    : 끝난 뒤 자리마다 마지막으로 보인 패턴이 프로그램이 마지막으로 넘긴 글자와 같은지
+#include "../Lab/fnd_refresh.h"
+#include "sim_signal.h"
+
+#include <setjmp.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+static void benchDelay(unsigned int ms);
+
+// 실습 코드의 delay 는 benchDelay 로 바꿔서 측정 시간이 끝나면 main 을 빠져나온다
+#define delay benchDelay
+
+#define main fndMain
+#define FndSel fndSel
+#define FndNumberTable fndNumberTable
+#define FndPinTable fndPinTable
+#include "../Lab/Week7(Device Control 3)/fnd.c"
+#undef main
+#undef FndSel
+#undef FndNumberTable
+#undef FndPinTable
+
+// 핀 번호와 비트 정의는 fnd.c 와 같다
+#define main fnd2Main
+#define FndSel fnd2Sel
+#define FndNumberTable fnd2NumberTable
+#define FndPinTable fnd2PinTable
+#include "../Lab/Week7(Device Control 3)/fnd2.c"
+#undef main
+#undef FndSel
+#undef FndNumberTable
+#undef FndPinTable
+
+#undef delay
+
+static FILE* out;
+static jmp_buf benchEnd;
+static uint64_t benchStopNs;
+static SimFnd fnd;
+
+static void benchDelay(unsigned int ms) {
+    if (simNowNs() >= benchStopNs) longjmp(benchEnd, 1);
+    delay(ms);
+}
+
+// 한글은 화면에서 두 칸을 차지하므로 표시 폭 기준으로 왼쪽 정렬
+static void printName(const char* name, int width) {
+    int cols = 0;
+    for (const unsigned char* p = (const unsigned char*)name; *p; p++) {
+        if ((*p & 0xC0) == 0x80) continue;  // UTF-8 연속 바이트
+        cols += (*p >= 0xEA && *p <= 0xED) ? 2 : 1;  // 한글 음절(U+AC00~)만 두 칸
+    }
+    fprintf(out, "  %s%*s", name, cols < width ? width - cols : 0, "");
+}
+
+// 자리마다 마지막으로 보인 패턴이 갱신 스레드가 지금 켜는 글자와 같은지
+static int fndMatches(void) {
+    simFndSync(&fnd);
+    uint64_t packed = atomic_load(&fndRefresh.text);
+    for (int i = 0; i < SIM_FND_DIGITS; i++) {
+        if (fnd.shown[i] != ((packed >> (8 * i)) & 0xFF)) return 0;
+    }
+    return 1;
+}
+
+static void benchRun(const char* name, int (*prog)(void), int perPin, int seconds) {
+    fndRefreshPerPin = perPin;
+    unsigned long stores = fndRefresh.stores;
+    unsigned long scans = fndRefresh.scans;
+    unsigned long late = fndRefresh.late;
+    simFndReset(&fnd);
+    uint64_t start = simNowNs();
+    benchStopNs = start + (uint64_t)seconds * 1000000000ULL;
+    if (setjmp(benchEnd) == 0) prog();
+    simFndSync(&fnd);
+    double elapsed = (double)(simNowNs() - start) / 1e9;
+    delay(50);  // 마지막으로 넘긴 글자가 여섯 자리 모두에 켜지도록 (선점되어도 몇 바퀴)
+
+    unsigned long minScans = fnd.scans[0];
+    uint64_t maxGap = 0, minLit = fnd.litNs[0], maxLit = 0;
+    for (int i = 0; i < SIM_FND_DIGITS; i++) {
+        if (fnd.scans[i] < minScans) minScans = fnd.scans[i];
+        if (fnd.maxGapNs[i] > maxGap) maxGap = fnd.maxGapNs[i];
+        if (fnd.litNs[i] < minLit) minLit = fnd.litNs[i];
+        if (fnd.litNs[i] > maxLit) maxLit = fnd.litNs[i];
+    }
+    unsigned long digits = (fndRefresh.scans - scans) * FND_DIGITS;
+    char label[64];
+    char text[SIM_FND_DIGITS * 2 + 1];
+    snprintf(label, sizeof(label), "%s, %s", name, perPin ? "digitalWrite" : "GPSET0/GPCLR0");
+    printName(label, 26);
+    fprintf(out, " %7.1f %8.2f %5.1f/%4.1f %8.1f %5lu %5lu  [%s] %s\n",
+            minScans / elapsed, maxGap / 1e6, minLit / elapsed / 1e7, maxLit / elapsed / 1e7,
+            digits ? (double)(fndRefresh.stores - stores) / digits : 0.0, fnd.ghosts, fndRefresh.late - late,
+            simFndText(&fnd, text), fndMatches() ? "일치" : "다름");
+}
+
+int main(int argc, char* argv[]) {
+    int seconds = (argc > 1) ? atoi(argv[1]) : 10;
+    if (seconds <= 0) seconds = 10;
+
+    simClockMode(SIM_CLOCK_VIRTUAL);
+    if (wiringPiSetupGpio() == -1) {
+        printf("GPIO 초기화 실패\n");
+        return 1;
+    }
+    simFndAttach(&fnd, fndSel, fndPinTable);
+
+    out = fdopen(dup(STDOUT_FILENO), "w");
+    if (out == NULL) {
+        fprintf(stderr, "표준 출력 복제 실패\n");
+        return 1;
+    }
+
+    static const struct {
+        const char* title;
+        unsigned int perSecond, us;
+    } envs[] = {
+        { "잡음 없음", 0, 0 },
+        { "선점 20/s x 5ms (다른 프로세스)", 20, 5000 },
+    };
+
+    fprintf(out, "FND 갱신 벤치마크 (가상 시계), 조건별 %d초, 목표 %dHz\n\n", seconds, FND_REFRESH_HZ);
+    for (size_t i = 0; i < sizeof(envs) / sizeof(envs[0]); i++) {
+        simSetPreemption(envs[i].perSecond, envs[i].us);
+        fprintf(out, "%s\n", envs[i].title);
+        printName("조건", 26);
+        fprintf(out, " %7s %8s %10s %8s %5s %5s  %s\n", "갱신 Hz", "최대 ms", "켜짐 %", "쓰기/자리", "잔상", "늦음", "화면");
+        benchRun("fnd.c", fndMain, 0, seconds);
+        benchRun("fnd.c", fndMain, 1, seconds);
+        benchRun("fnd2.c", fnd2Main, 0, seconds);
+        benchRun("fnd2.c", fnd2Main, 1, seconds);
+        fprintf(out, "\n");
+    }
+    fflush(out);
+    return 0;
+}
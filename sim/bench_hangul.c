@@ -0,0 +1,188 @@
+// LCD 한글 글꼴 캐시 벤치마크 (Lab/hangul_lcd.h)
+//   1. Week7 ex3.c 의 메뉴 화면을 LCD 의 CGRAM 내용으로 다시 그려서 보여 준다 (5x8 점)
+//   2. 도어락 사용 흐름 (메뉴 넘기기, 비밀번호 입력, 안내 화면) 을 화면마다 그리면서
+//      CGRAM 슬롯을 캐시로 쓸 때와 화면마다 모든 음절을 다시 올릴 때 (hangulLcdCache = 0) 를 비교한다.
+//   3. 서로 다른 음절이 8개를 넘는 화면
+//
+// 빌드 및 실행 (저장소 최상위에서):
+//   gcc -O2 -Isim/include sim/bench_hangul.c sim/sim_board.c -lm -o bench_hangul
+//   ./bench_hangul [흐름 반복 횟수]
+//
+// 항상 가상 시계로 실행한다. LCD 는 HD44780 핀 수준 모델 (busy flag, sim_board.c) 이다.
+// ms/화면 : 화면을 그리고 LCD 에 반영하는 데 걸린 시간 (평균, 최대)
+// 올림/화면: 화면마다 CGRAM 에 올린 글꼴 수
+// 적중    : 그린 음절 중 이미 CGRAM 에 있던 비율
+// 화면    : 모든 화면에서 LCD 의 글자와 CGRAM 글꼴이 그리려던 화면과 같았는지
+#include <stdlib.h>
+#include <string.h>
+
+#define main ex3Main
+#include "../Lab/Week7(Device Control 3)/ex3.c"
+#undef main
+
+// -1: displayMenu (menu 번 메뉴), 그 밖: 두 줄 안내 화면
+typedef struct {
+    int menu;
+    const char* line0;
+    const char* line1;
+} BenchScreen;
+
+// ex3.c 를 한 번 쓰는 흐름: 비밀번호 설정 -> 메뉴 넘기기 -> 틀린 비밀번호 -> 문 열기 -> 비밀번호 변경 -> 소리 끄기
+static const BenchScreen session[] = {
+    { 0, NULL, NULL },
+    { -1, "새 비밀번호:", "****" },
+    { -1, "비밀번호 설정됨", "" },
+    { 0, NULL, NULL },
+    { 1, NULL, NULL },
+    { 2, NULL, NULL },
+    { 0, NULL, NULL },
+    { -1, "비밀번호:", "****" },
+    { -1, "잘못된 비밀번호", "" },
+    { -1, "비밀번호:", "****" },
+    { -1, "문이 열렸습니다", "" },
+    { 0, NULL, NULL },
+    { 1, NULL, NULL },
+    { 2, NULL, NULL },
+    { -1, "3. 비밀번호 변경", "현재: ****" },
+    { -1, "현재: ****", "새 번호: ****" },
+    { -1, "비밀번호 설정됨", "" },
+    { 2, NULL, NULL },
+    { -1, "소리 끔", "" },
+    { 2, NULL, NULL },
+};
+#define SESSION_SCREENS (int)(sizeof(session) / sizeof(session[0]))
+
+static void drawScreen(const BenchScreen* s) {
+    if (s->menu >= 0) {
+        currentMenu = s->menu;
+        displayMenu();
+        return;
+    }
+    lcdShadowClear(&lcd);
+    hangulLcdPuts(&hangul, s->line0);
+    lcdShadowPosition(&lcd, 0, 1);
+    hangulLcdPuts(&hangul, s->line1);
+    hangulLcdFlush(&hangul);
+}
+
+// LCD 에 보이는 글자가 frame 과 같고, 슬롯 문자 칸의 CGRAM 글꼴이 그 슬롯에 올린 글꼴과 같은지
+// (캐시를 끄면 flush 뒤에 슬롯의 음절 기록을 지우므로, 음절 글꼴과의 비교는 기록이 남은 슬롯만)
+static int screenMatches(void) {
+    int fd = hdLcds[lcd.fd].simFd;
+    for (int r = 0; r < lcd.rows; r++) {
+        const char* text = simLcdText(fd, r);
+        for (int c = 0; c < lcd.cols; c++) {
+            unsigned char ch = (unsigned char)lcd.frame[r][c];
+            if ((unsigned char)text[c] != ch) return 0;
+            if (ch < HANGUL_CODE0 || ch >= HANGUL_CODE0 + HANGUL_SLOTS) continue;
+            int slot = ch - HANGUL_CODE0;
+            unsigned char want[8];
+            if (hangul.code[slot]) hangulGlyph(hangul.code[slot] - 1, want);
+            else memcpy(want, hangul.glyph[slot], sizeof(want));
+            const unsigned char* got = simLcdGlyph(fd, slot);
+            for (int y = 0; y < 8; y++) {
+                if ((got[y] & 0x1F) != want[y] || hangul.glyph[slot][y] != want[y]) return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+//1. LCD 내용을 점으로
+static void printLcd(void) {
+    int fd = hdLcds[lcd.fd].simFd;
+    for (int r = 0; r < lcd.rows; r++) {
+        const char* text = simLcdText(fd, r);
+        for (int y = 0; y < 8; y++) {
+            printf("  ");
+            for (int c = 0; c < lcd.cols; c++) {
+                unsigned char ch = (unsigned char)text[c];
+                for (int x = 0; x < 5; x++) {
+                    int on;
+                    if (ch < 16) on = (simLcdGlyph(fd, ch)[y] >> (4 - x)) & 1;
+                    else on = (y == 3 && ch != ' ' && x > 0 && x < 4);  // 문자 ROM 글자는 가운데 줄로만 표시
+                    putchar(on ? '#' : '.');
+                }
+                putchar(' ');
+            }
+            putchar('\n');
+        }
+        putchar('\n');
+    }
+}
+
+// 한글은 화면에서 두 칸을 차지하므로 표시 폭 기준으로 왼쪽 정렬
+static void printName(const char* name, int width) {
+    int cols = 0;
+    for (const unsigned char* p = (const unsigned char*)name; *p; p++) {
+        if ((*p & 0xC0) == 0x80) continue;  // UTF-8 연속 바이트
+        cols += (*p >= 0xEA && *p <= 0xED) ? 2 : 1;  // 한글 음절(U+AC00~)만 두 칸
+    }
+    printf("  %s%*s", name, cols < width ? width - cols : 0, "");
+}
+
+//2. 사용 흐름
+static void benchSession(int cache, int repeat) {
+    hangulLcdCache = cache;
+    hangulLcdInit(&hangul, &lcd);
+    lcdShadowClear(&lcd);
+    hangulLcdFlush(&hangul);
+
+    int screens = 0, ok = 1;
+    uint64_t total = 0, worst = 0;
+    for (int n = 0; n < repeat; n++) {
+        for (int i = 0; i < SESSION_SCREENS; i++) {
+            uint64_t start = simNowNs();
+            drawScreen(&session[i]);
+            uint64_t ns = simNowNs() - start;
+            total += ns;
+            if (ns > worst) worst = ns;
+            screens++;
+            if (!screenMatches()) ok = 0;
+        }
+    }
+    unsigned long drawn = hangul.hits + hangul.misses;
+    printName(cache ? "LRU 캐시" : "화면마다 다시 올림", 20);
+    printf(" %7.2f %7.2f %9.2f %6.1f%%  %s\n", total / 1e6 / screens, worst / 1e6, (double)hangul.uploads / screens,
+           drawn ? 100.0 * hangul.hits / drawn : 0.0, ok ? "일치" : "다름");
+}
+
+int main(int argc, char* argv[]) {
+    int repeat = (argc > 1) ? atoi(argv[1]) : 10;
+    if (repeat <= 0) repeat = 10;
+
+    simClockMode(SIM_CLOCK_VIRTUAL);
+    if (wiringPiSetupGpio() == -1) {
+        printf("GPIO 초기화 실패\n");
+        return 1;
+    }
+    lcdHandle = hdInit(2, 16, 2, LCD_RW_PIN, 4, 20, 21, 12, 16);
+    lcdShadowInit(&lcd, lcdHandle, 2, 16);
+    hangulLcdInit(&hangul, &lcd);
+
+    printf("LCD 한글 글꼴 캐시 벤치마크 (가상 시계)\n\n");
+    printf("ex3.c 첫 메뉴 (CGRAM 내용으로 다시 그림, 영문/숫자는 가운데 줄)\n");
+    currentMenu = 0;
+    displayMenu();
+    printLcd();
+
+    printf("도어락 사용 흐름 %d화면 x %d회\n", SESSION_SCREENS, repeat);
+    printName("슬롯", 20);
+    printf(" %s %s %s %s  %s\n", "ms/화면", "최대 ms", "올림/화면", "  적중", "화면");
+    benchSession(1, repeat);
+    benchSession(0, repeat);
+    hangulLcdCache = 1;
+
+    //3. 슬롯보다 많은 음절
+    printf("\n서로 다른 음절 11개 화면 (\"3. 비밀번호 변경\" + \"4. 소리 켜기/끄기\")\n");
+    fflush(stdout);
+    lcdShadowClear(&lcd);
+    hangulLcdPuts(&hangul, "3. 비밀번호 변경");
+    lcdShadowPosition(&lcd, 0, 1);
+    hangulLcdPuts(&hangul, "4. 소리 켜기/끄기");
+    int missing = hangulLcdFlush(&hangul);
+    printf("  그리지 못한 글자 %d개, LCD 2번째 줄: \"", missing);
+    for (const char* p = simLcdText(hdLcds[lcd.fd].simFd, 1); *p; p++) putchar((unsigned char)*p < 16 ? '@' : *p);
+    printf("\" (@: CGRAM 글자), 화면 %s\n", screenMatches() ? "일치" : "다름");
+    return 0;
+}
@@ -0,0 +1,187 @@
+// LCD 벤치마크
+//   1. 한 화면 전체 쓰기 (지우기 + 16글자 두 줄): wiringPi lcd.c, hd44780.h 고정 지연, hd44780.h busy flag
+//   2. 거리 측정 루프의 주기: Week10 ex4.c, PWM.c 의 main 을 그대로 실행하고 초음파 센서 트리거 횟수로 센다.
+//
+// 빌드 및 실행 (저장소 최상위에서):
+//   gcc -O2 -Isim/include sim/bench_lcd.c sim/sim_board.c sim/sim_signal.c -lm -o bench_lcd
+//   ./bench_lcd [조건별 가상 시간 초]
+//
+// 항상 가상 시계로 실행한다. LCD 대기 시간은 sim_board.c 참고
+// (lcdInit: wiringPi lcd.c 의 고정 대기, hdInit: HD44780 핀 수준 모델의 명령 처리 시간과 busy flag).
+// us/화면: 한 화면을 쓰는 데 걸린 시간
+// loop/s : 1초에 거리를 잰 횟수
+// loop ms: 측정 루프 한 번에 걸린 시간 (거리 측정 + LCD + alertBuzzer + delay(30))
+// 화면   : 끝난 뒤 LCD 내용이 마지막으로 그린 화면과 같은지 (한 화면 전체 쓰기)
+#include "../Lab/lcd_shadow.h"
+#include "../Lab/pwm_tone.h"  // 스레드가 부르는 delay 는 benchDelay 로 바뀌지 않도록 먼저
+#include "sim_signal.h"
+
+#include <math.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static void benchDelay(unsigned int ms);
+
+// 실습 코드의 delay 는 benchDelay 로 바꿔서 측정 시간이 끝나면 main 을 빠져나온다
+#define delay benchDelay
+
+#define main ex4Main
+#define getDistance ex4GetDistance
+#define initBuzzer ex4InitBuzzer
+#define alertBuzzer ex4AlertBuzzer
+#include "../Lab/Week10(Sensor Control 2)/ex4.c"
+#undef main
+#undef getDistance
+#undef initBuzzer
+#undef alertBuzzer
+#undef TRIG_PIN
+#undef ECHO_PIN
+#undef BUZZER_PIN
+#undef LCD_RS
+#undef LCD_E
+#undef LCD_D4
+#undef LCD_D5
+#undef LCD_D6
+#undef LCD_D7
+
+#define main pwmMain
+#define getDistance pwmGetDistance
+#define initPWM pwmInitPwm
+#define alertBuzzer pwmAlertBuzzer
+#include "../Lab/Week10(Sensor Control 2)/PWM.c"
+#undef main
+#undef getDistance
+#undef initPWM
+#undef alertBuzzer
+
+#undef delay
+
+static FILE* out;
+static jmp_buf benchEnd;
+static uint64_t benchStopNs;
+static SimHcsr04 sonar;
+
+static void benchDelay(unsigned int ms) {
+    if (simNowNs() >= benchStopNs) longjmp(benchEnd, 1);
+    delay(ms);
+}
+
+// 한글은 화면에서 두 칸을 차지하므로 표시 폭 기준으로 왼쪽 정렬
+static void printName(const char* name, int width) {
+    int cols = 0;
+    for (const unsigned char* p = (const unsigned char*)name; *p; p++) {
+        if ((*p & 0xC0) == 0x80) continue;  // UTF-8 연속 바이트
+        cols += (*p >= 0xEA && *p <= 0xED) ? 2 : 1;  // 한글 음절(U+AC00~)만 두 칸
+    }
+    fprintf(out, "  %s%*s", name, cols < width ? width - cols : 0, "");
+}
+
+//1. 한 화면 전체 쓰기
+static const char* const benchLines[2][2] = {
+    { "1. Input PW     ", "2. Set PW      d" },
+    { "2. Set PW       ", "3. Change PW   d" },
+};
+
+static void printThroughput(const char* name, uint64_t ns, int screens, int ok) {
+    printName(name, 28);
+    fprintf(out, " %9.1f %8.1f  %s\n", ns / 1e3 / screens, screens / (ns / 1e9), ok ? "일치" : "다름");
+}
+
+static void benchScreens(int screens) {
+    fprintf(out, "한 화면 전체 쓰기 (지우기 + 16글자 두 줄), %d회\n", screens);
+    printName("드라이버", 28);
+    fprintf(out, " %9s %8s  %s\n", "us/화면", "화면/s", "화면");
+
+    int fd = lcdInit(2, 16, 4, 2, 4, 20, 21, 12, 16, 0, 0, 0, 0);
+    uint64_t start = simNowNs();
+    for (int i = 0; i < screens; i++) {
+        lcdClear(fd);
+        for (int r = 0; r < 2; r++) {
+            lcdPosition(fd, 0, r);
+            lcdPuts(fd, benchLines[i & 1][r]);
+        }
+    }
+    int ok = strcmp(simLcdText(fd, 1), benchLines[(screens - 1) & 1][1]) == 0;
+    printThroughput("wiringPi lcd.c", simNowNs() - start, screens, ok);
+
+    static const struct {
+        const char* name;
+        int rw;
+    } modes[] = {
+        { "hd44780.h 고정 지연", -1 },
+        { "hd44780.h busy flag", 25 },
+    };
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        fd = hdInit(2, 16, 2, modes[m].rw, 4, 20, 21, 12, 16);
+        start = simNowNs();
+        for (int i = 0; i < screens; i++) {
+            hdClear(fd);
+            for (int r = 0; r < 2; r++) {
+                hdPosition(fd, 0, r);
+                hdPuts(fd, benchLines[i & 1][r]);
+            }
+        }
+        uint64_t ns = simNowNs() - start;
+        delay(5);  // 마지막 바이트 처리
+        ok = strcmp(simLcdText(hdLcds[fd].simFd, 1), benchLines[(screens - 1) & 1][1]) == 0;
+        printThroughput(modes[m].name, ns, screens, ok);
+    }
+    fprintf(out, "\n");
+}
+
+//2. 거리 측정 루프
+static void benchRun(const char* name, int (*prog)(void), double distanceCm, int seconds) {
+    simHcsr04Set(&sonar, distanceCm, 30, 0, SIM_ECHO_TIMEOUT);  // 에코 흔들림으로 소수점 아래 숫자가 바뀐다
+    unsigned long triggers = sonar.triggers;
+    uint64_t start = simNowNs();
+    benchStopNs = start + (uint64_t)seconds * 1000000000ULL;
+    if (setjmp(benchEnd) == 0) prog();
+    uint64_t elapsed = simNowNs() - start;
+    unsigned long loops = sonar.triggers - triggers;
+
+    printName(name, 28);
+    fprintf(out, " %7.1f %8.2f\n", loops / (elapsed / 1e9), elapsed / 1e6 / (loops ? loops : 1));
+}
+
+int main(int argc, char* argv[]) {
+    int seconds = (argc > 1) ? atoi(argv[1]) : 10;
+    if (seconds <= 0) seconds = 10;
+
+    simClockMode(SIM_CLOCK_VIRTUAL);
+    if (wiringPiSetupGpio() == -1) {
+        printf("GPIO 초기화 실패\n");
+        return 1;
+    }
+    simHcsr04Attach(&sonar, 27, 22);
+
+    // 실습 코드가 출력하는 내용은 버리고 결과만 원래 표준 출력으로 보낸다
+    out = fdopen(dup(STDOUT_FILENO), "w");
+    if (out == NULL || freopen("/dev/null", "w", stdout) == NULL) {
+        fprintf(stderr, "표준 출력 전환 실패\n");
+        return 1;
+    }
+
+    static const struct {
+        const char* title;
+        double cm;
+    } ranges[] = {
+        { "물체 150cm (경고음 없음)", 150.0 },
+        { "물체 20cm (경고음 30ms 간격)", 20.0 },
+    };
+
+    fprintf(out, "LCD 벤치마크 (가상 시계)\n\n");
+    benchScreens(100);
+    fprintf(out, "거리 측정 루프, 조건별 %d초\n\n", seconds);
+    for (size_t i = 0; i < sizeof(ranges) / sizeof(ranges[0]); i++) {
+        fprintf(out, "%s\n", ranges[i].title);
+        printName("조건", 28);
+        fprintf(out, " %7s %8s\n", "loop/s", "loop ms");
+        benchRun("ex4.c", ex4Main, ranges[i].cm, seconds);
+        benchRun("PWM.c", pwmMain, ranges[i].cm, seconds);
+        fprintf(out, "\n");
+    }
+    fflush(out);
+    return 0;
+}
@@ -0,0 +1,339 @@
+// 스테퍼 모터 구동 벤치마크 (Lab/stepper_motion.h, 예전 Lab/Week6 stepper.c 의 forward)
+//   1. 예전 forward(del, steps): 상마다 digitalWrite 4번 + delay(del)
+//   2. 타이머 스레드: 속도별로 상이 바뀐 시각과 가속 표로 정한 시각의 차이, 최고 속도에서 실제로 낸 스텝/초
+//   3. 타이머 스레드 한 스텝의 CPU 비용과 이 PC 에서 clock_nanosleep 으로 깨는 지연 (실제 시계)
+//   4. 시뮬레이터가 낼 수 있는 가장 높은 스텝/초 (가상 시계)
+//
+// 빌드 및 실행 (저장소 최상위에서):
+//   gcc -O2 -Isim/include sim/bench_stepper.c sim/sim_board.c -lm -o bench_stepper
+//   ./bench_stepper
+//
+// 1, 2, 4 는 가상 시계로 실행한다 (보드 함수 호출 한 번에 100ns). 네 핀에 장치를 연결해 핀이 바뀐 시각을 모두 기록한다.
+// 2 의 선점은 벤치가 넣는 모델 (simSetPreemption) 이라 실제 보드의 지터가 아니다.
+// 4 는 시뮬레이터의 한계다: 가상 시계에서는 잠을 us 단위로 올려서 자므로 간격이 1us 아래로 내려가면 못 따라간다.
+// 실제 보드에서 속도를 막는 것은 3 의 스텝당 CPU 시간과 깨는 지연이다.
+// 부른us   : 이동을 넘긴 함수가 돌아오는 데 걸린 시간 (예전 forward 는 이동 시간 전체)
+// 간격오차  : 스텝 간격이 가속 표로 정한 간격과 다른 만큼 (최대, 평균 us)
+// 밀림      : 마지막 스텝이 첫 스텝 기준으로 정한 시각보다 늦은 만큼 (ms)
+// 최고속도  : 최고 속도 구간에서 실제로 낸 스텝/초
+// 중간상태  : 네 핀이 상 표에 없는 모양이었던 횟수 (핀을 하나씩 쓰면 상 사이에 보인다)
+// 다시맞춤  : 한 스텝 넘게 늦어서 시각을 다시 센 횟수 (stepper.late)
+#include "../Lab/stepper_motion.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <time.h>
+
+static const int pins[4] = { 20, 21, 19, 26 };  // stepper.c 배선
+
+//1. 핀 기록
+typedef struct {
+    uint64_t ns;
+    uint32_t levels;
+} Edge;
+
+static Edge* edges;
+static int edgeCount, edgeCap;
+static uint32_t levels;
+
+static void recWrite(void* ctx, int pin, int value, uint64_t nowNs) {
+    (void)ctx;
+    uint32_t before = levels;
+    if (value) levels |= 1u << pin;
+    else levels &= ~(1u << pin);
+    if (levels == before) return;
+    if (edgeCount > 0 && edges[edgeCount - 1].ns == nowNs) {  // 한 번에 쓴 핀들
+        edges[edgeCount - 1].levels = levels;
+        return;
+    }
+    if (edgeCount == edgeCap) {
+        edgeCap = edgeCap ? edgeCap * 2 : 4096;
+        edges = realloc(edges, sizeof(Edge) * (size_t)edgeCap);
+    }
+    edges[edgeCount].ns = nowNs;
+    edges[edgeCount].levels = levels;
+    edgeCount++;
+}
+
+static const SimPinOps recOps = { NULL, recWrite, NULL, NULL };
+
+// 한글은 화면에서 두 칸을 차지하므로 표시 폭 기준으로 왼쪽 정렬
+static void printName(const char* name, int width) {
+    int cols = 0;
+    for (const unsigned char* p = (const unsigned char*)name; *p; p++) {
+        if ((*p & 0xC0) == 0x80) continue;  // UTF-8 연속 바이트
+        cols += (*p >= 0xEA && *p <= 0xED) ? 2 : 1;  // 한글 음절(U+AC00~)만 두 칸
+    }
+    printf("  %s%*s", name, cols < width ? width - cols : 0, "");
+}
+
+//2. 기록 분석
+typedef struct {
+    int steps, invalid;
+    uint64_t maxErr, sumErr;  // 간격 오차
+    int64_t driftNs;
+    double cruiseSps;
+} Result;
+
+// 기록한 핀 변화를 상 표로 읽고 planned[j] (첫 스텝 기준 ns) 와 비교한다.
+// cruise[j] 가 1 인 스텝들로 최고 속도를 잰다
+static Result analyze(const StepperCoils* c, const uint64_t* planned, const char* cruise, int count) {
+    Result r = { 0 };
+    uint32_t last = 0;
+    uint64_t first = 0, prev = 0, cruiseFirst = 0, cruiseLast = 0;
+    int cruiseSteps = 0;
+    for (int i = 0; i < edgeCount; i++) {
+        uint32_t lv = edges[i].levels & c->mask;
+        int valid = 0;
+        for (int p = (c->stride == 2); p < 8; p += c->stride) valid |= (c->on[p] == lv);
+        if (!valid) {
+            if (lv != 0) r.invalid++;  // 처음 꺼 둔 상태는 빼고
+            continue;
+        }
+        if (lv == last) continue;
+        last = lv;
+        int j = r.steps++;
+        if (j >= count) continue;
+        if (j == 0) first = prev = edges[i].ns;
+        if (j > 0) {
+            uint64_t gap = edges[i].ns - prev, want = planned[j] - planned[j - 1];
+            uint64_t err = gap > want ? gap - want : want - gap;
+            if (err > r.maxErr) r.maxErr = err;
+            r.sumErr += err;
+        }
+        prev = edges[i].ns;
+        r.driftNs = (int64_t)(edges[i].ns - first) - (int64_t)planned[j];
+        if (cruise[j]) {
+            if (cruiseSteps++ == 0) cruiseFirst = edges[i].ns;
+            cruiseLast = edges[i].ns;
+        }
+    }
+    if (cruiseSteps > 1) r.cruiseSps = (cruiseSteps - 1) * 1e9 / (double)(cruiseLast - cruiseFirst);
+    return r;
+}
+
+static void printResult(const char* name, double callUs, const Result* r, int count, double planSps,
+                        unsigned long late) {
+    printName(name, 28);
+    printf(" %10.1f %6d/%-6d %8.1f %8.2f %8.3f %9.0f %9.0f %6d %5lu\n", callUs, r->steps, count, r->maxErr / 1e3,
+           r->steps > 1 ? r->sumErr / 1e3 / (r->steps - 1) : 0.0, r->driftNs / 1e6, planSps, r->cruiseSps, r->invalid,
+           late);
+}
+
+static void printHeader(void) {
+    printName("", 28);
+    printf(" %10s %13s %8s %8s %8s %9s %9s %6s %5s\n", "부른us", "스텝", "간격us", "평균us", "밀림ms", "정한/초",
+           "최고속도", "중간", "맞춤");
+}
+
+//3. 예전 forward (stepper.c 그대로)
+static void setsteps(int w1, int w2, int w3, int w4) {
+    digitalWrite(pins[0], w1);
+    digitalWrite(pins[1], w2);
+    digitalWrite(pins[2], w3);
+    digitalWrite(pins[3], w4);
+}
+
+static void oldForward(int del, int steps) {
+    for (int i = 0; i < steps; i++) {
+        setsteps(1, 1, 0, 0);
+        delay(del);
+        setsteps(0, 1, 1, 0);
+        delay(del);
+        setsteps(0, 0, 1, 1);
+        delay(del);
+        setsteps(1, 0, 0, 1);
+        delay(del);
+    }
+}
+
+static void benchOld(int del, int steps) {
+    StepperCoils c;
+    stepperCoilsInit(&c, pins, 0);
+    int count = steps * 4;
+    uint64_t* planned = malloc(sizeof(uint64_t) * (size_t)count);
+    char* cruise = malloc((size_t)count);
+    for (int j = 0; j < count; j++) {
+        planned[j] = (uint64_t)j * del * 1000000ULL;
+        cruise[j] = 1;
+    }
+    edgeCount = 0;
+    uint64_t start = simNowNs();
+    oldForward(del, steps);
+    double callUs = (simNowNs() - start) / 1e3;
+    setsteps(0, 0, 0, 0);
+    Result r = analyze(&c, planned, cruise, count);
+
+    char name[64];
+    snprintf(name, sizeof(name), "예전 forward(%d, %d)", del, steps);
+    printResult(name, callUs, &r, count, 1000.0 / del, 0);
+    free(planned);
+    free(cruise);
+}
+
+//4. 타이머 스레드
+// 가속 표로 target 까지 가는 스텝 시각 (첫 스텝 기준)과 최고 속도 구간을 만든다
+static int planMove(long from, long target, uint64_t** planned, char** cruise) {
+    StepperState s = { from, 1, 0 };
+    int count = (int)labs(target - from);
+    *planned = malloc(sizeof(uint64_t) * (size_t)count);
+    *cruise = malloc((size_t)count);
+    uint64_t at = 0;
+    int dir, j = 0;
+    uint32_t ns;
+    while (j < count && stepperPlan(&stepper.ramp, &s, target, &dir, &ns)) {
+        if (j > 0) at += ns;
+        (*planned)[j] = at;
+        (*cruise)[j] = (ns == stepper.ramp.cruiseNs && s.level == stepper.ramp.len);
+        j++;
+    }
+    return count;
+}
+
+// 한 번 움직이고 결과를 돌려준다. 스텝 방식은 멈춰 있을 때 상 칸을 그대로 두고 바꾼다
+// (온 스텝 상은 반 스텝 표의 홀수 칸이므로 반 스텝 이동은 짝수 스텝으로 한다)
+static Result benchMove(int halfStep, unsigned int sps, unsigned int accel, long steps, double* callUs,
+                        unsigned long* late) {
+    stepperWait();
+    stepper.coils.stride = halfStep ? 1 : 2;
+    stepperConfig(sps, accel);
+    long from = stepperPosition();
+    uint64_t* planned;
+    char* cruise;
+    int count = planMove(from, from + steps, &planned, &cruise);
+
+    edgeCount = 0;
+    unsigned long lateStart = stepper.late;
+    uint64_t start = simNowNs();
+    stepperMove(steps);
+    *callUs = (simNowNs() - start) / 1e3;
+    stepperWait();
+    *late = stepper.late - lateStart;
+    Result r = analyze(&stepper.coils, planned, cruise, count);
+    free(planned);
+    free(cruise);
+    return r;
+}
+
+static void benchEngine(const char* name, int halfStep, unsigned int sps, unsigned int accel, long steps) {
+    double callUs;
+    unsigned long late;
+    Result r = benchMove(halfStep, sps, accel, steps, &callUs, &late);
+    printResult(name, callUs, &r, (int)labs(steps), 1e9 / stepper.ramp.cruiseNs, late);
+}
+
+//5. 실제 시계
+static uint64_t realNowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// 타이머 스레드가 스텝마다 하는 계산 (가속 표, 상, 바꿀 핀) 만 실제 시계로 잰다. 핀 쓰기 (GPSET0/GPCLR0) 는 빠진다
+static void benchTickCpu(void) {
+    static StepperRamp ramp;
+    StepperCoils c;
+    stepperCoilsInit(&c, pins, 1);
+    stepperRampInit(&ramp, 100000, 10000000);
+    StepperState s = { 0, 1, 0 };
+    const long count = 20000000;
+    uint32_t out = 0, sink = 0, ns;
+    int dir;
+    uint64_t start = realNowNs();
+    for (long i = 0; i < count && stepperPlan(&ramp, &s, count, &dir, &ns); i++) {
+        uint32_t on = stepperCoilsNext(&c, dir);
+        sink += (on & c.mask & ~out) ^ (out & c.mask & ~on) ^ ns;
+        out = on;
+    }
+    double perStep = (double)(realNowNs() - start) / count;
+    if (sink == 1) printf(" ");  // 계산이 지워지지 않도록
+    printf("  스텝 하나 계산 %.1fns (이 PC) -> CPU 만으로는 %.0f 스텝/초까지\n", perStep, 1e9 / perStep);
+}
+
+// stepperSleepUntil 처럼 절대 시각까지 clock_nanosleep 으로 자고 늦게 깬 만큼을 잰다
+static void benchWake(unsigned int intervalUs, int count) {
+    uint64_t at = realNowNs(), maxNs = 0, sumNs = 0;
+    int over = 0;
+    for (int i = 0; i < count; i++) {
+        at += intervalUs * 1000ULL;
+        struct timespec ts = { (time_t)(at / 1000000000ULL), (long)(at % 1000000000ULL) };
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+        }
+        uint64_t late = realNowNs() - at;
+        if (late > maxNs) maxNs = late;
+        sumNs += late;
+        over += late > STEPPER_SPIN_US * 1000ULL;
+    }
+    printf("  %uus 마다 %d번 깨기: 늦음 최대 %.1fus 평균 %.1fus, STEPPER_SPIN_US(%dus) 넘음 %d번\n", intervalUs, count,
+           maxNs / 1e3, sumNs / 1e3 / count, STEPPER_SPIN_US, over);
+}
+
+//6. 시뮬레이터 한계
+// 최고 속도가 정한 속도의 99% 이상이고 다시 맞춤이 없는 가장 높은 스텝/초 (2배씩 올린다).
+// 가상 시계의 잠은 us 단위로 올림하므로 스텝 간격이 1us 아래가 되는 곳에서 멈춘다 (모터나 보드의 한계가 아니다)
+static void benchLimit(void) {
+    unsigned int best = 0;
+    for (unsigned int sps = 1000; sps <= 4096000; sps *= 2) {
+        double callUs;
+        unsigned long late;
+        long steps = sps / 2 > 2000 ? sps / 2 : 2000;
+        Result r = benchMove(1, sps, sps / 1000 * sps, steps, &callUs, &late);  // 가속 500 스텝
+        if (r.steps != steps || late > 0 || r.cruiseSps < sps * 0.99) {
+            printf("  %u 스텝/초: 최고 속도 %.0f, 다시 맞춤 %lu회 -> 못 따라감\n", sps, r.cruiseSps, late);
+            break;
+        }
+        best = sps;
+    }
+    printf("  시뮬레이터가 낸 가장 높은 속도 %u 스텝/초 (가상 시계의 잠이 1us 단위라서 생기는 한계)\n", best);
+}
+
+int main(void) {
+    simClockMode(SIM_CLOCK_VIRTUAL);
+    if (wiringPiSetupGpio() == -1) {
+        printf("GPIO 초기화 실패\n");
+        return 1;
+    }
+    for (int i = 0; i < 4; i++) {
+        pinMode(pins[i], OUTPUT);
+        simAttach(pins[i], &recOps, NULL);
+    }
+
+    printf("스테퍼 모터 구동 벤치마크 (가상 시계, GPIO %d %d %d %d)\n\n", pins[0], pins[1], pins[2], pins[3]);
+    printf("예전 stepper.c (온 스텝, 상마다 delay)\n");
+    printHeader();
+    benchOld(5, 128);
+    benchOld(1, 128);
+    printf("\n");
+
+    stepperBegin(pins, 0, 1000, 2000);  // 온 스텝 상 칸에서 시작
+    static const struct {
+        const char* title;
+        unsigned int perSecond, us;
+    } envs[] = {
+        { "잡음 없음", 0, 0 },
+        { "선점 20/s x 5ms (벤치가 넣은 모델)", 20, 5000 },
+    };
+    for (size_t i = 0; i < sizeof(envs) / sizeof(envs[0]); i++) {
+        simSetPreemption(envs[i].perSecond, envs[i].us);
+        printf("타이머 스레드, %s\n", envs[i].title);
+        printHeader();
+        benchEngine("온 스텝 1000/초 한 바퀴", 0, 1000, 2000, 2048);
+        benchEngine("반 스텝 1000/초 한 바퀴", 1, 1000, 2000, -4096);
+        benchEngine("반 스텝 5000/초", 1, 5000, 50000, 20000);
+        benchEngine("반 스텝 20000/초", 1, 20000, 400000, -50000);
+        benchEngine("반 스텝 100000/초", 1, 100000, 10000000, 200000);
+        printf("\n");
+    }
+    simSetPreemption(0, 0);
+
+    printf("타이머 스레드 한 스텝의 비용 (실제 시계, 실제 보드에서 속도를 막는 값)\n");
+    benchTickCpu();
+    benchWake(1000, 1000);
+    benchWake(200, 2000);
+    printf("\n");
+
+    printf("시뮬레이터 한계 (반 스텝, 잡음 없음, 가상 시계)\n");
+    benchLimit();
+    free(edges);
+    return 0;
+}
@@ -0,0 +1,140 @@
+// 하드웨어 PWM 음 발생 / 음 순서기 벤치마크 (Lab/pwm_tone.h)
+//   1. 실습 음 표의 음마다 PWM 범위로 실제로 나는 주파수와 오차 (시뮬레이션 보드의 PWM 분주/범위 모델로 확인)
+//   2. 타이머 스레드가 음을 바꾼 시각이 정해진 시각에서 얼마나 벗어났는지 (ex3.c 경쾌한 소리, Buzzertest.c 되풀이)
+//
+// 빌드 및 실행 (저장소 최상위에서):
+//   gcc -O2 -Isim/include sim/bench_tone.c sim/sim_board.c -lm -o bench_tone
+//   ./bench_tone [되풀이 초]
+//
+// 항상 가상 시계로 실행한다 (보드 함수 호출 한 번에 100ns).
+// 부르는us  : tonePlay 가 돌아오는 데 걸린 시간 (예전 PlaySuccessfulSound 는 음 길이 합만큼 delay)
+// 첫 음    : 넘긴 뒤 첫 음이 울리기까지 (시뮬레이션 보드의 타이머 스레드는 TONE_IDLE_MS 마다 요청을 확인한다)
+// 오차      : 첫 음 기준으로 정해진 시각과 음이 바뀐 시각의 차이 (최대, 평균). 100us 마다 핀을 확인한다
+// 마지막    : 마지막 음의 오차 (음 길이만큼 기다리기를 되풀이하면 늦음이 음마다 쌓인다)
+// 주파수    : 음이 울리는 동안 핀의 PWM 주파수가 음 표와 같았는지
+#include "../Lab/pwm_tone.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#define SAMPLE_US 100
+
+static const struct {
+    const char* name;
+    unsigned int hz;
+} scale[] = {
+    { "도 (DO_L)", 523 }, { "레", 587 }, { "미", 659 }, { "파", 698 }, { "솔", 784 }, { "라", 880 },
+    { "시", 987 }, { "높은 도", 1046 }, { "높은 레", 1175 }, { "높은 미", 1319 }, { "라# (E 키)", 466 },
+    { "스크롤 (D 키)", 494 }, { "PWM.c 경고음", 2093 },
+};
+
+static const ToneNote successMelody[] = {
+    TONE_NOTE(1046, 200), TONE_NOTE(784, 200), TONE_NOTE(659, 200), TONE_NOTE(784, 200), TONE_NOTE(1046, 200)
+};
+static const ToneNote beep[] = { TONE_NOTE(2093, 1000), TONE_REST(1000) };
+
+// 한글은 화면에서 두 칸을 차지하므로 표시 폭 기준으로 왼쪽 정렬
+static void printName(const char* name, int width) {
+    int cols = 0;
+    for (const unsigned char* p = (const unsigned char*)name; *p; p++) {
+        if ((*p & 0xC0) == 0x80) continue;  // UTF-8 연속 바이트
+        cols += (*p >= 0xEA && *p <= 0xED) ? 2 : 1;  // 한글 음절(U+AC00~)만 두 칸
+    }
+    printf("  %s%*s", name, cols < width ? width - cols : 0, "");
+}
+
+//1. 주파수
+static void benchFrequency(void) {
+    printf("음마다 주파수 (분주 %d, %.1fMHz)\n", TONE_DIVISOR, TONE_CLOCK_HZ / 1e6);
+    printName("음", 16);
+    printf(" %6s %6s %10s %8s\n", "Hz", "범위", "실제 Hz", "오차 %");
+    double worst = 0;
+    for (size_t i = 0; i < sizeof(scale) / sizeof(scale[0]); i++) {
+        toneWrite(scale[i].hz);
+        delay(10);
+        double hz = simPinToneHz(tone.pin);
+        double err = 100.0 * (hz - scale[i].hz) / scale[i].hz;
+        if (fabs(err) > fabs(worst)) worst = err;
+        printName(scale[i].name, 16);
+        printf(" %6u %6u %10.2f %+8.4f\n", scale[i].hz, TONE_RANGE(scale[i].hz), hz, err);
+    }
+    toneWrite(0);
+    delay(10);
+    printf("  가장 큰 오차 %+.4f%%. 예전 PWM.c (분주 9, 범위 1024): %.2fHz, %+.2f%%\n\n", worst,
+           19200000.0 / 9 / 1024, 100.0 * (19200000.0 / 9 / 1024 - 2093) / 2093);
+}
+
+//2. 음 바꾸는 시각
+static void benchTiming(const char* name, const ToneNote* notes, int count, int repeat, int seconds) {
+    uint64_t start = simNowNs();
+    if (repeat) toneRepeat(notes, count);
+    else tonePlay(notes, count);
+    uint64_t callNs = simNowNs() - start;
+
+    int total = repeat ? (int)(seconds * 1000 / (notes[0].ms + notes[1].ms)) * count : count;
+    uint64_t planned = 0, firstNs = 0, maxErr = 0, sumErr = 0, lastErr = 0;
+    unsigned long late = tone.late;
+    int seen = 0, ok = 1;
+    double lastHz = 0;  // 시작 전에는 꺼져 있다
+    uint64_t until = start + (uint64_t)(repeat ? seconds : 2) * 1000000000ULL;
+    while (simNowNs() < until && seen < total) {
+        double hz = simPinToneHz(tone.pin);
+        if (hz != lastHz) {
+            const ToneNote* n = &notes[seen % count];
+            if (fabs(hz - toneActualHz(n)) > 0.01) ok = 0;
+            if (seen == 0) {
+                firstNs = simNowNs() - start;
+                planned = simNowNs();
+            }
+            uint64_t err = simNowNs() > planned ? simNowNs() - planned : 0;
+            if (err > maxErr) maxErr = err;
+            sumErr += err;
+            lastErr = err;
+            planned += (uint64_t)n->ms * 1000000ULL;
+            seen++;
+            lastHz = hz;
+        }
+        delayMicroseconds(SAMPLE_US);
+    }
+    if (repeat) toneWrite(0);
+    delay(300);
+
+    printName(name, 26);
+    printf(" %7.1f %7.3f %5d/%-5d %7.3f %7.3f %7.3f %4lu  %s\n", callNs / 1e3, firstNs / 1e6, seen, total, maxErr / 1e6,
+           seen ? sumErr / 1e6 / seen : 0.0, lastErr / 1e6, tone.late - late, ok && seen == total ? "일치" : "다름");
+}
+
+int main(int argc, char* argv[]) {
+    int seconds = (argc > 1) ? atoi(argv[1]) : 20;
+    if (seconds <= 0) seconds = 20;
+
+    simClockMode(SIM_CLOCK_VIRTUAL);
+    if (wiringPiSetupGpio() == -1) {
+        printf("GPIO 초기화 실패\n");
+        return 1;
+    }
+    toneBegin(18);
+
+    printf("하드웨어 PWM 음 벤치마크 (가상 시계, GPIO 18)\n\n");
+    benchFrequency();
+
+    static const struct {
+        const char* title;
+        unsigned int perSecond, us;
+    } envs[] = {
+        { "잡음 없음", 0, 0 },
+        { "선점 20/s x 5ms (다른 프로세스)", 20, 5000 },
+    };
+    for (size_t i = 0; i < sizeof(envs) / sizeof(envs[0]); i++) {
+        simSetPreemption(envs[i].perSecond, envs[i].us);
+        printf("%s\n", envs[i].title);
+        printName("음 표", 26);
+        printf(" %s %s %11s %s %s %s %s  %s\n", "부르는us", "첫음 ms", "음", "최대 ms", "평균 ms", "마지막", "늦음", "주파수");
+        benchTiming("경쾌한 소리 (ex3.c)", successMelody, TONE_COUNT(successMelody), 0, 0);
+        char label[64];
+        snprintf(label, sizeof(label), "Buzzertest.c %d초 되풀이", seconds);
+        benchTiming(label, beep, TONE_COUNT(beep), 1, seconds);
+        printf("\n");
+    }
+    return 0;
+}
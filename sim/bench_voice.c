@@ -0,0 +1,181 @@
+// 음성 안내 재생 벤치마크 (recommendation vending machine/voice.h)
+//   시험용 안내 음성(WAV)을 만들어 voice.h 로 재생하고 GPIO 18 의 PWM 출력을 WAV 로 녹음해서
+//   원본 샘플과 비교한다 (시뮬레이션 보드의 PWM 녹음, simPwmWavOpen).
+//   버퍼 두 개 / 하나, 다른 프로세스에 선점되는 환경, 재생 중에 다른 안내로 끊기를 비교한다.
+//
+// 빌드 및 실행 (저장소 최상위에서):
+//   gcc -O2 -Isim/include sim/bench_voice.c sim/sim_board.c -lm -o bench_voice
+//   ./bench_voice [녹음 디렉터리]
+//
+// 항상 가상 시계로 실행한다 (보드 함수 호출 한 번에 100ns).
+// 부르는us : voiceSay 가 돌아오는 데 걸린 시간
+// 첫 ms    : 넘긴 뒤 첫 샘플이 나오기까지 (시뮬레이션 보드의 출력 스레드는 VOICE_IDLE_MS 마다 확인한다)
+// 재생 ms  : 첫 샘플부터 마지막 샘플이 끝날 때까지 / 원본 길이
+// 늦음     : 한 샘플(125us) 넘게 늦게 쓴 샘플 수, 가장 늦은 샘플 (us)
+// 부족     : 다음 버퍼가 차지 않아 샘플을 유지한 채 기다린 횟수
+// CPU %    : 출력 스레드가 재생 시간 중에 쓴 시간 (시뮬레이션 보드에서는 보드 함수 호출 비용만,
+//            실제 보드에서 깨어날 때마다 드는 커널 비용은 깨어남/s 로 가늠한다)
+// 파형     : 녹음한 WAV 의 샘플이 원본과 모두 같은지 (다르면 어긋난 샘플 수)
+#include "../recommendation vending machine/voice.h"
+
+#include <math.h>
+#include <unistd.h>
+
+#define BENCH_POLL_US 50
+
+// 시험용 안내: 음절마다 음높이가 바뀌는 배음 합 (사람 목소리 대신)
+static int writeTestWav(const char* dir, const char* name, int ms, double pitch) {
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    FILE* f = fopen(path, "wb");
+    if (f == NULL) return -1;
+    int n = ms * (VOICE_RATE / 1000);
+    unsigned char head[44] = "RIFF....WAVEfmt ";
+    uint32_t fields[] = { 36 + (uint32_t)n, 16, 1 | (1 << 16), VOICE_RATE, VOICE_RATE, 1 | (8 << 16) };
+    memcpy(head + 4, &fields[0], 4);
+    memcpy(head + 16, &fields[1], 20);
+    memcpy(head + 36, "data", 4);
+    memcpy(head + 40, &n, 4);
+    fwrite(head, 1, sizeof(head), f);
+    double phase = 0;
+    for (int i = 0; i < n; i++) {
+        double t = (double)i / VOICE_RATE;
+        double syllable = fmod(t * 4.0, 1.0);  // 초당 4음절
+        double f0 = pitch * (1.0 + 0.3 * syllable) * (1.0 + 0.1 * floor(t * 4.0));
+        double env = sin(M_PI * syllable);
+        phase += 2 * M_PI * f0 / VOICE_RATE;
+        double v = env * (0.6 * sin(phase) + 0.25 * sin(2 * phase) + 0.15 * sin(3 * phase));
+        fputc((int)lround(128 + 120 * v), f);
+    }
+    fclose(f);
+    return 0;
+}
+
+// 녹음한 16비트 WAV 를 PWM 값(0~255)으로
+static int readRecording(const char* path, unsigned char* out, int max) {
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) return -1;
+    fseek(f, 44, SEEK_SET);
+    int n = 0;
+    unsigned char s[2];
+    while (n < max && fread(s, 1, 2, f) == 2) {
+        int v = (int16_t)(s[0] | (s[1] << 8));
+        out[n++] = (unsigned char)lround((v + 32768) / 65535.0 * VOICE_PWM_RANGE);
+    }
+    fclose(f);
+    return n;
+}
+
+// 안내의 원본 샘플
+static int promptSamples(int id, unsigned char* out, int max) {
+    const VoicePrompt* p = &voice.prompts[id];
+    int n = p->length < max ? p->length : max;
+    if (p->path[0] == '\0') {
+        memcpy(out, p->samples, (size_t)n);
+        return n;
+    }
+    FILE* f = fopen(p->path, "rb");
+    if (f == NULL) return -1;
+    fseek(f, p->offset, SEEK_SET);
+    n = (int)fread(out, 1, (size_t)n, f);
+    fclose(f);
+    return n;
+}
+
+// 한글은 화면에서 두 칸을 차지하므로 표시 폭 기준으로 왼쪽 정렬
+static void printName(const char* name, int width) {
+    int cols = 0;
+    for (const unsigned char* p = (const unsigned char*)name; *p; p++) {
+        if ((*p & 0xC0) == 0x80) continue;  // UTF-8 연속 바이트
+        cols += (*p >= 0xEA && *p <= 0xED) ? 2 : 1;  // 한글 음절(U+AC00~)만 두 칸
+    }
+    printf("  %s%*s", name, cols < width ? width - cols : 0, "");
+}
+
+// id 를 재생한다. cutMs > 0 이면 그만큼 뒤에 next 로 끊는다
+static void benchPrompt(const char* dir, const char* name, int id, int buffers, int cutMs, int next) {
+    static int run = 0;
+    char wavPath[300];
+    snprintf(wavPath, sizeof(wavPath), "%s/out_%d.wav", dir, ++run);
+    voice.buffers = buffers;
+    voice.maxLateNs = 0;
+    unsigned long samples = voice.samples, late = voice.late, underruns = voice.underruns, cut = voice.cut;
+    uint64_t cpu = voice.cpuNs;
+    simPwmWavOpen(voice.pin, wavPath, VOICE_RATE);
+
+    uint64_t start = simNowNs();
+    voiceSay(id);
+    uint64_t callNs = simNowNs() - start;
+    uint64_t first = 0;
+    int cutDone = 0;
+    while (voiceBusy()) {
+        if (first == 0 && voice.samples != samples) first = simNowNs();
+        if (cutMs > 0 && !cutDone && simNowNs() - start >= (uint64_t)cutMs * 1000000ULL) {
+            voiceSay(next);
+            cutDone = 1;
+        }
+        delayMicroseconds(BENCH_POLL_US);
+    }
+    uint64_t playNs = first ? simNowNs() - first : 0;
+    simPwmWavClose();
+
+    int want = cutMs > 0 ? voice.prompts[next].length : voice.prompts[id].length;
+    printName(name, 30);
+    printf(" %6.1f %6.2f %7.1f/%-6.1f %5lu %7.1f %4lu %6.3f %7.0f  ", callNs / 1e3, first ? (first - start) / 1e6 : 0.0,
+           playNs / 1e6, want * 1e3 / VOICE_RATE, voice.late - late, voice.maxLateNs / 1e3, voice.underruns - underruns,
+           playNs ? 100.0 * (voice.cpuNs - cpu) / playNs : 0.0,
+           playNs ? (voice.samples - samples) / (playNs / 1e9) : 0.0);
+    if (cutMs > 0) {
+        printf("끊김 %lu회\n", voice.cut - cut);
+        return;
+    }
+    static unsigned char got[VOICE_RATE * 10], expect[VOICE_RATE * 10];
+    int n = readRecording(wavPath, got, (int)sizeof(got));
+    int m = promptSamples(id, expect, (int)sizeof(expect));
+    int diff = 0;
+    for (int i = 0; i < m; i++) diff += (i >= n || got[i] != expect[i]);
+    if (diff == 0) printf("일치\n");
+    else printf("다름 (%d)\n", diff);
+}
+
+int main(int argc, char* argv[]) {
+    char tmp[] = "/tmp/bench_voice.XXXXXX";
+    const char* dir = (argc > 1) ? argv[1] : mkdtemp(tmp);
+    if (dir == NULL) {
+        printf("녹음 디렉터리를 만들 수 없음\n");
+        return 1;
+    }
+    if (writeTestWav(dir, "paid.wav", 1800, 140) != 0 || writeTestWav(dir, "soldout.wav", 900, 180) != 0) {
+        printf("%s 에 시험용 안내를 쓸 수 없음\n", dir);
+        return 1;
+    }
+
+    simClockMode(SIM_CLOCK_VIRTUAL);
+    if (wiringPiSetupGpio() == -1) {
+        printf("GPIO 초기화 실패\n");
+        return 1;
+    }
+    if (voiceBegin(18, dir) != 0) {
+        printf("voiceBegin 실패\n");
+        return 1;
+    }
+
+    printf("음성 안내 재생 벤치마크 (가상 시계, GPIO 18, %dHz, 버퍼 %d샘플)\n", VOICE_RATE, VOICE_BLOCK);
+    printf("녹음: %s/out_*.wav\n\n", dir);
+    printName("조건", 30);
+    printf(" %s %s %s %s %s %s %s %s  %s\n", "부르는us", "첫 ms", "재생 ms/원본", "늦음", "최대us", "부족", "CPU %",
+           "깨어남/s", "파형");
+
+    benchPrompt(dir, "결제 완료 (파일), 버퍼 2", VOICE_PAID, 2, 0, 0);
+    benchPrompt(dir, "결제 완료 (파일), 버퍼 1", VOICE_PAID, 1, 0, 0);
+    benchPrompt(dir, "입력음 (합성 1000Hz)", VOICE_INPUT, 2, 0, 0);
+    benchPrompt(dir, "카드 대기 (합성 삐빅)", VOICE_CARD, 2, 0, 0);
+    benchPrompt(dir, "금액 부족 (파일 없음, 합성)", VOICE_SHORT, 2, 0, 0);
+    benchPrompt(dir, "결제 완료 300ms 뒤 품절", VOICE_PAID, 2, 300, VOICE_SOLD_OUT);
+
+    simSetPreemption(20, 5000);
+    benchPrompt(dir, "선점 20/s x 5ms, 버퍼 2", VOICE_PAID, 2, 0, 0);
+    simSetPreemption(200, 50);
+    benchPrompt(dir, "선점 200/s x 50us, 버퍼 2", VOICE_PAID, 2, 0, 0);
+    return 0;
+}
@@ -0,0 +1,318 @@
+// XY 두 축 직선 보간 벤치마크 (Lab/xy_planner.h)
+//   1. 직선: 두 축의 핀이 바뀐 시각으로 위치를 되살려 직선에서 벗어난 거리와 한 틱 안에서 두 축이 바뀐 시각 차이
+//   2. 방향별 (X 만, 대각선, 3:1) 타이머 스레드 틱 하나의 CPU 비용 (실제 시계) 과 시뮬레이터가 낼 수 있는 가장 높은 스텝/초
+//   3. 여러 선분을 줄에 넣었을 때 이음에서 멈추지 않으면 (xyBlend) 얼마나 빨라지는지
+//
+// 빌드 및 실행 (저장소 최상위에서):
+//   gcc -O2 -Isim/include sim/bench_xy.c sim/sim_board.c -lm -o bench_xy
+//   ./bench_xy
+//
+// 틱 비용 말고는 가상 시계로 실행한다 (보드 함수 호출 한 번에 100ns). 모터 두 개 모두 반 스텝.
+// 가상 시계의 잠은 us 단위로 올림하므로 가장 높은 스텝/초는 틱 간격 1us 근처에서 멈춘다. 이것은 시뮬레이터의 한계이고
+// 실제 보드에서 속도를 막는 것은 틱 비용과 clock_nanosleep 으로 깨는 지연이다 (sim/bench_stepper.c).
+// 배선 (예): X 축 GPIO 20 21 19 26 (stepper.c), Y 축 GPIO 5 6 13 16.
+#include "../Lab/xy_planner.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <time.h>
+
+static const int xPins[4] = { 20, 21, 19, 26 };
+static const int yPins[4] = { 5, 6, 13, 16 };
+
+//1. 핀 기록
+typedef struct {
+    uint64_t ns;
+    uint32_t levels;
+} Edge;
+
+static Edge* edges;
+static int edgeCount, edgeCap;
+static uint32_t levels;
+
+static void recWrite(void* ctx, int pin, int value, uint64_t nowNs) {
+    (void)ctx;
+    uint32_t before = levels;
+    if (value) levels |= 1u << pin;
+    else levels &= ~(1u << pin);
+    if (levels == before) return;
+    if (edgeCount > 0 && edges[edgeCount - 1].ns == nowNs) {  // 한 번에 쓴 핀들
+        edges[edgeCount - 1].levels = levels;
+        return;
+    }
+    if (edgeCount == edgeCap) {
+        edgeCap = edgeCap ? edgeCap * 2 : 4096;
+        edges = realloc(edges, sizeof(Edge) * (size_t)edgeCap);
+    }
+    edges[edgeCount].ns = nowNs;
+    edges[edgeCount].levels = levels;
+    edgeCount++;
+}
+
+static const SimPinOps recOps = { NULL, recWrite, NULL, NULL };
+
+// 한글은 화면에서 두 칸을 차지하므로 표시 폭 기준으로 왼쪽 정렬
+static void printName(const char* name, int width) {
+    int cols = 0;
+    for (const unsigned char* p = (const unsigned char*)name; *p; p++) {
+        if ((*p & 0xC0) == 0x80) continue;  // UTF-8 연속 바이트
+        cols += (*p >= 0xEA && *p <= 0xED) ? 2 : 1;  // 한글 음절(U+AC00~)만 두 칸
+    }
+    printf("  %s%*s", name, cols < width ? width - cols : 0, "");
+}
+
+//2. 기록에서 위치 되살리기
+// 네 핀 모양의 반 스텝 상 칸 (상 표에 없으면 -1)
+static int phaseOf(const StepperCoils* c, uint32_t lv) {
+    for (int p = 0; p < 8; p++) {
+        if (c->on[p] == (lv & c->mask)) return p;
+    }
+    return -1;
+}
+
+typedef struct {
+    long x, y;           // 되살린 위치
+    long ticks;          // 위치가 바뀐 틱
+    double maxDev;       // 직선에서 벗어난 가장 큰 거리 (스텝)
+    uint64_t maxSkewNs;  // 한 틱 안에서 X 와 Y 가 바뀐 시각 차이
+    int invalid;
+    // 구간 [from, to) 틱의 축별 스텝/초
+    double spsX, spsY;
+} Trace;
+
+// (x0, y0) → (x0 + dx, y0 + dy) 직선과 비교한다 (px, py: 움직이기 전 상 칸, 코일이 꺼져 있었어도).
+// 1us 안에 이어진 변화는 한 틱으로 본다
+static Trace trace(int px, int py, long x0, long y0, long dx, long dy, long from, long to) {
+    Trace t = { x0, y0, 0, 0, 0, 0, 0, 0 };
+    double len = sqrt((double)dx * dx + (double)dy * dy);
+    uint64_t tickNs = 0, lastNs = 0, winStart = 0, winEnd = 0;
+    long wx = 0, wy = 0;
+    int xAt = -1, yAt = -1;  // 이번 틱에서 바뀐 기록 번호
+    for (int i = 0; i <= edgeCount; i++) {
+        if (i == edgeCount || edges[i].ns - lastNs > 1000) {  // 앞 틱 끝
+            if (i > 0 && (xAt >= 0 || yAt >= 0)) {
+                if (xAt >= 0 && yAt >= 0) {
+                    uint64_t a = edges[xAt].ns, b = edges[yAt].ns;
+                    uint64_t skew = a > b ? a - b : b - a;
+                    if (skew > t.maxSkewNs) t.maxSkewNs = skew;
+                }
+                double dev = len > 0 ? fabs((double)(t.x - x0) * dy - (double)(t.y - y0) * dx) / len : 0;
+                if (dev > t.maxDev) t.maxDev = dev;
+                if (t.ticks == from) {
+                    winStart = tickNs;
+                    wx = t.x;
+                    wy = t.y;
+                }
+                if (t.ticks == to) {
+                    winEnd = tickNs;
+                    t.spsX = labs(t.x - wx) * 1e9 / (double)(winEnd - winStart);
+                    t.spsY = labs(t.y - wy) * 1e9 / (double)(winEnd - winStart);
+                }
+                t.ticks++;
+            }
+            if (i == edgeCount) break;
+            xAt = yAt = -1;
+            tickNs = edges[i].ns;
+        }
+        lastNs = edges[i].ns;
+        int nx = phaseOf(&xy.x, edges[i].levels), ny = phaseOf(&xy.y, edges[i].levels);
+        if (nx < 0 || ny < 0) {
+            t.invalid++;
+            continue;
+        }
+        if (nx != px) {
+            t.x += ((nx - px) & 7) == 1 ? 1 : -1;
+            px = nx;
+            xAt = i;
+        }
+        if (ny != py) {
+            t.y += ((ny - py) & 7) == 1 ? 1 : -1;
+            py = ny;
+            yAt = i;
+        }
+    }
+    return t;
+}
+
+// 지금 위치에서 (dx, dy) 만큼 한 선분으로 가고 기록을 되살린다
+static Trace line(long dx, long dy, unsigned int sps, unsigned int accel, unsigned long* late, uint64_t* ns) {
+    xyWait();
+    xyConfig(sps, accel);
+    long x0, y0;
+    xyPosition(&x0, &y0);
+    edgeCount = 0;
+    int px = xy.x.phase, py = xy.y.phase;  // 타이머 스레드가 멈춰 있을 때
+    unsigned long lateStart = xy.late;
+    uint64_t start = simNowNs();
+    xyMoveTo(x0 + dx, y0 + dy);
+    xyWait();
+    *ns = simNowNs() - start;
+    *late = xy.late - lateStart;
+    long n = labs(dx) > labs(dy) ? labs(dx) : labs(dy);
+    return trace(px, py, x0, y0, dx, dy, n * 3 / 10, n * 7 / 10);
+}
+
+//3. 직선
+static void benchLines(void) {
+    static const struct {
+        const char* name;
+        long dx, dy;
+    } lines[] = {
+        { "X 만", 8000, 0 }, { "대각선 1:1", -6000, -6000 }, { "3:1", 9000, 3000 }, { "1:7", -1000, -7000 },
+        { "소수 비 2999:1000", 2999, 1000 },
+    };
+    printf("직선 (큰 축 5000 스텝/초, 가속 50000 스텝/초^2)\n");
+    printName("선분", 22);
+    printf(" %8s %8s %10s %10s %9s %9s %5s %5s\n", "X 스텝", "Y 스텝", "벗어남", "축차이ns", "X /초", "Y /초", "중간",
+           "맞춤");
+    for (size_t i = 0; i < sizeof(lines) / sizeof(lines[0]); i++) {
+        unsigned long late;
+        uint64_t ns;
+        long x0, y0;
+        xyPosition(&x0, &y0);
+        Trace t = line(lines[i].dx, lines[i].dy, 5000, 50000, &late, &ns);
+        int ok = (t.x - x0 == lines[i].dx) && (t.y - y0 == lines[i].dy);
+        printName(lines[i].name, 22);
+        printf(" %8ld %8ld %10.3f %10lu %9.0f %9.0f %5d %5lu%s\n", t.x - x0, t.y - y0, t.maxDev,
+               (unsigned long)t.maxSkewNs, t.spsX, t.spsY, t.invalid, late, ok ? "" : "  (목표와 다름)");
+    }
+    printf("  벗어남: 되살린 위치가 직선에서 떨어진 가장 큰 거리 (스텝). 축차이: 한 틱에서 두 축 핀이 바뀐 시각 차이\n\n");
+}
+
+//4. 방향별 틱 비용과 시뮬레이터 한계
+// xyTimer 가 틱마다 하는 계산 (가속 표, 브레즌햄, 두 축의 상, 바꿀 핀) 만 실제 시계로 잰다. 핀 쓰기는 빠진다
+static double tickCpuNs(long ux, long uy) {
+    static StepperRamp ramp;
+    StepperCoils cx, cy;
+    stepperCoilsInit(&cx, xPins, 1);
+    stepperCoilsInit(&cy, yPins, 1);
+    stepperRampInit(&ramp, 100000, 10000000);
+    long big = ux > uy ? ux : uy;
+    const long n = 20000000;
+    long ax = n * ux / big, ay = n * uy / big, err = n / 2;
+    uint32_t mask = cx.mask | cy.mask, out = 0, sink = 0;
+    int level = 0;
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (long done = 0; done < n; done++) {
+        uint32_t ns = stepperSpeed(&ramp, &level, n - done);
+        int stepX = 1, stepY = 1;
+        if (ax >= ay) {
+            err -= ay;
+            stepY = err < 0;
+        } else {
+            err -= ax;
+            stepX = err < 0;
+        }
+        if (err < 0) err += n;
+        uint32_t on = stepX ? stepperCoilsNext(&cx, 1) : cx.on[cx.phase];
+        on |= stepY ? stepperCoilsNext(&cy, 1) : cy.on[cy.phase];
+        sink += (on & mask & ~out) ^ (out & mask & ~on) ^ ns;
+        out = on;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    if (sink == 1) printf(" ");  // 계산이 지워지지 않도록
+    return ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / n;
+}
+
+// 최고 속도가 정한 속도의 99% 이상이고 다시 맞춤이 없는 가장 높은 큰 축 스텝/초 (가상 시계, 2배씩 올린다)
+static void benchLimit(const char* name, long ux, long uy) {
+    unsigned int best = 0;
+    double bestX = 0, bestY = 0;
+    for (unsigned int sps = 1000; sps <= 4096000; sps *= 2) {
+        long n = sps / 2 > 4000 ? sps / 2 : 4000;
+        long big = ux > uy ? ux : uy;
+        unsigned long late;
+        uint64_t ns;
+        Trace t = line(n * ux / big, n * uy / big, sps, sps / 1000 * sps, &late, &ns);  // 가속 500 스텝
+        double major = t.spsX > t.spsY ? t.spsX : t.spsY;
+        if (late > 0 || major < sps * 0.99) break;
+        best = sps;
+        bestX = t.spsX;
+        bestY = t.spsY;
+    }
+    printName(name, 22);
+    printf(" %8.1f %9u %9.0f %9.0f\n", tickCpuNs(ux, uy), best, bestX, bestY);
+}
+
+//5. 여러 선분
+static double route(const char* name, const long (*points)[2], int count) {
+    xyWait();
+    xyConfig(5000, 50000);
+    unsigned long blended = xy.blended, stops = xy.stops;
+    uint64_t start = simNowNs();
+    for (int i = 0; i < count; i++) {
+        while (xyMoveTo(points[i][0], points[i][1]) != 0) delay(1);  // 줄이 차면 앞 선분이 끝날 때까지
+    }
+    xyWait();
+    double ms = (simNowNs() - start) / 1e6;
+    long x, y;
+    xyPosition(&x, &y);
+    printName(name, 22);
+    printf(" %5d %10.1f %8lu %8lu %s\n", count, ms, xy.blended - blended, xy.stops - stops,
+           (x == points[count - 1][0] && y == points[count - 1][1]) ? "" : "  (목표와 다름)");
+    return ms;
+}
+
+static void benchRoutes(void) {
+    static long circle[49][2];
+    int n = 0;
+    for (int k = 1; k <= 48; k++) {  // 반지름 4000 의 48각형 한 바퀴 (중심 (0, 0), (4000, 0) 에서 시작)
+        double a = 2 * M_PI * k / 48;
+        circle[n][0] = lround(4000 * cos(a));
+        circle[n][1] = lround(4000 * sin(a));
+        n++;
+    }
+    static const long slots[][2] = {  // 음료 칸 네 개를 돌고 배출구로 (직각 이음)
+        { 4000, 0 }, { 4000, 3000 }, { 8000, 3000 }, { 8000, 6000 }, { 0, 6000 }, { 0, 0 },
+    };
+    static const long zigzag[][2] = {  // 비스듬한 꺾은선 (30도 정도씩 꺾임)
+        { 2000, 600 }, { 4000, 0 }, { 6000, 600 }, { 8000, 0 }, { 10000, 600 }, { 12000, 0 },
+        { 10000, 600 }, { 8000, 0 }, { 6000, 600 }, { 4000, 0 }, { 2000, 600 }, { 0, 0 },
+    };
+
+    printf("여러 선분 (큰 축 5000 스텝/초, 가속 50000 스텝/초^2, 줄 %d칸)\n", XY_QUEUE_MAX);
+    for (int blend = 1; blend >= 0; blend--) {
+        xyBlend = blend;
+        printf(" %s\n", blend ? "이음에서 멈추지 않음 (xyBlend = 1)" : "선분마다 멈춤 (xyBlend = 0)");
+        printName("경로", 22);
+        printf(" %5s %10s %8s %8s\n", "선분", "시간ms", "이어감", "멈춤");
+        xyWait();
+        xyMoveTo(4000, 0);
+        xyWait();
+        route("48각형 한 바퀴", (const long(*)[2])circle, n);
+        route("칸 네 개 (직각)", slots, (int)(sizeof(slots) / sizeof(slots[0])));
+        route("꺾은선", zigzag, (int)(sizeof(zigzag) / sizeof(zigzag[0])));
+    }
+    xyBlend = 1;
+    printf("\n");
+}
+
+int main(void) {
+    simClockMode(SIM_CLOCK_VIRTUAL);
+    if (wiringPiSetupGpio() == -1) {
+        printf("GPIO 초기화 실패\n");
+        return 1;
+    }
+    for (int i = 0; i < 4; i++) {
+        simAttach(xPins[i], &recOps, NULL);
+        simAttach(yPins[i], &recOps, NULL);
+    }
+    xyBegin(xPins, yPins, 1, 5000, 50000);
+
+    printf("XY 두 축 보간 벤치마크 (가상 시계, 반 스텝)\n\n");
+    benchLines();
+
+    printf("틱 비용 (실제 시계) 과 시뮬레이터가 낸 가장 높은 속도 (가상 시계, 가속 500 스텝, 큰 축 속도를 2배씩)\n");
+    printName("방향", 22);
+    printf(" %8s %9s %9s %9s\n", "틱 ns", "큰 축/초", "X /초", "Y /초");
+    benchLimit("X 만", 1, 0);
+    benchLimit("대각선 1:1", 1, 1);
+    benchLimit("3:1", 3, 1);
+    printf("  틱 ns: 이 PC 에서 틱 하나의 계산 (핀 쓰기 제외), 실제 보드에서 속도를 막는 값\n");
+    printf("  /초: 시뮬레이터의 한계 (가상 시계의 잠이 1us 단위라서 틱 간격 1us 근처에서 멈춘다)\n\n");
+
+    benchRoutes();
+    free(edges);
+    return 0;
+}
@@ -0,0 +1,2 @@
+// 시뮬레이션 보드용 <lcd.h> 대체 헤더 (sim_board.h 참고)
+#include "../sim_board.h"
@@ -0,0 +1,30 @@
+// 실습 코드의 센서 디코더 묶음 (bench_decoders.c 에서 사용)
+// 각 실습 파일의 main 과 서로 겹치는 이름만 바꿔서 원본 그대로 포함한다.
+//   dht11.c   : read_dht11_dat -> labReadDht11, dht11_dat -> labDht11Dat
+//   hc-sr04.c : getDistance -> hcsr04GetDistance
+//   ex4.c     : getDistance -> ex4GetDistance
+//   ilum.c    : ReadMcp3208ADC (그대로)
+
+#define main dht11Main
+#define read_dht11_dat labReadDht11
+#define dht11_dat labDht11Dat
+#include "../Lab/Week9(Sensor Control 1)/dht11.c"
+#undef read_dht11_dat
+#undef dht11_dat
+#undef main
+
+#define main hcsr04Main
+#define getDistance hcsr04GetDistance
+#include "../Lab/Week10(Sensor Control 2)/hc-sr04.c"
+#undef getDistance
+#undef main
+
+#define main ex4Main
+#define getDistance ex4GetDistance
+#include "../Lab/Week10(Sensor Control 2)/ex4.c"
+#undef getDistance
+#undef main
+
+#define main ilumMain
+#include "../Lab/Week9(Sensor Control 1)/ilum.c"
+#undef main
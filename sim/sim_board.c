@@ -0,0 +1,1537 @@
+// 시뮬레이션 보드 구현 (sim_board.h 참고)
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+#include <math.h>
+#include <ucontext.h>
+#include "sim_board.h"
+
+#define NS_PER_US 1000ULL
+#define NS_PER_MS 1000000ULL
+#define NS_PER_S  1000000000ULL
+
+// 핀 상태
+typedef struct {
+    int mode;          // INPUT / OUTPUT / PWM_OUTPUT
+    int pud;           // 풀업/풀다운 설정
+    int level;         // 출력 레벨
+    int inputLevel;    // 스크립트로 고정한 입력 레벨 (-1: 없음)
+    int pwm;           // softPwm / pwmWrite 값
+    int pwmRange;      // softPwm 범위
+    int tone;          // softTone 주파수
+    const SimPinOps* ops;  // 연결된 가상 장치
+    void* ctx;
+} SimPin;
+
+static SimPin pins[SIM_MAX_PINS];
+
+// 하드웨어 PWM (채널 0: GPIO 12/18, 채널 1: GPIO 13/19). 클럭 분주와 범위, 모드는 두 채널이 함께 쓴다.
+#define SIM_PWM_OSC_HZ 19200000
+static int pwmHwMode = PWM_MODE_BAL;
+static unsigned int pwmHwRange = 1024;
+static int pwmHwClock = 32;
+static int boardReady = 0;
+static uint64_t startNs;      // 실제 시각 기준점
+static int idleExitMs = 0;
+
+// 가상 시계
+static int clockMode = SIM_CLOCK_REAL;
+static uint64_t virtNs;          // 가상 시각
+static unsigned int opCostNs = 100;
+static int idleSkip = 1;
+static int lastReadPin = -1;     // 직전 보드 함수가 이 핀의 digitalRead 였는지 (대기 루프 감지, SIM_MAX_PINS: simGpioLevels)
+static int lastReadValue;
+static int sameReads;            // 같은 핀에서 같은 값을 연속으로 읽은 횟수
+static uint64_t spinStartNs;     // 같은 값을 읽기 시작한 시각
+#define SPIN_READS 4             // 이만큼 연속이면 대기 루프로 본다
+static unsigned int stallLimitMs = 10000;  // 이보다 오래 끝나지 않는 대기 루프는 멈춘 것으로 본다
+static void (*stallHandler)(int pin);
+
+// 선점(스케줄러가 프로그램을 멈추는 구간) 모델 (가상 시계)
+static unsigned int preemptRate;  // 초당 평균 선점 횟수
+static uint64_t preemptNs;        // 한 번 선점될 때 멈추는 시간
+static uint64_t nextPreemptNs;    // 다음 선점 시각
+
+// 결정적 난수 (같은 시드면 같은 잡음)
+static uint64_t rngState = 0x9E3779B97F4A7C15ULL;
+
+// 실행 통계
+static struct {
+    unsigned long reads, bulkReads, writes, bulkWrites, modes, delays, skips, preempts, stalls, interrupts;
+    unsigned long lcdChars, lcdCmds, lcdLost;
+    uint64_t delayedNs, lcdNs;
+} stats;
+
+static uint64_t monoNs(clockid_t id) {
+    struct timespec ts;
+    clock_gettime(id, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void boardInit(void) {
+    if (boardReady) return;
+    for (int i = 0; i < SIM_MAX_PINS; i++) {
+        memset(&pins[i], 0, sizeof(pins[i]));
+        pins[i].inputLevel = -1;
+    }
+    startNs = monoNs(CLOCK_MONOTONIC);
+    boardReady = 1;
+}
+
+uint64_t simNowNs(void) {
+    boardInit();
+    if (clockMode == SIM_CLOCK_VIRTUAL) return virtNs;
+    return monoNs(CLOCK_MONOTONIC) - startNs;
+}
+
+uint64_t simWallNs(void) {
+    boardInit();
+    return monoNs(CLOCK_MONOTONIC) - startNs;
+}
+
+uint64_t simCpuNs(void) {
+    return monoNs(CLOCK_PROCESS_CPUTIME_ID);
+}
+
+void simClockMode(int mode) {
+    boardInit();
+    clockMode = mode;
+}
+
+int simClockIsVirtual(void) {
+    return clockMode == SIM_CLOCK_VIRTUAL;
+}
+
+void simSetOpCost(unsigned int ns) {
+    opCostNs = ns;
+}
+
+void simSetIdleSkip(int on) {
+    idleSkip = on;
+}
+
+static void schedulePreemption(void);
+
+void simSetPreemption(unsigned int perSecond, unsigned int us) {
+    preemptRate = perSecond;
+    preemptNs = (uint64_t)us * 1000;
+    schedulePreemption();
+}
+
+void simSetStallHandler(unsigned int limitMs, void (*handler)(int pin)) {
+    stallLimitMs = limitMs;
+    stallHandler = handler;
+}
+
+void simSeed(uint64_t seed) {
+    rngState = seed ? seed : 0x9E3779B97F4A7C15ULL;
+}
+
+// xorshift64*
+uint64_t simRandom(void) {
+    rngState ^= rngState >> 12;
+    rngState ^= rngState << 25;
+    rngState ^= rngState >> 27;
+    return rngState * 0x2545F4914F6CDD1DULL;
+}
+
+double simRandomUnit(void) {
+    return (double)(simRandom() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// 평균 0, 표준편차 1 (Box-Muller)
+double simRandomGauss(void) {
+    double u = simRandomUnit();
+    double v = simRandomUnit();
+    if (u < 1e-300) u = 1e-300;
+    return sqrt(-2.0 * log(u)) * cos(6.283185307179586 * v);
+}
+
+// 시드와 입력으로 정해지는 [0, 1) 값 (같은 시각을 다시 읽어도 같은 레벨이 나오도록)
+double simRandomHash(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return (double)(x >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// 선점은 가상 시간 위의 포아송 과정: 다음 선점까지의 간격은 지수 분포
+static void schedulePreemption(void) {
+    if (preemptRate == 0) return;
+    double u = simRandomUnit();
+    if (u < 1e-300) u = 1e-300;
+    nextPreemptNs = virtNs + (uint64_t)(-log(u) / preemptRate * 1e9);
+}
+
+// 보드 함수 호출 한 번에 드는 시간 (가상 시계에서만)
+// 선점 시각이 지났으면 그만큼 늦게 실행된다 (대기 루프라면 레벨 변화를 늦게 본다).
+static uint64_t boardOp(void) {
+    if (clockMode == SIM_CLOCK_VIRTUAL) {
+        virtNs += opCostNs;
+        if (preemptRate && virtNs >= nextPreemptNs) {
+            virtNs += preemptNs;
+            stats.preempts++;
+            schedulePreemption();
+        }
+    }
+    lastReadPin = -1;
+    return simNowNs();
+}
+
+static SimPin* pinAt(int pin) {
+    boardInit();
+    if (pin < 0 || pin >= SIM_MAX_PINS) return NULL;
+    return &pins[pin];
+}
+
+static void simTick(uint64_t now);
+
+
+//1. 키패드 모델
+typedef struct {
+    uint16_t mask;   // 누를 키 (bit = row * 4 + col), 0 이면 대기 구간
+    int holdMs;      // 누르고 있는 시간
+    int idleMs;      // 대기 구간 길이
+} SimKeyStep;
+
+static struct {
+    int attached;
+    int rowPins[4];
+    int colPins[4];
+    char keys[4][4];
+    SimKeyStep* steps;
+    int count, cap, head;
+    int scripted;          // 스크립트가 한 번이라도 주어졌는지
+    uint16_t active;       // 현재 눌린 키
+    uint16_t released;     // 마지막으로 뗀 키
+    uint64_t downAtNs;     // 현재 키를 누른 시각
+    uint64_t upAtNs;       // 현재 키를 떼는 시각
+    uint64_t nextAtNs;     // 다음 키를 누를 수 있는 시각
+    uint64_t lastEventNs;  // 마지막 키 변화 시각
+    int inIdle;            // 스크립트 대기 구간(~) 진행 중
+    int holdMs, gapMs;
+    int bounceUs;          // 누르고 뗀 직후 접점이 떨리는 시간
+    uint64_t bounceSeed;
+} kp = { .holdMs = 80, .gapMs = 80 };
+
+#define BOUNCE_SLOT_NS (50 * NS_PER_US)  // 떨리는 동안 접점 상태가 바뀔 수 있는 간격
+
+// 떨림 구간의 시작 시각. 떨림 구간이 아니면 0
+static uint64_t keypadBounceStart(uint64_t now) {
+    if (kp.bounceUs == 0) return 0;
+    uint64_t since = kp.active ? kp.downAtNs : kp.upAtNs;
+    if ((kp.active | kp.released) == 0 || now < since) return 0;
+    if (now - since >= (uint64_t)kp.bounceUs * NS_PER_US) return 0;
+    return since;
+}
+
+// 접점이 닫혀 있는 키.
+// 떨림 구간에서는 50us 마다 무작위로 열리고 닫히며, 시간이 지날수록 안정된 상태에 가까워진다.
+static uint16_t keypadContacts(uint64_t now) {
+    uint64_t since = keypadBounceStart(now);
+    if (since == 0) return kp.active;
+    uint64_t t = now - since;
+    double closed = (double)t / ((double)kp.bounceUs * NS_PER_US);
+    if (!kp.active) closed = 1.0 - closed;
+    uint16_t mask = kp.active ? kp.active : kp.released;
+    return simRandomHash(kp.bounceSeed ^ (t / BOUNCE_SLOT_NS)) < closed ? mask : 0;
+}
+
+static int keypadColRead(void* ctx, int pin, uint64_t nowNs) {
+    (void)ctx;
+    uint16_t contacts = keypadContacts(nowNs);
+    for (int c = 0; c < 4; c++) {
+        if (kp.colPins[c] != pin) continue;
+        for (int r = 0; r < 4; r++) {
+            if ((contacts & (1u << (r * 4 + c))) && simPinLevel(kp.rowPins[r]) == HIGH) {
+                return HIGH;
+            }
+        }
+    }
+    return LOW;
+}
+
+// 키패드 상태는 키를 떼는 시각이나 다음 키를 누를 수 있는 시각에만 바뀐다
+static uint64_t keypadNext(void* ctx, int pin, uint64_t nowNs) {
+    (void)ctx; (void)pin;
+    uint64_t since = keypadBounceStart(nowNs);
+    if (since != 0) return since + ((nowNs - since) / BOUNCE_SLOT_NS + 1) * BOUNCE_SLOT_NS;
+    if (kp.active) return kp.upAtNs;
+    if (kp.head < kp.count && kp.nextAtNs > nowNs) return kp.nextAtNs;
+    return UINT64_MAX;
+}
+
+static const SimPinOps keypadColOps = { keypadColRead, NULL, NULL, keypadNext };
+
+void simKeypadAttach(const int rowPins[4], const int colPins[4], const char keys[4][4]) {
+    boardInit();
+    memcpy(kp.rowPins, rowPins, sizeof(kp.rowPins));
+    memcpy(kp.colPins, colPins, sizeof(kp.colPins));
+    memcpy(kp.keys, keys, sizeof(kp.keys));
+    for (int c = 0; c < 4; c++) simAttach(colPins[c], &keypadColOps, NULL);
+    kp.attached = 1;
+}
+
+void simKeypadTiming(int holdMs, int gapMs) {
+    kp.holdMs = holdMs;
+    kp.gapMs = gapMs;
+}
+
+void simKeypadBounce(int bounceUs) {
+    kp.bounceUs = bounceUs;
+}
+
+int simKeypadPending(void) {
+    return kp.count - kp.head + (kp.active ? 1 : 0);
+}
+
+static int keyBit(char key) {
+    for (int r = 0; r < 4; r++)
+        for (int c = 0; c < 4; c++)
+            if (kp.keys[r][c] == key) return r * 4 + c;
+    return -1;
+}
+
+static void pushStep(uint16_t mask, int holdMs, int idleMs) {
+    if (kp.count == kp.cap) {
+        kp.cap = kp.cap ? kp.cap * 2 : 64;
+        kp.steps = realloc(kp.steps, (size_t)kp.cap * sizeof(SimKeyStep));
+        if (kp.steps == NULL) {
+            fprintf(stderr, "sim: 키 스크립트 메모리 부족\n");
+            exit(1);
+        }
+    }
+    kp.steps[kp.count].mask = mask;
+    kp.steps[kp.count].holdMs = holdMs;
+    kp.steps[kp.count].idleMs = idleMs;
+    kp.count++;
+}
+
+int simKeypadScript(const char* script) {
+    const char* p = script;
+    while (*p) {
+        if (*p == ' ' || *p == '\n' || *p == '\t') {
+            p++;
+        } else if (*p == '~') {  // 대기 구간
+            char* end;
+            long ms = strtol(p + 1, &end, 10);
+            pushStep(0, 0, (int)ms);
+            p = end;
+        } else if (*p == '(') {  // 동시 누름
+            uint16_t mask = 0;
+            int holdMs = kp.holdMs;
+            p++;
+            while (*p && *p != ')' && *p != ':') {
+                int bit = keyBit(*p);
+                if (bit < 0) {
+                    fprintf(stderr, "sim: 알 수 없는 키 '%c'\n", *p);
+                    return -1;
+                }
+                mask |= (uint16_t)(1u << bit);
+                p++;
+            }
+            if (*p == ':') {
+                char* end;
+                holdMs = (int)strtol(p + 1, &end, 10);
+                p = end;
+            }
+            if (*p != ')') {
+                fprintf(stderr, "sim: 키 스크립트 괄호 오류\n");
+                return -1;
+            }
+            p++;
+            pushStep(mask, holdMs, 0);
+        } else {
+            int bit = keyBit(*p);
+            if (bit < 0) {
+                fprintf(stderr, "sim: 알 수 없는 키 '%c'\n", *p);
+                return -1;
+            }
+            pushStep((uint16_t)(1u << bit), kp.holdMs, 0);
+            p++;
+        }
+    }
+    kp.scripted = 1;
+    return 0;
+}
+
+// 행 핀 중 하나라도 HIGH 이면 프로그램이 키패드를 읽고 있는 중
+static int keypadListening(void) {
+    for (int r = 0; r < 4; r++) {
+        if (simPinLevel(kp.rowPins[r]) == HIGH) return 1;
+    }
+    return 0;
+}
+
+// 시각에 맞춰 키를 누르고 뗀다.
+// 다음 키는 간격이 지난 뒤 프로그램이 키패드를 읽고 있을 때 눌린다.
+// (손님이 화면을 보고 나서 누르는 것과 같으므로 스크립트가 유실되지 않는다)
+static void keypadUpdate(uint64_t now) {
+    if (!kp.attached) return;
+    if (kp.active && now >= kp.upAtNs) {
+        kp.released = kp.active;
+        kp.bounceSeed = simRandom();
+        kp.active = 0;
+        kp.nextAtNs = kp.upAtNs + (uint64_t)kp.gapMs * NS_PER_MS;
+        kp.lastEventNs = kp.upAtNs;
+    }
+    if (kp.inIdle && now >= kp.nextAtNs) {
+        kp.inIdle = 0;
+        kp.lastEventNs = kp.nextAtNs;
+    }
+    while (!kp.active && kp.head < kp.count && now >= kp.nextAtNs) {
+        if (kp.steps[kp.head].mask != 0 && !keypadListening()) break;
+        SimKeyStep* s = &kp.steps[kp.head++];
+        kp.lastEventNs = now;
+        if (s->mask == 0) {
+            kp.nextAtNs = now + (uint64_t)s->idleMs * NS_PER_MS;
+            kp.inIdle = 1;
+        } else {
+            kp.active = s->mask;
+            kp.released = 0;
+            kp.bounceSeed = simRandom();
+            kp.downAtNs = now;
+            kp.upAtNs = now + (uint64_t)s->holdMs * NS_PER_MS;
+        }
+    }
+}
+
+
+//2. DHT11 모델
+#define DHT_SEGMENTS 84
+
+static struct {
+    int pin;
+    int data[5];
+    uint64_t lowSinceNs;   // 호스트가 LOW 를 출력한 시각
+    int lowHeld;           // 시작 신호 LOW 유지 중
+    int ready;             // 18ms 이상 LOW 후 HIGH: 응답 준비
+    int framing;           // 응답 파형 출력 중
+    uint64_t frameNs;      // 응답 시작 시각
+    uint32_t segEndUs[DHT_SEGMENTS];  // 각 구간이 끝나는 시각 (응답 시작 기준)
+    uint8_t segLevel[DHT_SEGMENTS];
+    int segCount;
+    int jitterUs;          // 구간 길이의 흔들림 (센서 내부 발진기 오차)
+} dht = { .pin = -1, .data = { 40, 0, 25, 0, 65 } };
+
+static void dhtAddSeg(uint32_t* t, int level, uint32_t us) {
+    if (dht.jitterUs > 0) {
+        int d = (int)(simRandom() % (uint64_t)(2 * dht.jitterUs + 1)) - dht.jitterUs;
+        us = ((int)us + d > 1) ? (uint32_t)((int)us + d) : 1;
+    }
+    *t += us;
+    dht.segEndUs[dht.segCount] = *t;
+    dht.segLevel[dht.segCount] = (uint8_t)level;
+    dht.segCount++;
+}
+
+// 응답 파형: 대기 30us, LOW 80us, HIGH 80us, 비트마다 LOW 50us + HIGH 26us(0)/70us(1), 끝 LOW 50us
+static void dhtBuildFrame(void) {
+    uint32_t t = 0;
+    dht.segCount = 0;
+    dhtAddSeg(&t, HIGH, 30);
+    dhtAddSeg(&t, LOW, 80);
+    dhtAddSeg(&t, HIGH, 80);
+    for (int i = 0; i < 40; i++) {
+        int bit = (dht.data[i / 8] >> (7 - i % 8)) & 1;
+        dhtAddSeg(&t, LOW, 50);
+        dhtAddSeg(&t, HIGH, bit ? 70 : 26);
+    }
+    dhtAddSeg(&t, LOW, 50);
+}
+
+static int dhtRead(void* ctx, int pin, uint64_t nowNs) {
+    (void)ctx; (void)pin;
+    if (!dht.framing) return HIGH;  // 풀업에 의해 HIGH
+    uint64_t us = (nowNs - dht.frameNs) / NS_PER_US;
+    for (int i = 0; i < dht.segCount; i++) {
+        if (us < dht.segEndUs[i]) return dht.segLevel[i];
+    }
+    dht.framing = 0;
+    return HIGH;
+}
+
+static void dhtWrite(void* ctx, int pin, int value, uint64_t nowNs) {
+    (void)ctx; (void)pin;
+    if (value == LOW) {
+        dht.lowSinceNs = nowNs;
+        dht.lowHeld = 1;
+        dht.framing = 0;
+    } else {
+        dht.ready = dht.lowHeld && nowNs - dht.lowSinceNs >= 18 * NS_PER_MS;
+        dht.lowHeld = 0;
+    }
+}
+
+static void dhtMode(void* ctx, int pin, int mode, uint64_t nowNs) {
+    (void)ctx; (void)pin;
+    if (mode == INPUT && dht.ready) {
+        dht.ready = 0;
+        dhtBuildFrame();
+        dht.frameNs = nowNs;
+        dht.framing = 1;
+    }
+}
+
+static uint64_t dhtNext(void* ctx, int pin, uint64_t nowNs) {
+    (void)ctx; (void)pin;
+    if (!dht.framing) return UINT64_MAX;
+    uint64_t us = (nowNs - dht.frameNs) / NS_PER_US;
+    for (int i = 0; i < dht.segCount; i++) {
+        if (us < dht.segEndUs[i]) return dht.frameNs + (uint64_t)dht.segEndUs[i] * NS_PER_US;
+    }
+    return UINT64_MAX;
+}
+
+static const SimPinOps dhtOps = { dhtRead, dhtWrite, dhtMode, dhtNext };
+
+void simDht11Attach(int pin) {
+    dht.pin = pin;
+    simAttach(pin, &dhtOps, NULL);
+}
+
+void simDht11Set(int humidity, int humidityDec, int temp, int tempDec) {
+    dht.data[0] = humidity & 0xff;
+    dht.data[1] = humidityDec & 0xff;
+    dht.data[2] = temp & 0xff;
+    dht.data[3] = tempDec & 0xff;
+    dht.data[4] = (dht.data[0] + dht.data[1] + dht.data[2] + dht.data[3]) & 0xff;
+}
+
+void simDht11Jitter(int jitterUs) {
+    dht.jitterUs = jitterUs;
+}
+
+
+//3. I2C(PCF8591), SPI(MCP3208), RFID
+#define PCF8591_ADDR 0x48
+#define I2C_FD_BASE 100
+
+static struct {
+    int value[4];
+    int channel;
+    int last;      // 이전 변환 결과 (PCF8591 은 한 번 늦게 값을 돌려준다)
+} pcf = { .value = { 50, 0, 0, 0 } };
+
+static int mcpValue[8];
+
+static struct {
+    double sigma;          // 가우스 잡음 표준편차 (LSB)
+    unsigned int spikePpm; // 변환 백만 번당 튀는 값 횟수
+} mcpNoise[8];
+
+static char cardResults[256] = "1";
+static int cardIndex = 0;
+
+void simPcf8591Set(int channel, int value) {
+    pcf.value[channel & 3] = value & 0xff;
+}
+
+void simMcp3208Set(int channel, int value) {
+    mcpValue[channel & 7] = value & 0x0fff;
+}
+
+void simMcp3208Noise(int channel, double sigma, unsigned int spikePerMillion) {
+    mcpNoise[channel & 7].sigma = sigma;
+    mcpNoise[channel & 7].spikePpm = spikePerMillion;
+}
+
+// 잡음이 섞인 변환 결과 (0~4095)
+static int mcpSample(int ch) {
+    int value = mcpValue[ch];
+    if (mcpNoise[ch].spikePpm && simRandom() % 1000000 < mcpNoise[ch].spikePpm) {
+        return (int)(simRandom() & 0x0fff);
+    }
+    if (mcpNoise[ch].sigma > 0) {
+        value += (int)lround(simRandomGauss() * mcpNoise[ch].sigma);
+        if (value < 0) value = 0;
+        if (value > 0x0fff) value = 0x0fff;
+    }
+    return value;
+}
+
+void simCardScript(const char* results) {
+    snprintf(cardResults, sizeof(cardResults), "%s", results);
+    cardIndex = 0;
+}
+
+int simRfidRead(void) {
+    if (cardResults[0] == '\0') return 1;
+    char c = cardResults[cardIndex];
+    if (cardResults[cardIndex + 1] != '\0') cardIndex++;  // 마지막 결과는 반복
+    return c == '1';
+}
+
+int wiringPiI2CSetup(const int devId) {
+    boardInit();
+    if (devId != PCF8591_ADDR) return -1;
+    return I2C_FD_BASE + devId;
+}
+
+int wiringPiI2CWrite(int fd, int data) {
+    if (fd != I2C_FD_BASE + PCF8591_ADDR) return -1;
+    pcf.channel = data & 3;
+    return 0;
+}
+
+int wiringPiI2CRead(int fd) {
+    if (fd != I2C_FD_BASE + PCF8591_ADDR) return -1;
+    int prev = pcf.last;
+    pcf.last = pcf.value[pcf.channel];
+    return prev;
+}
+
+int wiringPiSPISetup(int channel, int speed) {
+    (void)speed;
+    boardInit();
+    return (channel == 0 || channel == 1) ? 3 + channel : -1;
+}
+
+// MCP3208 싱글 엔디드 변환 명령 해석: 0000 01SD | D1D0xx xxxx | xxxx xxxx
+int wiringPiSPIDataRW(int channel, unsigned char* data, int len) {
+    (void)channel;
+    if (len < 3) return -1;
+    int ch = ((data[0] & 0x01) << 2) | ((data[1] >> 6) & 0x03);
+    int value = mcpSample(ch);
+    data[0] = 0;
+    data[1] = (unsigned char)((value >> 8) & 0x0f);
+    data[2] = (unsigned char)(value & 0xff);
+    return len;
+}
+
+
+//4. LCD (문자 버퍼)
+#define SIM_MAX_LCDS 8  // wiringPi lcd.c 의 MAX_LCDS
+
+// HD44780 에 보내는 데 걸리는 시간 (wiringPi lcd.c 의 4비트 모드 대기와 같게)
+//   바이트 하나: 니블 2개 x strobe (50us + 50us)
+//   명령: 바이트 + delay(2), lcdClear: 명령 2개 (CLEAR, HOME) + delay(5), lcdHome: 명령 + delay(5)
+#define LCD_BYTE_NS (200 * NS_PER_US)
+#define LCD_CMD_NS  (LCD_BYTE_NS + 2 * NS_PER_MS)
+#define LCD_HOME_NS (5 * NS_PER_MS)
+
+static void lcdBusy(uint64_t ns);
+
+static struct {
+    int used;
+    int rows, cols;
+    int x, y;
+    char text[4][21];
+    unsigned char cg[64];  // CGRAM: 사용자 문자 8개 x 8줄
+} lcds[SIM_MAX_LCDS];
+
+int lcdInit(const int rows, const int cols, const int bits,
+            const int rs, const int strb,
+            const int d0, const int d1, const int d2, const int d3,
+            const int d4, const int d5, const int d6, const int d7) {
+    (void)bits; (void)rs; (void)strb; (void)d0; (void)d1; (void)d2; (void)d3;
+    (void)d4; (void)d5; (void)d6; (void)d7;
+    if (rows < 1 || rows > 4 || cols < 1 || cols > 20) return -1;
+    for (int fd = 0; fd < SIM_MAX_LCDS; fd++) {
+        if (lcds[fd].used) continue;
+        lcds[fd].used = 1;
+        lcds[fd].rows = rows;
+        lcds[fd].cols = cols;
+        lcdClear(fd);
+        return fd;
+    }
+    return -1;
+}
+
+void lcdHome(const int fd) {
+    lcdPosition(fd, 0, 0);
+    lcdBusy(LCD_HOME_NS);
+}
+
+void lcdClear(const int fd) {
+    if (fd < 0 || fd >= SIM_MAX_LCDS) return;
+    stats.lcdCmds += 2;
+    lcdBusy(2 * LCD_CMD_NS + LCD_HOME_NS);
+    for (int r = 0; r < 4; r++) {
+        memset(lcds[fd].text[r], ' ', (size_t)lcds[fd].cols);
+        lcds[fd].text[r][lcds[fd].cols] = '\0';
+    }
+    lcds[fd].x = lcds[fd].y = 0;
+}
+
+void lcdPosition(const int fd, int x, int y) {
+    if (fd < 0 || fd >= SIM_MAX_LCDS) return;
+    stats.lcdCmds++;
+    lcdBusy(LCD_CMD_NS);
+    lcds[fd].x = x;
+    lcds[fd].y = y;
+}
+
+void lcdPutchar(const int fd, unsigned char data) {
+    if (fd < 0 || fd >= SIM_MAX_LCDS) return;
+    if (lcds[fd].y < lcds[fd].rows && lcds[fd].x < lcds[fd].cols) {
+        lcds[fd].text[lcds[fd].y][lcds[fd].x] = (char)data;
+    }
+    stats.lcdChars++;
+    lcdBusy(LCD_BYTE_NS);
+    if (++lcds[fd].x == lcds[fd].cols) {  // 줄 끝에서 다음 줄로 (위치 명령)
+        lcds[fd].x = 0;
+        if (++lcds[fd].y == lcds[fd].rows) lcds[fd].y = 0;
+        stats.lcdCmds++;
+        lcdBusy(LCD_CMD_NS);
+    }
+}
+
+void lcdPuts(const int fd, const char* string) {
+    while (*string) lcdPutchar(fd, (unsigned char)*string++);
+}
+
+void lcdPrintf(const int fd, const char* message, ...) {
+    char buffer[1024];
+    va_list args;
+    va_start(args, message);
+    vsnprintf(buffer, sizeof(buffer), message, args);
+    va_end(args);
+    lcdPuts(fd, buffer);
+}
+
+// wiringPi lcdCharDef: CGRAM 주소 명령 + 8바이트
+void lcdCharDef(const int fd, int index, unsigned char data[8]) {
+    if (fd < 0 || fd >= SIM_MAX_LCDS) return;
+    memcpy(&lcds[fd].cg[(index & 7) * 8], data, 8);
+    stats.lcdCmds++;
+    stats.lcdChars += 8;
+    lcdBusy(LCD_CMD_NS + 8 * LCD_BYTE_NS);
+}
+
+// HD44780 핀 수준 모델 (Lab/hd44780.h 처럼 GPIO 로 직접 구동하는 드라이버용)
+// E 가 HIGH -> LOW 로 내려갈 때 RS, RW, D4~D7 을 읽는다. 전원 직후는 8비트 모드이고
+// DL=0 인 기능 설정 명령을 받으면 4비트 모드 (니블 두 번에 한 바이트, 상위 니블 먼저) 로 바뀐다.
+// 명령을 처리하는 동안 (HD_EXEC_NS, 지우기/홈은 HD_CLEAR_NS) busy flag 가 1 이고, 그동안 받은 바이트는 무시한다.
+// RW 가 HIGH 이고 E 가 HIGH 인 동안 D7 에 busy flag, D4~D6 에 주소 카운터를 내보낸다.
+// 화면 내용은 lcdInit 과 같은 문자 버퍼(lcds)에 있으므로 simLcdText 로 확인한다.
+#define SIM_MAX_HDS 2
+#define HD_EXEC_NS  (37 * NS_PER_US)    // 데이터시트 fosc 270kHz 기준
+#define HD_CLEAR_NS (1520 * NS_PER_US)
+
+typedef struct {
+    int fd;                  // lcds[] 번호
+    int rs, rw, e, d[4];     // rw < 0: GND 에 고정
+    int fourBit, lowNext;    // 4비트 모드, 다음 니블이 하위 니블
+    int high;                // 먼저 받은 상위 니블
+    int eHigh;
+    int addr, cgram;         // 주소 카운터, CGRAM 을 가리키는지
+    uint64_t busyUntil;
+} SimHd;
+
+static SimHd hds[SIM_MAX_HDS];
+static int hdsUsed = 0;
+
+static int hdReading(const SimHd* h) {
+    return h->rw >= 0 && pins[h->rw].level == HIGH;
+}
+
+// DDRAM 주소를 화면 칸으로 (줄 시작: 0x00, 0x40, 0x00 + cols, 0x40 + cols)
+static void hdPutData(SimHd* h, unsigned char data) {
+    int cols = lcds[h->fd].cols;
+    int base[4] = { 0x00, 0x40, cols, 0x40 + cols };
+    for (int r = 0; r < lcds[h->fd].rows; r++) {
+        if (h->addr >= base[r] && h->addr < base[r] + cols) lcds[h->fd].text[r][h->addr - base[r]] = (char)data;
+    }
+    if (++h->addr == 0x28) h->addr = 0x40;
+    else if (h->addr == 0x68) h->addr = 0x00;
+}
+
+static void hdByte(SimHd* h, int rs, unsigned char b, uint64_t now) {
+    if (now < h->busyUntil) {
+        stats.lcdLost++;  // 바쁠 때 받은 바이트는 무시된다
+        return;
+    }
+    uint64_t exec = HD_EXEC_NS;
+    if (rs) {
+        stats.lcdChars++;
+        if (h->cgram) {
+            lcds[h->fd].cg[h->addr] = b;
+            h->addr = (h->addr + 1) & 0x3F;
+        } else {
+            hdPutData(h, b);
+        }
+    } else {
+        stats.lcdCmds++;
+        if (b & 0x80) {                 // DDRAM 주소
+            h->cgram = 0;
+            h->addr = b & 0x7F;
+        } else if (b & 0x40) {          // CGRAM 주소
+            h->cgram = 1;
+            h->addr = b & 0x3F;
+        } else if (b & 0x20) {          // 기능 설정: DL 비트로 버스 폭이 바뀐다
+            h->fourBit = !(b & 0x10);
+            h->lowNext = 0;
+        } else if (b == 0x01) {         // 지우기
+            for (int r = 0; r < 4; r++) memset(lcds[h->fd].text[r], ' ', (size_t)lcds[h->fd].cols);
+            h->addr = h->cgram = 0;
+            exec = HD_CLEAR_NS;
+        } else if ((b & 0xFE) == 0x02) {  // 홈
+            h->addr = h->cgram = 0;
+            exec = HD_CLEAR_NS;
+        }
+        // 표시 켜기, 입력 모드, 시프트는 화면 버퍼에 영향 없음 (입력 모드는 증가로 본다)
+    }
+    h->busyUntil = now + exec;
+}
+
+static void hdEWrite(void* ctx, int pin, int value, uint64_t now) {
+    SimHd* h = ctx;
+    (void)pin;
+    if (value == HIGH) {
+        h->eHigh = 1;
+        return;
+    }
+    if (!h->eHigh) return;
+    h->eHigh = 0;
+    if (hdReading(h)) {                     // 읽기도 4비트 모드에서는 두 번에 한 바이트
+        if (h->fourBit) h->lowNext = !h->lowNext;
+        return;
+    }
+    int nibble = 0;
+    for (int i = 0; i < 4; i++) {
+        if (pins[h->d[i]].mode == OUTPUT && pins[h->d[i]].level == HIGH) nibble |= 1 << i;
+    }
+    int rs = pins[h->rs].level == HIGH;
+    if (!h->fourBit) {
+        hdByte(h, rs, (unsigned char)(nibble << 4), now);
+    } else if (!h->lowNext) {
+        h->high = nibble;
+        h->lowNext = 1;
+    } else {
+        h->lowNext = 0;
+        hdByte(h, rs, (unsigned char)(h->high << 4 | nibble), now);
+    }
+}
+
+static int hdDataRead(void* ctx, int pin, uint64_t now) {
+    SimHd* h = ctx;
+    if (!hdReading(h) || !h->eHigh) return LOW;  // LCD 가 버스를 구동하지 않음
+    int value = (now < h->busyUntil ? 0x80 : 0) | (h->addr & 0x7F);
+    int nibble = (h->fourBit && h->lowNext) ? value & 0x0F : value >> 4;
+    for (int i = 0; i < 4; i++) {
+        if (h->d[i] == pin) return (nibble >> i) & 1;
+    }
+    return LOW;
+}
+
+static const SimPinOps hdEOps = { NULL, hdEWrite, NULL, NULL };
+static const SimPinOps hdDataOps = { hdDataRead, NULL, NULL, NULL };
+
+int simHd44780Attach(int rows, int cols, int rs, int rw, int e, int d4, int d5, int d6, int d7) {
+    if (rows < 1 || rows > 4 || cols < 1 || cols > 20) return -1;
+    SimHd* h = NULL;
+    for (int i = 0; i < hdsUsed; i++) {
+        if (hds[i].e == e) h = &hds[i];  // 같은 LCD 를 다시 초기화
+    }
+    if (h == NULL) {
+        if (hdsUsed == SIM_MAX_HDS) return -1;
+        int fd = 0;
+        while (fd < SIM_MAX_LCDS && lcds[fd].used) fd++;
+        if (fd == SIM_MAX_LCDS) return -1;
+        lcds[fd].used = 1;
+        h = &hds[hdsUsed++];
+        memset(h, 0, sizeof(*h));
+        h->fd = fd;
+        for (int r = 0; r < 4; r++) {
+            memset(lcds[fd].text[r], ' ', (size_t)cols);
+            lcds[fd].text[r][cols] = '\0';
+        }
+    }
+    lcds[h->fd].rows = rows;
+    lcds[h->fd].cols = cols;
+    h->rs = rs;
+    h->rw = rw;
+    h->e = e;
+    h->d[0] = d4;
+    h->d[1] = d5;
+    h->d[2] = d6;
+    h->d[3] = d7;
+    simAttach(e, &hdEOps, h);
+    for (int i = 0; i < 4; i++) simAttach(h->d[i], &hdDataOps, h);
+    return h->fd;
+}
+
+const char* simLcdText(int fd, int row) {
+    if (fd < 0 || fd >= SIM_MAX_LCDS || row < 0 || row >= 4) return "";
+    return lcds[fd].text[row];
+}
+
+const unsigned char* simLcdGlyph(int fd, int index) {
+    if (fd < 0 || fd >= SIM_MAX_LCDS) return NULL;
+    return &lcds[fd].cg[(index & 7) * 8];
+}
+
+
+//5. GPIO 및 시간 함수
+static void simFinish(void) {
+    simReport();
+    exit(0);
+}
+
+// 장치가 응답하지 않아 대기 루프가 끝나지 않는 경우 (가상 시계)
+static void pinStalled(int pin) {
+    stats.stalls++;
+    sameReads = 0;
+    if (stallHandler) {
+        stallHandler(pin);  // longjmp 로 빠져나갈 수 있다
+        return;
+    }
+    fprintf(stderr, "\nsim: GPIO %d 대기 루프가 %ums 동안 끝나지 않습니다 (장치 응답 없음), 종료합니다.\n",
+            pin, stallLimitMs);
+    simFinish();
+}
+
+// 인터럽트 (wiringPiISR): 보드에 접근할 때마다 등록된 핀의 레벨 변화를 확인해서 호출한다.
+// 가상 시계의 delay 는 등록된 핀의 다음 변화 시각마다 멈추므로 변화를 놓치지 않는다.
+#define SIM_MAX_ISRS 16
+
+static struct {
+    int pin;
+    int edge;
+    void (*fn)(void);
+    int last;
+} isrs[SIM_MAX_ISRS];
+static int isrCount = 0;
+static int inIsr = 0;
+
+static int pinInput(SimPin* p, int pin, uint64_t now);
+
+static void isrCheck(uint64_t now) {
+    if (inIsr) return;
+    inIsr = 1;
+    for (int i = 0; i < isrCount; i++) {
+        int level = pinInput(&pins[isrs[i].pin], isrs[i].pin, now);
+        if (level == isrs[i].last) continue;
+        isrs[i].last = level;
+        if (isrs[i].edge == INT_EDGE_BOTH ||
+            (isrs[i].edge == INT_EDGE_RISING && level == HIGH) ||
+            (isrs[i].edge == INT_EDGE_FALLING && level == LOW)) {
+            stats.interrupts++;
+            isrs[i].fn();
+        }
+    }
+    inIsr = 0;
+}
+
+// 인터럽트 핀 중 가장 먼저 레벨이 바뀔 수 있는 시각
+static uint64_t isrNextChange(uint64_t now) {
+    uint64_t next = UINT64_MAX;
+    for (int i = 0; i < isrCount; i++) {
+        SimPin* p = &pins[isrs[i].pin];
+        if (p->ops == NULL || p->ops->next == NULL) continue;
+        uint64_t t = p->ops->next(p->ctx, isrs[i].pin, now);
+        if (t > now && t < next) next = t;
+    }
+    return next;
+}
+
+int wiringPiISR(int pin, int edgeType, void (*function)(void)) {
+    SimPin* p = pinAt(pin);
+    if (p == NULL || function == NULL || isrCount == SIM_MAX_ISRS) return -1;
+    for (int i = 0; i < isrCount; i++) {
+        if (isrs[i].pin == pin) {  // 다시 등록하면 교체
+            isrs[i].edge = edgeType;
+            isrs[i].fn = function;
+            return 0;
+        }
+    }
+    isrs[isrCount].pin = pin;
+    isrs[isrCount].edge = edgeType;
+    isrs[isrCount].fn = function;
+    isrs[isrCount].last = pinInput(p, pin, simNowNs());
+    isrCount++;
+    return 0;
+}
+
+// 보드 접근마다 호출: 장치 상태 갱신, 인터럽트, 자동 종료 확인
+static void simTick(uint64_t now) {
+    keypadUpdate(now);
+    isrCheck(now);
+    // 마지막 항목이 대기 구간(~)이면 그 구간이 끝난 뒤부터 잰다
+    if (idleExitMs > 0 && kp.scripted && kp.head == kp.count && !kp.active && !kp.inIdle &&
+        now - kp.lastEventNs >= (uint64_t)idleExitMs * NS_PER_MS) {
+        fprintf(stderr, "\nsim: 키 스크립트 종료 후 %dms 동안 입력 없음, 종료합니다.\n", idleExitMs);
+        simFinish();
+    }
+}
+
+void simAttach(int pin, const SimPinOps* ops, void* ctx) {
+    SimPin* p = pinAt(pin);
+    if (p == NULL) return;
+    p->ops = ops;
+    p->ctx = ctx;
+}
+
+void simPinSetInput(int pin, int level) {
+    SimPin* p = pinAt(pin);
+    if (p != NULL) p->inputLevel = level;
+}
+
+int simPinLevel(int pin) {
+    SimPin* p = pinAt(pin);
+    return p ? p->level : LOW;
+}
+
+int simPinPwm(int pin) {
+    SimPin* p = pinAt(pin);
+    return p ? p->pwm : 0;
+}
+
+int simPinTone(int pin) {
+    SimPin* p = pinAt(pin);
+    return p ? p->tone : 0;
+}
+
+double simPinToneHz(int pin) {
+    SimPin* p = pinAt(pin);
+    if (p == NULL) return 0;
+    if (p->tone > 0) return p->tone;
+    if (p->mode != PWM_OUTPUT || (pin != 12 && pin != 13 && pin != 18 && pin != 19)) return 0;
+    if (pwmHwClock <= 0 || pwmHwRange == 0 || p->pwm <= 0 || (unsigned int)p->pwm >= pwmHwRange) return 0;
+    double clockHz = (double)SIM_PWM_OSC_HZ / pwmHwClock;
+    if (pwmHwMode == PWM_MODE_MS) return clockHz / pwmHwRange;
+    // balanced 모드는 HIGH 구간을 주기 안에 고르게 흩어 놓으므로 펄스 수가 주파수가 된다
+    unsigned int high = (unsigned int)p->pwm, low = pwmHwRange - high;
+    return clockHz * (high < low ? high : low) / pwmHwRange;
+}
+
+void simSetIdleExit(int ms) {
+    idleExitMs = ms;
+}
+
+static int envInt(const char* name, int fallback) {
+    const char* v = getenv(name);
+    return (v && *v) ? atoi(v) : fallback;
+}
+
+// 자판기(Final.c) 키패드 배선
+static const int defaultRows[4] = { 5, 6, 4, 17 };
+static const int defaultCols[4] = { 27, 22, 16, 20 };
+static const char defaultKeys[4][4] = {
+    {'1', '2', '3', 'A'},
+    {'4', '5', '6', 'B'},
+    {'7', '8', '9', 'C'},
+    {'H', '0', 'E', 'D'}
+};
+
+int wiringPiSetupGpio(void) {
+    boardInit();
+    if (dht.pin < 0) simDht11Attach(26);
+
+    const char* clock = getenv("SIM_CLOCK");
+    if (clock && strcmp(clock, "virtual") == 0) simClockMode(SIM_CLOCK_VIRTUAL);
+    opCostNs = (unsigned int)envInt("SIM_OP_COST_NS", (int)opCostNs);
+    if (getenv("SIM_IDLE_SKIP")) idleSkip = envInt("SIM_IDLE_SKIP", 0);
+    if (getenv("SIM_SEED")) simSeed((uint64_t)strtoull(getenv("SIM_SEED"), NULL, 10));
+    if (getenv("SIM_KEY_BOUNCE_US")) kp.bounceUs = envInt("SIM_KEY_BOUNCE_US", 0);
+
+    const char* keys = getenv("SIM_KEYS");
+    if (keys && *keys) {
+        if (!kp.attached) simKeypadAttach(defaultRows, defaultCols, defaultKeys);
+        if (simKeypadScript(keys) != 0) return -1;
+        if (idleExitMs == 0) idleExitMs = envInt("SIM_IDLE_EXIT_MS", 5000);
+    }
+    if (getenv("SIM_TEMP") || getenv("SIM_HUMI")) {
+        simDht11Set(envInt("SIM_HUMI", 40), 0, envInt("SIM_TEMP", 25), 0);
+    }
+    if (getenv("SIM_CDS")) simPcf8591Set(0, envInt("SIM_CDS", 50));
+    if (getenv("SIM_CARD")) simCardScript(getenv("SIM_CARD"));
+    const char* wavEnv = getenv("SIM_WAV");  // "18:voice.wav"
+    if (wavEnv && strchr(wavEnv, ':') && simPwmWavOpen(atoi(wavEnv), strchr(wavEnv, ':') + 1, 8000) != 0) {
+        fprintf(stderr, "sim: SIM_WAV=%s 녹음 파일을 열 수 없음\n", wavEnv);
+    }
+    return 0;
+}
+
+int wiringPiSetup(void) {
+    return wiringPiSetupGpio();
+}
+
+void pinMode(int pin, int mode) {
+    SimPin* p = pinAt(pin);
+    if (p == NULL) return;
+    uint64_t now = boardOp();
+    stats.modes++;
+    p->mode = mode;
+    if (mode == PWM_OUTPUT) {
+        // wiringPi 와 같이 PWM 출력으로 바꿀 때 기본값 (balanced, 범위 1024, 분주 32)
+        pwmHwMode = PWM_MODE_BAL;
+        pwmHwRange = 1024;
+        pwmHwClock = 32;
+    }
+    if (p->ops && p->ops->mode) p->ops->mode(p->ctx, pin, mode, now);
+    simTick(now);
+}
+
+void pullUpDnControl(int pin, int pud) {
+    SimPin* p = pinAt(pin);
+    if (p != NULL) p->pud = pud;
+}
+
+static int pinInput(SimPin* p, int pin, uint64_t now) {
+    if (p->mode == OUTPUT) return p->level;
+    if (p->ops && p->ops->read) return p->ops->read(p->ctx, pin, now);
+    if (p->inputLevel >= 0) return p->inputLevel;
+    return p->pud == PUD_UP ? HIGH : LOW;
+}
+
+int digitalRead(int pin) {
+    SimPin* p = pinAt(pin);
+    if (p == NULL) return LOW;
+    int prevPin = lastReadPin;
+    uint64_t now = boardOp();
+    stats.reads++;
+
+    // while (digitalRead(pin) == X); 형태의 대기 루프: 값이 바뀔 시각으로 건너뜀
+    int spinning = (prevPin == pin && sameReads >= SPIN_READS);
+    if (spinning && clockMode == SIM_CLOCK_VIRTUAL && p->mode != OUTPUT && p->ops && p->ops->next) {
+        uint64_t next = p->ops->next(p->ctx, pin, now);
+        uint64_t limit = spinStartNs + (uint64_t)stallLimitMs * NS_PER_MS;
+        if (pinInput(p, pin, now) == lastReadValue) {
+            if (stallLimitMs > 0 && (next == UINT64_MAX || next > limit)) {
+                // 레벨이 다시 바뀌지 않는다: 한도까지 시간을 보내고 멈춤 처리
+                if (limit > now) virtNs = now = limit;
+                simTick(now);
+                pinStalled(pin);
+                now = simNowNs();
+            } else if (next != UINT64_MAX && next > now) {
+                stats.skips++;
+                virtNs = next;
+                now = next;
+            }
+        }
+    }
+    simTick(now);
+    int value = pinInput(p, pin, now);
+    sameReads = (prevPin == pin && value == lastReadValue) ? sameReads + 1 : 1;
+    if (sameReads == 1) spinStartNs = now;
+    lastReadPin = pin;
+    lastReadValue = value;
+    return value;
+}
+
+// GPIO 레벨 레지스터(GPLEV0)를 한 번 읽은 것과 같다: mask 의 핀들을 같은 시각에 읽는다.
+// 같은 값을 연속으로 읽는 대기 루프는 mask 중 가장 먼저 바뀌는 핀의 시각으로 건너뛴다.
+uint32_t simGpioLevels(uint32_t mask) {
+    static uint32_t lastMask, lastLevels;
+    boardInit();
+    int prevPin = lastReadPin;
+    uint64_t now = boardOp();
+    stats.reads++;
+    stats.bulkReads++;
+
+    int spinning = (prevPin == SIM_MAX_PINS && lastMask == mask && sameReads >= SPIN_READS);
+    if (spinning && clockMode == SIM_CLOCK_VIRTUAL) {
+        uint64_t next = UINT64_MAX;
+        int firstPin = -1;
+        for (int pin = 0; pin < 32; pin++) {
+            if (!(mask & (1u << pin))) continue;
+            SimPin* p = &pins[pin];
+            if (firstPin < 0) firstPin = pin;
+            if (p->mode == OUTPUT) continue;
+            if (p->ops && p->ops->next) {
+                uint64_t t = p->ops->next(p->ctx, pin, now);
+                if (t < next) next = t;
+            }
+        }
+        uint64_t limit = spinStartNs + (uint64_t)stallLimitMs * NS_PER_MS;
+        if (stallLimitMs > 0 && (next == UINT64_MAX || next > limit)) {
+            if (limit > now) virtNs = now = limit;
+            simTick(now);
+            pinStalled(firstPin);
+            now = simNowNs();
+        } else if (next != UINT64_MAX && next > now) {
+            stats.skips++;
+            virtNs = next;
+            now = next;
+        }
+    }
+    simTick(now);
+    uint32_t levels = 0;
+    for (int pin = 0; pin < 32; pin++) {
+        if ((mask & (1u << pin)) && pinInput(&pins[pin], pin, now)) levels |= 1u << pin;
+    }
+    sameReads = (prevPin == SIM_MAX_PINS && lastMask == mask && levels == lastLevels) ? sameReads + 1 : 1;
+    if (sameReads == 1) spinStartNs = now;
+    lastReadPin = SIM_MAX_PINS;  // 한꺼번에 읽기
+    lastMask = mask;
+    lastLevels = levels;
+    return levels;
+}
+
+void digitalWrite(int pin, int value) {
+    SimPin* p = pinAt(pin);
+    if (p == NULL) return;
+    uint64_t now = boardOp();
+    stats.writes++;
+    p->level = value ? HIGH : LOW;
+    if (p->ops && p->ops->write) p->ops->write(p->ctx, pin, p->level, now);
+    simTick(now);
+}
+
+// GPSET0/GPCLR0 에 한 번 쓴 것과 같다: mask 의 출력 핀이 같은 시각에 바뀐다.
+// 장치에는 모든 핀의 레벨을 바꾼 뒤 바뀐 핀마다 알린다 (중간 상태가 보이지 않는다).
+void simGpioWrite(uint32_t mask, int level) {
+    boardInit();
+    uint64_t now = boardOp();
+    stats.writes++;
+    stats.bulkWrites++;
+    level = level ? HIGH : LOW;
+    uint32_t changed = 0;
+    for (int pin = 0; pin < 32; pin++) {
+        if (!(mask & (1u << pin)) || pins[pin].level == level) continue;
+        pins[pin].level = level;
+        changed |= 1u << pin;
+    }
+    for (int pin = 0; pin < 32; pin++) {
+        SimPin* p = &pins[pin];
+        if ((changed & (1u << pin)) && p->ops && p->ops->write) p->ops->write(p->ctx, pin, level, now);
+    }
+    simTick(now);
+}
+
+// PWM 녹음 (simPwmWavOpen): 핀의 듀티(0~1)를 16비트 모노 WAV 로 쓴다.
+// 녹음을 연 뒤 핀에 처음 쓴 시각부터 1/rate 마다, 각 샘플 구간의 가운데에서 듀티를 읽는다
+// (스피커가 반송파를 걸러 낸 뒤의 소리). 샘플을 제시간에 쓰지 못하면 앞 샘플이 길어진 채로 녹음된다.
+static struct {
+    FILE* f;
+    int pin;
+    unsigned int rate;
+    int running;             // 핀에 처음 쓴 뒤
+    uint64_t startNs, next;  // 녹음 시작 시각, 다음 샘플 번호
+    double duty;
+    char path[256];
+} wav = { .pin = -1 };
+
+static double pinDuty(int pin) {
+    SimPin* p = &pins[pin];
+    double duty;
+    if (p->mode == PWM_OUTPUT) duty = pwmHwRange ? (double)p->pwm / pwmHwRange : 0;
+    else if (p->pwmRange > 0) duty = (double)p->pwm / p->pwmRange;
+    else duty = p->level;
+    return duty < 0 ? 0 : duty > 1 ? 1 : duty;
+}
+
+static void wavPut(uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) fputc((int)((value >> (8 * i)) & 0xFF), wav.f);
+}
+
+static void wavHeader(uint32_t samples) {
+    fseek(wav.f, 0, SEEK_SET);
+    fwrite("RIFF", 1, 4, wav.f);
+    wavPut(36 + samples * 2, 4);
+    fwrite("WAVEfmt ", 1, 8, wav.f);
+    wavPut(16, 4);
+    wavPut(1, 2);              // PCM
+    wavPut(1, 2);              // 모노
+    wavPut(wav.rate, 4);
+    wavPut(wav.rate * 2, 4);
+    wavPut(2, 2);
+    wavPut(16, 2);
+    fwrite("data", 1, 4, wav.f);
+    wavPut(samples * 2, 4);
+}
+
+// now 까지의 샘플을 쓴다
+static void wavAdvance(uint64_t now) {
+    if (!wav.running) return;
+    int16_t value = (int16_t)(lround(wav.duty * 65535.0) - 32768);
+    while (wav.startNs + (wav.next * 2 + 1) * NS_PER_S / (2 * wav.rate) <= now) {
+        wavPut((uint16_t)value, 2);
+        wav.next++;
+    }
+}
+
+// 핀 출력이 바뀌기 전(before)과 뒤에 부른다
+static void wavPinChange(int pin, int before) {
+    if (wav.f == NULL || (pin != wav.pin && pin >= 0)) return;
+    uint64_t now = simNowNs();
+    if (before) {
+        wavAdvance(now);
+        return;
+    }
+    if (pin == wav.pin && !wav.running) {
+        wav.running = 1;
+        wav.startNs = now;
+    }
+    wav.duty = pinDuty(wav.pin);
+}
+
+int simPwmWavClose(void) {
+    if (wav.f == NULL) return -1;
+    wavAdvance(simNowNs());
+    wavHeader((uint32_t)wav.next);
+    int samples = (int)wav.next;
+    fclose(wav.f);
+    wav.f = NULL;
+    wav.pin = -1;
+    return samples;
+}
+
+static void wavAtExit(void) {
+    simPwmWavClose();
+}
+
+int simPwmWavOpen(int pin, const char* path, unsigned int rate) {
+    if (pinAt(pin) == NULL || rate == 0) return -1;
+    simPwmWavClose();
+    wav.f = fopen(path, "wb");
+    if (wav.f == NULL) return -1;
+    static int registered = 0;
+    if (!registered) atexit(wavAtExit);
+    registered = 1;
+    snprintf(wav.path, sizeof(wav.path), "%s", path);
+    wav.pin = pin;
+    wav.rate = rate;
+    wav.running = 0;
+    wav.next = 0;
+    wavHeader(0);
+    return 0;
+}
+
+void pwmWrite(int pin, int value) {
+    SimPin* p = pinAt(pin);
+    if (p == NULL) return;
+    boardOp();
+    wavPinChange(pin, 1);
+    p->pwm = value;
+    wavPinChange(pin, 0);
+}
+
+void pwmSetMode(int mode) { pwmHwMode = mode; }
+
+void pwmSetRange(unsigned int range) {
+    wavPinChange(-1, 1);
+    pwmHwRange = range;
+    wavPinChange(-1, 0);
+}
+void pwmSetClock(int divisor) { pwmHwClock = divisor & 4095; }
+
+int softPwmCreate(int pin, int initialValue, int pwmRange) {
+    SimPin* p = pinAt(pin);
+    if (p == NULL) return -1;
+    p->pwm = initialValue;
+    p->pwmRange = pwmRange;
+    return 0;
+}
+
+void softPwmWrite(int pin, int value) {
+    SimPin* p = pinAt(pin);
+    if (p == NULL) return;
+    wavPinChange(pin, 1);
+    p->pwm = value;
+    wavPinChange(pin, 0);
+}
+
+void softPwmStop(int pin) {
+    SimPin* p = pinAt(pin);
+    if (p != NULL) p->pwm = 0;
+}
+
+int softToneCreate(int pin) {
+    SimPin* p = pinAt(pin);
+    if (p == NULL) return -1;
+    p->tone = 0;
+    return 0;
+}
+
+void softToneWrite(int pin, int freq) {
+    SimPin* p = pinAt(pin);
+    if (p != NULL) p->tone = freq;
+}
+
+void softToneStop(int pin) {
+    softToneWrite(pin, 0);
+}
+
+// 가상 시계에서 시간을 앞으로 보낸다.
+// 대기 구간 건너뛰기가 켜져 있으면 키패드를 읽는 중인 대기는 구간 끝까지 한 번에 보낸다.
+static void virtualSleep(uint64_t ns) {
+    uint64_t until = virtNs + ns;
+    while (isrCount > 0) {
+        uint64_t next = isrNextChange(virtNs);
+        if (next > until) break;
+        virtNs = next;
+        simTick(virtNs);  // 인터럽트 핸들러 안의 delay 로 시각이 더 갈 수 있다
+    }
+    if (virtNs < until) virtNs = until;
+    if (idleSkip && kp.inIdle && !kp.active && kp.nextAtNs > virtNs && keypadListening()) {
+        virtNs = kp.nextAtNs;
+    }
+    simTick(virtNs);
+}
+
+// 스레드 (piThreadCreate): 협력형으로 실행한다.
+// 한 번에 한 스레드만 돌고 delay/delayMicroseconds 에서만 다른 스레드로 넘어가므로
+// 시뮬레이션 보드 상태에는 잠금이 필요 없고, 가상 시계에서도 결과가 결정적이다.
+// 자는 스레드 중 가장 먼저 깨어날 스레드까지 시각을 보내고 그 스레드를 실행한다.
+#define SIM_MAX_THREADS  8
+#define SIM_THREAD_STACK (256 * 1024)
+
+static struct {
+    ucontext_t ctx;
+    uint64_t wakeNs;
+    int running;               // 0: 빈 칸 또는 끝난 스레드
+    void* (*fn)(void*);
+    void* stack;
+} threads[SIM_MAX_THREADS] = { [0] = { .running = 1 } };  // 0번은 main
+static int threadCount = 1;
+static int curThread = 0;
+
+// 현재 시각을 t 까지 보낸다
+static void advanceTo(uint64_t t) {
+    uint64_t now = simNowNs();
+    if (t <= now) return;
+    if (clockMode == SIM_CLOCK_VIRTUAL) {
+        virtualSleep(t - now);
+        return;
+    }
+    struct timespec ts = { (time_t)((t - now) / 1000000000ULL), (long)((t - now) % 1000000000ULL) };
+    nanosleep(&ts, NULL);
+    simTick(simNowNs());
+}
+
+// 가장 먼저 깨어날 스레드로 전환 (같은 시각이면 번호가 작은 스레드)
+static void threadSwitch(void) {
+    int next = -1;
+    for (int i = 0; i < threadCount; i++) {
+        if (!threads[i].running) continue;
+        if (next < 0 || threads[i].wakeNs < threads[next].wakeNs) next = i;
+    }
+    advanceTo(threads[next].wakeNs);
+    if (next == curThread) return;
+    int prev = curThread;
+    curThread = next;
+    swapcontext(&threads[prev].ctx, &threads[next].ctx);
+}
+
+static void threadEntry(void) {
+    threads[curThread].fn(NULL);
+    threads[curThread].running = 0;
+    threadSwitch();  // 돌아오지 않음
+}
+
+int piThreadCreate(void* (*fn)(void*)) {
+    boardInit();
+    if (threadCount == SIM_MAX_THREADS) return -1;
+    int id = threadCount;
+    threads[id].stack = malloc(SIM_THREAD_STACK);
+    if (threads[id].stack == NULL) return -1;
+    getcontext(&threads[id].ctx);
+    threads[id].ctx.uc_stack.ss_sp = threads[id].stack;
+    threads[id].ctx.uc_stack.ss_size = SIM_THREAD_STACK;
+    threads[id].ctx.uc_link = NULL;
+    makecontext(&threads[id].ctx, threadEntry, 0);
+    threads[id].fn = fn;
+    threads[id].wakeNs = simNowNs();  // 만든 스레드의 다음 delay 에서 시작
+    threads[id].running = 1;
+    threadCount++;
+    return 0;
+}
+
+void piLock(int key) {
+    (void)key;  // 협력형 스레드는 delay 에서만 바뀌므로 잠글 필요 없음
+}
+
+void piUnlock(int key) {
+    (void)key;
+}
+
+int piHiPri(int pri) {
+    (void)pri;
+    return 0;
+}
+
+// 스레드가 있으면 다른 스레드에 차례를 넘기면서 잔다
+static int threadSleep(uint64_t ns) {
+    if (threadCount == 1) return 0;
+    threads[curThread].wakeNs = simNowNs() + ns;
+    threadSwitch();
+    return 1;
+}
+
+void delay(unsigned int howLong) {
+    struct timespec ts = { howLong / 1000, (long)(howLong % 1000) * 1000000L };
+    boardOp();
+    stats.delays++;
+    stats.delayedNs += (uint64_t)howLong * NS_PER_MS;
+    if (threadSleep((uint64_t)howLong * NS_PER_MS)) return;
+    if (clockMode == SIM_CLOCK_VIRTUAL) {
+        virtualSleep((uint64_t)howLong * NS_PER_MS);
+        return;
+    }
+    nanosleep(&ts, NULL);
+    simTick(simNowNs());
+}
+
+// wiringPi 와 같이 100us 미만은 바쁜 대기로 처리
+void delayMicroseconds(unsigned int howLong) {
+    boardOp();
+    stats.delays++;
+    stats.delayedNs += (uint64_t)howLong * NS_PER_US;
+    if (threadSleep((uint64_t)howLong * NS_PER_US)) return;
+    if (clockMode == SIM_CLOCK_VIRTUAL) {
+        virtualSleep((uint64_t)howLong * NS_PER_US);
+        return;
+    }
+    if (howLong < 100) {
+        uint64_t until = simNowNs() + (uint64_t)howLong * NS_PER_US;
+        while (simNowNs() < until);
+    } else {
+        struct timespec ts = { howLong / 1000000, (long)(howLong % 1000000) * 1000L };
+        nanosleep(&ts, NULL);
+    }
+    simTick(simNowNs());
+}
+
+// LCD 가 명령을 처리하는 동안 기다린다 (delay 통계와 따로 센다)
+static void lcdBusy(uint64_t ns) {
+    boardOp();
+    stats.lcdNs += ns;
+    if (threadSleep(ns)) return;
+    if (clockMode == SIM_CLOCK_VIRTUAL) {
+        virtualSleep(ns);
+        return;
+    }
+    struct timespec ts = { (time_t)(ns / NS_PER_S), (long)(ns % NS_PER_S) };
+    nanosleep(&ts, NULL);
+    simTick(simNowNs());
+}
+
+unsigned int millis(void) {
+    return (unsigned int)(boardOp() / NS_PER_MS);
+}
+
+unsigned int micros(void) {
+    return (unsigned int)(boardOp() / NS_PER_US);
+}
+
+void simReport(void) {
+    double simMs = (double)simNowNs() / NS_PER_MS;
+    double wallMs = (double)simWallNs() / NS_PER_MS;
+    double cpuMs = (double)simCpuNs() / NS_PER_MS;
+    fprintf(stderr, "sim: %s 시계, 시뮬레이션 시간 %.1fms, 실제 경과 %.1fms, CPU 시간 %.1fms (x%.1f)\n",
+            clockMode == SIM_CLOCK_VIRTUAL ? "가상" : "실제",
+            simMs, wallMs, cpuMs, wallMs > 0 ? simMs / wallMs : 0.0);
+    fprintf(stderr, "sim: digitalRead %lu회 (대기 루프 건너뜀 %lu회), digitalWrite %lu회, pinMode %lu회, delay %lu회 (%.1fms)\n",
+            stats.reads, stats.skips, stats.writes, stats.modes, stats.delays,
+            (double)stats.delayedNs / NS_PER_MS);
+    if (stats.bulkReads) fprintf(stderr, "sim: 그중 레벨 레지스터 한꺼번에 읽기 %lu회\n", stats.bulkReads);
+    if (stats.bulkWrites) fprintf(stderr, "sim: 그중 출력 레지스터 한꺼번에 쓰기 %lu회\n", stats.bulkWrites);
+    if (stats.interrupts) fprintf(stderr, "sim: 인터럽트 %lu회\n", stats.interrupts);
+    if (stats.lcdChars || stats.lcdCmds) {
+        fprintf(stderr, "sim: LCD 글자 %lu개, 명령 %lu개 (%.1fms)\n",
+                stats.lcdChars, stats.lcdCmds, (double)stats.lcdNs / NS_PER_MS);
+    }
+    if (stats.lcdLost) fprintf(stderr, "sim: LCD 가 바쁠 때 보내서 무시된 바이트 %lu개\n", stats.lcdLost);
+    if (wav.f) wavAdvance(simNowNs());
+    if (wav.f) fprintf(stderr, "sim: GPIO %d PWM 녹음 %s (%.1f초)\n", wav.pin, wav.path, (double)wav.next / wav.rate);
+    if (stats.preempts || stats.stalls) {
+        fprintf(stderr, "sim: 선점 %lu회, 끝나지 않은 대기 루프 %lu회\n", stats.preempts, stats.stalls);
+    }
+}
@@ -0,0 +1,213 @@
+// 시뮬레이션 보드: 라즈베리파이 없이 wiringPi 프로그램을 실행하기 위한 가상 하드웨어
+//
+// 하드웨어 추상화 계층은 두 가지 백엔드로 구성된다.
+//   1. 실제 보드: 기존처럼 <wiringPi.h> 등을 그대로 사용 (libwiringPi 링크)
+//   2. 시뮬레이션 보드: sim/include 의 대체 헤더가 이 파일을 포함하고
+//      sim_board.c 가 같은 이름의 함수를 구현한다.
+//
+// 소스 수정 없이 -I 경로만 바꿔서 백엔드를 선택한다.
+//   실제 보드:  gcc Final.c -lwiringPi -lwiringPiDev -o vending
+//   시뮬레이션: gcc -Isim/include "recommendation vending machine/Final.c" sim/sim_board.c -lm -o vending_sim
+//
+// 시뮬레이션 보드가 제공하는 장치
+//   - 스크립트로 제어하는 입력 핀 (simPinSetInput, simAttach)
+//   - 4x4 매트릭스 키패드 (기본 배선: 자판기 Final.c)
+//   - DHT11 온습도 센서 (기본 GPIO 26)
+//   - PCF8591 I2C ADC (주소 0x48), MCP3208 SPI ADC
+//   - RFID 카드 리더 결과 스크립트
+//   - 떨림 버튼, HC-SR04 초음파 센서 (sim_signal.h)
+//   - 핀 변화 인터럽트 (wiringPiISR, 보드 함수/delay 도중에 같은 스레드에서 호출)
+//   - 스레드 (piThreadCreate, delay 에서만 전환하는 협력형)
+//   - PWM 출력 녹음 (WAV 파일)
+//
+// 환경 변수로도 설정할 수 있다 (wiringPiSetupGpio 호출 시 적용).
+//   SIM_KEYS="1D7E12000E"   키 입력 스크립트 (문법은 simKeypadScript 참고)
+//   SIM_TEMP=27 SIM_HUMI=40 DHT11 온도/습도
+//   SIM_CDS=150              PCF8591 AIN0 값
+//   SIM_CARD="10"            카드 읽기 결과 순서 (1: 성공, 0: 실패)
+//   SIM_IDLE_EXIT_MS=5000    스크립트 종료 후 이 시간 동안 입력이 없으면 종료
+//   SIM_CLOCK=virtual        가상 시계 사용 (simClockMode 참고)
+//   SIM_OP_COST_NS=100       가상 시계에서 보드 함수 호출 한 번에 흐르는 시간
+//   SIM_IDLE_SKIP=0          가상 시계에서 스크립트 대기 구간(~)의 폴링을 그대로 실행 (기본: 건너뜀)
+//   SIM_SEED=1               잡음/떨림 난수 시드
+//   SIM_KEY_BOUNCE_US=5000   키패드 접점 떨림 시간
+//   SIM_WAV="18:voice.wav"   GPIO 18 의 PWM 출력을 8kHz WAV 로 녹음 (simPwmWavOpen)
+//
+// 시뮬레이션 보드는 단일 스레드에서 호출된다고 가정한다.
+// piThreadCreate 로 만든 스레드는 협력형으로 번갈아 실행되므로 이 가정을 지킨다 (pthread 직접 사용은 불가).
+
+#ifndef SIM_BOARD_H
+#define SIM_BOARD_H
+
+#include <stdint.h>
+
+#define SIM_BOARD 1
+
+// wiringPi 상수
+#define LOW  0
+#define HIGH 1
+
+#define INPUT      0
+#define OUTPUT     1
+#define PWM_OUTPUT 2
+#define GPIO_CLOCK 3
+
+#define PUD_OFF  0
+#define PUD_DOWN 1
+#define PUD_UP   2
+
+#define PWM_MODE_MS  0
+#define PWM_MODE_BAL 1
+
+#define INT_EDGE_SETUP   0
+#define INT_EDGE_FALLING 1
+#define INT_EDGE_RISING  2
+#define INT_EDGE_BOTH    3
+
+#define SIM_MAX_PINS 64
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// wiringPi 호환 함수
+int wiringPiSetup(void);
+int wiringPiSetupGpio(void);
+void pinMode(int pin, int mode);
+void pullUpDnControl(int pin, int pud);
+int digitalRead(int pin);
+void digitalWrite(int pin, int value);
+void pwmWrite(int pin, int value);
+void pwmSetMode(int mode);
+void pwmSetRange(unsigned int range);
+void pwmSetClock(int divisor);
+void delay(unsigned int howLong);
+void delayMicroseconds(unsigned int howLong);
+unsigned int millis(void);
+unsigned int micros(void);
+int wiringPiISR(int pin, int edgeType, void (*function)(void));  // 보드 접근/delay 중에 같은 스레드에서 호출
+
+// 스레드: delay/delayMicroseconds 에서만 다른 스레드로 넘어간다
+#define PI_THREAD(X) void* X(void* dummy __attribute__((unused)))
+int piThreadCreate(void* (*fn)(void*));
+void piLock(int key);
+void piUnlock(int key);
+int piHiPri(int pri);
+
+// softPwm.h
+int softPwmCreate(int pin, int initialValue, int pwmRange);
+void softPwmWrite(int pin, int value);
+void softPwmStop(int pin);
+
+// softTone.h
+int softToneCreate(int pin);
+void softToneWrite(int pin, int freq);
+void softToneStop(int pin);
+
+// wiringPiI2C.h
+int wiringPiI2CSetup(const int devId);
+int wiringPiI2CRead(int fd);
+int wiringPiI2CWrite(int fd, int data);
+
+// wiringPiSPI.h
+int wiringPiSPISetup(int channel, int speed);
+int wiringPiSPIDataRW(int channel, unsigned char* data, int len);
+
+// lcd.h (문자 버퍼 + HD44780 대기 시간)
+int lcdInit(const int rows, const int cols, const int bits,
+            const int rs, const int strb,
+            const int d0, const int d1, const int d2, const int d3,
+            const int d4, const int d5, const int d6, const int d7);
+void lcdHome(const int fd);
+void lcdClear(const int fd);
+void lcdPosition(const int fd, int x, int y);
+void lcdPutchar(const int fd, unsigned char data);
+void lcdPuts(const int fd, const char* string);
+void lcdPrintf(const int fd, const char* message, ...);
+void lcdCharDef(const int fd, int index, unsigned char data[8]);
+
+// ---- 시뮬레이션 제어 API ----
+
+// 핀에 연결되는 가상 장치. 필요한 콜백만 채운다.
+typedef struct {
+    int (*read)(void* ctx, int pin, uint64_t nowNs);               // 입력 레벨 반환
+    void (*write)(void* ctx, int pin, int value, uint64_t nowNs);   // 출력 변화 통지
+    void (*mode)(void* ctx, int pin, int mode, uint64_t nowNs);     // 핀 모드 변경 통지
+    uint64_t (*next)(void* ctx, int pin, uint64_t nowNs);          // 다음 레벨 변화 시각 (모르면 UINT64_MAX)
+} SimPinOps;
+
+void simAttach(int pin, const SimPinOps* ops, void* ctx);  // 핀에 장치 연결
+void simPinSetInput(int pin, int level);                   // 입력 핀 레벨 고정
+int simPinLevel(int pin);                                  // 핀의 현재 출력 레벨
+int simPinPwm(int pin);                                    // softPwm/pwmWrite 값
+int simPinTone(int pin);                                   // softTone 주파수
+double simPinToneHz(int pin);                              // 핀에서 나는 소리 주파수 (softTone, 또는 하드웨어 PWM 의 분주/범위)
+// 핀의 PWM 듀티를 rate 로 샘플링해서 16비트 모노 WAV 로 녹음 (핀 하나, 핀에 처음 쓴 시각부터). 닫으면 샘플 수
+int simPwmWavOpen(int pin, const char* path, unsigned int rate);
+int simPwmWavClose(void);
+uint64_t simNowNs(void);                                   // 시뮬레이션 시각 (ns)
+uint32_t simGpioLevels(uint32_t mask);                      // GPIO 0~31 레벨을 한 번에 읽기 (GPLEV0, gpio_bulk.h)
+void simGpioWrite(uint32_t mask, int level);               // GPIO 0~31 중 mask 핀을 한 번에 쓰기 (GPSET0/GPCLR0)
+
+// 시계 모드
+//   SIM_CLOCK_REAL   : 실제 시간. delay() 는 실제로 잠든다.
+//   SIM_CLOCK_VIRTUAL: 결정적인 가상 시간. delay() 는 즉시 시간을 앞으로 보내고,
+//                      보드 함수 호출마다 opCost 만큼 시간이 흐른다.
+//                      같은 핀을 연속으로 읽는 대기 루프는 장치의 다음 변화 시각으로 건너뛴다.
+#define SIM_CLOCK_REAL    0
+#define SIM_CLOCK_VIRTUAL 1
+void simClockMode(int mode);                               // wiringPiSetupGpio 전에 호출
+int simClockIsVirtual(void);
+void simSetOpCost(unsigned int ns);
+void simSetIdleSkip(int on);
+uint64_t simWallNs(void);                                  // 보드 시작 후 실제 경과 시간
+uint64_t simCpuNs(void);                                   // 프로세스 CPU 사용 시간
+
+// 실행 환경 잡음 (가상 시계)
+// 초당 평균 perSecond 번, us 만큼 프로그램이 멈춘다 (다른 프로세스에 선점됨).
+void simSetPreemption(unsigned int perSecond, unsigned int us);
+// 같은 핀을 기다리는 루프가 limitMs 안에 끝날 수 없으면 handler(pin) 호출.
+// handler 가 NULL 이면 통계를 출력하고 종료한다. limitMs 가 0 이면 검사하지 않는다 (기본 10000).
+void simSetStallHandler(unsigned int limitMs, void (*handler)(int pin));
+
+// 결정적 난수 (신호 발생기에서 사용)
+void simSeed(uint64_t seed);
+uint64_t simRandom(void);
+double simRandomUnit(void);                                // [0, 1)
+double simRandomGauss(void);                               // 평균 0, 표준편차 1
+double simRandomHash(uint64_t x);                          // x 로 정해지는 [0, 1) 값 (난수 상태를 바꾸지 않음)
+
+// 키패드: keys[row][col] 배치와 행/열 핀 지정
+void simKeypadAttach(const int rowPins[4], const int colPins[4], const char keys[4][4]);
+// 키 입력 스크립트
+//   일반 문자: 해당 키를 한 번 누름      예) "1D7E"
+//   (HE:1600): 여러 키를 동시에 1600ms 동안 누름
+//   ~3000    : 3000ms 동안 아무 키도 누르지 않음
+//   공백은 무시
+int simKeypadScript(const char* script);
+void simKeypadTiming(int holdMs, int gapMs);  // 한 번 누름 유지 시간, 키 사이 간격
+int simKeypadPending(void);                   // 아직 처리되지 않은 스크립트 항목 수
+void simKeypadBounce(int bounceUs);           // 누르고 뗀 직후 접점이 떨리는 시간 (0: 떨림 없음)
+
+void simDht11Attach(int pin);
+void simDht11Set(int humidity, int humidityDec, int temp, int tempDec);
+void simPcf8591Set(int channel, int value);
+void simDht11Jitter(int jitterUs);             // 응답 파형 각 구간 길이를 +-jitterUs 흔듦
+void simMcp3208Set(int channel, int value);
+void simMcp3208Noise(int channel, double sigma, unsigned int spikePerMillion);  // 가우스 잡음과 튀는 값
+void simCardScript(const char* results);
+const char* simLcdText(int fd, int row);      // LCD 버퍼의 한 줄
+const unsigned char* simLcdGlyph(int fd, int index);  // 사용자 문자 index (0~7, 8~15 도 같은 글자) 의 8줄 (CGRAM)
+// GPIO 로 직접 구동하는 HD44780 (busy flag, 명령 처리 시간 포함). rw < 0 이면 GND 고정.
+// 같은 E 핀으로 다시 부르면 설정만 바꾼다. simLcdText 에 쓸 번호를 돌려준다.
+int simHd44780Attach(int rows, int cols, int rs, int rw, int e, int d4, int d5, int d6, int d7);
+int simRfidRead(void);                        // 1: 카드 인식 성공, 0: 실패
+
+void simSetIdleExit(int ms);                  // 0 이면 자동 종료하지 않음
+void simReport(void);                         // 실행 통계 출력 (stderr)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
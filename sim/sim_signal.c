@@ -0,0 +1,233 @@
+// 신호 발생기 구현 (sim_signal.h 참고)
+#include <stddef.h>
+#include "sim_signal.h"
+
+#define NS_PER_US 1000ULL
+#define NS_PER_MS 1000000ULL
+
+#define BOUNCE_SLOT_NS (50 * NS_PER_US)  // 떨리는 동안 접점 상태가 바뀔 수 있는 간격
+
+//1. 버튼 접점
+// 접점이 닫혀 있는지. 떨림 구간에서는 시간이 지날수록 안정된 상태에 가까워진다.
+static int buttonClosed(const SimButton* b, uint64_t now) {
+    uint64_t bounceNs = (uint64_t)b->bounceUs * NS_PER_US;
+    if (b->downNs == b->upNs || now < b->downNs) return 0;
+    if (now < b->upNs) {
+        if (now - b->downNs >= bounceNs) return 1;
+        uint64_t t = now - b->downNs;
+        return simRandomHash(b->seed ^ (t / BOUNCE_SLOT_NS)) < (double)t / bounceNs;
+    }
+    if (now - b->upNs >= bounceNs) return 0;
+    uint64_t t = now - b->upNs;
+    return simRandomHash(~b->seed ^ (t / BOUNCE_SLOT_NS)) >= (double)t / bounceNs;
+}
+
+static int buttonRead(void* ctx, int pin, uint64_t nowNs) {
+    (void)pin;
+    SimButton* b = ctx;
+    return buttonClosed(b, nowNs) ? b->activeLevel : !b->activeLevel;
+}
+
+static uint64_t buttonNext(void* ctx, int pin, uint64_t nowNs) {
+    (void)pin;
+    SimButton* b = ctx;
+    uint64_t bounceNs = (uint64_t)b->bounceUs * NS_PER_US;
+    if (b->downNs == b->upNs) return UINT64_MAX;
+    if (nowNs < b->downNs) return b->downNs;
+    uint64_t edges[2] = { b->downNs, b->upNs };
+    for (int i = 0; i < 2; i++) {
+        if (nowNs >= edges[i] && nowNs - edges[i] < bounceNs) {
+            return edges[i] + ((nowNs - edges[i]) / BOUNCE_SLOT_NS + 1) * BOUNCE_SLOT_NS;
+        }
+    }
+    if (nowNs < b->upNs) return b->upNs;
+    return UINT64_MAX;
+}
+
+static const SimPinOps buttonOps = { buttonRead, NULL, NULL, buttonNext };
+
+void simButtonAttach(SimButton* b, int pin, int activeLevel, int bounceUs) {
+    b->pin = pin;
+    b->activeLevel = activeLevel;
+    b->bounceUs = bounceUs;
+    b->downNs = b->upNs = 0;
+    b->seed = simRandom();
+    simAttach(pin, &buttonOps, b);
+}
+
+void simButtonPress(SimButton* b, uint64_t atNs, unsigned int holdMs) {
+    b->downNs = atNs;
+    b->upNs = atNs + (uint64_t)holdMs * NS_PER_MS;
+    b->seed = simRandom();
+}
+
+
+//2. HC-SR04 초음파 센서
+#define HCSR04_BURST_US   460    // TRIG 후 초음파 8주기 송신이 끝나고 ECHO 가 오르기까지
+#define HCSR04_TIMEOUT_US 38000  // 반사파가 없을 때의 ECHO 펄스 길이
+#define US_PER_CM_ROUND   58.3   // 왕복 1cm 에 걸리는 시간 (343m/s)
+
+static int hcsr04Read(void* ctx, int pin, uint64_t nowNs) {
+    (void)pin;
+    SimHcsr04* s = ctx;
+    return (nowNs >= s->echoStartNs && nowNs < s->echoEndNs) ? HIGH : LOW;
+}
+
+static void hcsr04Write(void* ctx, int pin, int value, uint64_t nowNs) {
+    SimHcsr04* s = ctx;
+    if (pin != s->trigPin) return;
+    if (value == HIGH) {
+        s->trigHigh = 1;
+        s->trigHighNs = nowNs;
+        return;
+    }
+    if (!s->trigHigh) return;
+    s->trigHigh = 0;
+    if (nowNs - s->trigHighNs < 10 * NS_PER_US) return;  // 트리거 펄스가 짧으면 무시
+
+    s->triggers++;
+    s->echoStartNs = nowNs + HCSR04_BURST_US * NS_PER_US;
+    if (s->lossPerMillion > 0 && simRandom() % 1000000 < (uint64_t)s->lossPerMillion) {
+        s->lost++;
+        if (s->lossMode == SIM_ECHO_STUCK) {
+            s->echoStartNs = s->echoEndNs = 0;
+        } else {
+            s->echoEndNs = s->echoStartNs + HCSR04_TIMEOUT_US * NS_PER_US;
+        }
+        return;
+    }
+    double us = s->distanceCm * US_PER_CM_ROUND;
+    if (s->jitterUs > 0) {
+        us += (double)((int)(simRandom() % (uint64_t)(2 * s->jitterUs + 1)) - s->jitterUs);
+    }
+    if (us < 1) us = 1;
+    s->echoEndNs = s->echoStartNs + (uint64_t)(us * NS_PER_US);
+}
+
+static uint64_t hcsr04Next(void* ctx, int pin, uint64_t nowNs) {
+    (void)pin;
+    SimHcsr04* s = ctx;
+    if (s->echoStartNs == s->echoEndNs) return UINT64_MAX;
+    if (nowNs < s->echoStartNs) return s->echoStartNs;
+    if (nowNs < s->echoEndNs) return s->echoEndNs;
+    return UINT64_MAX;
+}
+
+static const SimPinOps hcsr04Ops = { hcsr04Read, hcsr04Write, NULL, hcsr04Next };
+
+void simHcsr04Attach(SimHcsr04* s, int trigPin, int echoPin) {
+    s->trigPin = trigPin;
+    s->echoPin = echoPin;
+    s->trigHigh = 0;
+    s->echoStartNs = s->echoEndNs = 0;
+    s->triggers = s->lost = 0;
+    if (s->distanceCm <= 0) s->distanceCm = 100;
+    simAttach(trigPin, &hcsr04Ops, s);
+    simAttach(echoPin, &hcsr04Ops, s);
+}
+
+void simHcsr04Set(SimHcsr04* s, double distanceCm, int jitterUs, int lossPerMillion, int lossMode) {
+    s->distanceCm = distanceCm;
+    s->jitterUs = jitterUs;
+    s->lossPerMillion = lossPerMillion;
+    s->lossMode = lossMode;
+}
+
+
+//3. 다중화 FND
+// 실습 코드의 FndNumberTable 두 가지 (fnd.c, fnd2.c: 7 의 f, 9 의 d 세그먼트가 다르다)
+static const unsigned char fndFont[] = {
+    0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07, 0x7F, 0x6F,  // 0~9
+    0x77, 0x7C, 0x39, 0x5E, 0x79, 0x71,                          // A~F
+    0x27, 0x67, 0x40                                             // 7, 9, -
+};
+static const char fndChars[] = "0123456789ABCDEF79-";
+
+// 지금 상태가 이어진 구간을 통계에 반영한다
+static void fndCommit(SimFnd* f, uint64_t now) {
+    if (now <= f->sinceNs) return;
+    if (f->pos == -2) {
+        f->ghosts++;
+    } else if (f->pos >= 0) {
+        if (f->pos != f->litPos) {  // 새로 켜진 자리
+            uint64_t gap = f->sinceNs - f->lastOnNs[f->pos];
+            if (f->scans[f->pos] && gap > f->maxGapNs[f->pos]) f->maxGapNs[f->pos] = gap;
+            f->scans[f->pos]++;
+            f->lastOnNs[f->pos] = f->sinceNs;
+            f->litPattern = f->pattern;
+        } else if (f->pattern != f->litPattern) {
+            f->ghosts++;
+            f->litPattern = f->pattern;
+        }
+        f->litNs[f->pos] += now - f->sinceNs;
+        f->shown[f->pos] = (unsigned char)f->pattern;
+    }
+    f->litPos = f->pos;
+    f->sinceNs = now;
+}
+
+static void fndWrite(void* ctx, int pin, int value, uint64_t nowNs) {
+    (void)value;
+    SimFnd* f = ctx;
+    fndCommit(f, nowNs);
+    for (int i = 0; i < SIM_FND_DIGITS; i++) {
+        if (f->sel[i] == pin) f->driven |= 1u << i;
+    }
+    for (int i = 0; i < 8; i++) {
+        if (f->seg[i] == pin) f->driven |= 1u << (8 + i);
+    }
+    f->pos = -1;
+    for (int i = 0; i < SIM_FND_DIGITS; i++) {
+        if ((f->driven & (1u << i)) && simPinLevel(f->sel[i]) == LOW) f->pos = (f->pos == -1) ? i : -2;
+    }
+    f->pattern = 0;
+    for (int i = 0; i < 8; i++) {
+        if ((f->driven & (1u << (8 + i))) && simPinLevel(f->seg[i]) == HIGH) f->pattern |= 1 << i;
+    }
+}
+
+static const SimPinOps fndOps = { NULL, fndWrite, NULL, NULL };
+
+void simFndAttach(SimFnd* f, const int selPins[SIM_FND_DIGITS], const int segPins[8]) {
+    for (int i = 0; i < SIM_FND_DIGITS; i++) f->sel[i] = selPins[i];
+    for (int i = 0; i < 8; i++) f->seg[i] = segPins[i];
+    f->driven = 0;
+    f->pos = f->litPos = -1;
+    f->pattern = f->litPattern = 0;
+    for (int i = 0; i < SIM_FND_DIGITS; i++) f->shown[i] = 0;
+    f->sinceNs = simNowNs();
+    simFndReset(f);
+    for (int i = 0; i < SIM_FND_DIGITS; i++) simAttach(selPins[i], &fndOps, f);
+    for (int i = 0; i < 8; i++) simAttach(segPins[i], &fndOps, f);
+}
+
+void simFndReset(SimFnd* f) {
+    simFndSync(f);
+    for (int i = 0; i < SIM_FND_DIGITS; i++) {
+        f->scans[i] = 0;
+        f->litNs[i] = f->maxGapNs[i] = f->lastOnNs[i] = 0;
+    }
+    f->ghosts = 0;
+    f->litPos = -1;  // 지금 켜진 자리는 새로 켜진 것으로 센다
+}
+
+void simFndSync(SimFnd* f) {
+    fndCommit(f, simNowNs());
+}
+
+const char* simFndText(SimFnd* f, char* out) {
+    simFndSync(f);
+    char* p = out;
+    for (int i = 0; i < SIM_FND_DIGITS; i++) {
+        int seg = f->shown[i] & 0x7F;
+        char ch = '?';
+        if (seg == 0) ch = ' ';
+        for (size_t k = 0; k < sizeof(fndFont) && ch == '?'; k++) {
+            if (fndFont[k] == seg) ch = fndChars[k];
+        }
+        *p++ = ch;
+        if (f->shown[i] & 0x80) *p++ = '.';
+    }
+    *p = '\0';
+    return out;
+}
@@ -0,0 +1,81 @@
+// 신호 발생기: 잡음이 있는 실제 주변장치 파형을 만드는 가상 장치
+// sim_board.h 의 SimPinOps 로 핀에 연결된다. 장치 상태는 호출한 쪽이 가진 구조체에 둔다.
+//
+//   - 떨림이 있는 버튼 접점 (SimButton)
+//   - HC-SR04 초음파 센서 (SimHcsr04): 에코 길이 흔들림, 에코 유실
+//   - 다중화 FND (SimFnd): 자리마다 켜진 시간, 갱신 간격, 잔상
+//
+// 키패드 접점 떨림, DHT11 파형 흔들림, MCP3208 잡음은 sim_board 의 각 장치 모델에서 설정한다
+// (simKeypadBounce, simDht11Jitter, simMcp3208Noise).
+
+#ifndef SIM_SIGNAL_H
+#define SIM_SIGNAL_H
+
+#include "sim_board.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 버튼: 누르면 activeLevel, 떼면 반대 레벨. 누르고 뗀 직후 bounceUs 동안 떨린다.
+typedef struct {
+    int pin;
+    int activeLevel;
+    int bounceUs;
+    uint64_t downNs, upNs;   // 누른 시각, 뗀 시각 (downNs == upNs 이면 누른 적 없음)
+    uint64_t seed;
+} SimButton;
+
+void simButtonAttach(SimButton* b, int pin, int activeLevel, int bounceUs);
+void simButtonPress(SimButton* b, uint64_t atNs, unsigned int holdMs);
+
+// HC-SR04: TRIG 에 10us 이상 HIGH 펄스가 들어오면 약 460us 뒤 ECHO 를 거리에 비례한 시간 동안 HIGH 로 둔다.
+#define SIM_ECHO_TIMEOUT 0   // 에코 유실: 38ms 짜리 최대 길이 펄스 (일반적인 모듈 동작)
+#define SIM_ECHO_STUCK   1   // 에코 유실: ECHO 가 올라오지 않음 (배선 불량, 모듈 멈춤)
+
+typedef struct {
+    int trigPin, echoPin;
+    double distanceCm;
+    int jitterUs;            // 에코 길이 흔들림 (+-)
+    int lossPerMillion;      // 측정 백만 번당 에코 유실 횟수
+    int lossMode;            // SIM_ECHO_TIMEOUT / SIM_ECHO_STUCK
+    uint64_t trigHighNs;
+    int trigHigh;
+    uint64_t echoStartNs, echoEndNs;  // echoStartNs == echoEndNs 이면 에코 없음
+    unsigned long triggers, lost;
+} SimHcsr04;
+
+void simHcsr04Attach(SimHcsr04* s, int trigPin, int echoPin);
+void simHcsr04Set(SimHcsr04* s, double distanceCm, int jitterUs, int lossPerMillion, int lossMode);
+
+// 다중화 FND: 선택 핀이 LOW 인 자리에 세그먼트 핀(a~g, dp, HIGH 가 켜짐)의 패턴이 보인다.
+// 핀 쓰기를 지켜보기만 하고 레벨은 바꾸지 않는다. 한 번도 쓰지 않은 핀은 구동되지 않은 것으로 본다.
+// 잔상: 한 자리가 켜진 동안 패턴이 바뀌었거나 두 자리 이상이 동시에 켜진 구간
+#define SIM_FND_DIGITS 6
+
+typedef struct {
+    int sel[SIM_FND_DIGITS], seg[8];
+    unsigned int driven;                      // 한 번이라도 쓴 핀 (bit 0~5: 선택, 8~15: 세그먼트)
+    int pos, pattern;                         // 지금 켜진 자리 (-1: 없음, -2: 여러 자리), 세그먼트 패턴
+    int litPos, litPattern;                   // 마지막으로 보인 구간의 자리와 처음 패턴
+    uint64_t sinceNs;                         // 지금 상태가 시작된 시각
+    unsigned char shown[SIM_FND_DIGITS];      // 자리마다 마지막으로 보인 패턴
+    unsigned long scans[SIM_FND_DIGITS];      // 자리가 켜진 횟수
+    uint64_t litNs[SIM_FND_DIGITS];           // 자리가 켜져 있던 시간
+    uint64_t lastOnNs[SIM_FND_DIGITS];        // 마지막으로 켜진 시각
+    uint64_t maxGapNs[SIM_FND_DIGITS];        // 켜지는 간격의 최댓값 (깜박임)
+    unsigned long ghosts;
+} SimFnd;
+
+void simFndAttach(SimFnd* f, const int selPins[SIM_FND_DIGITS], const int segPins[8]);
+void simFndReset(SimFnd* f);                 // 통계만 지우기 (지금 상태는 유지)
+void simFndSync(SimFnd* f);                  // 지금 시각까지 통계에 반영
+// 자리마다 마지막으로 보인 패턴을 글자로 (0~9, A~F, -, 공백, 모르는 패턴은 ?, dp 는 '.').
+// out 은 SIM_FND_DIGITS * 2 + 1 바이트 이상
+const char* simFndText(SimFnd* f, char* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif